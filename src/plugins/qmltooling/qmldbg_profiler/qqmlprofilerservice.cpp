@@ -412,6 +412,9 @@ void QQmlProfilerServiceImpl::messageReceived(const QByteArray &message)
     quint64 features = std::numeric_limits<quint64>::max();
     bool enabled;
     uint flushInterval = 0;
+    bool hasFlushInterval = false;
+    bool useMessageTypes = m_useMessageTypes;
+    bool heapSnapshot = false;
     stream >> enabled;
     if (!stream.atEnd())
         stream >> engineId;
@@ -419,6 +422,20 @@ void QQmlProfilerServiceImpl::messageReceived(const QByteArray &message)
         stream >> features;
     if (!stream.atEnd()) {
         stream >> flushInterval;
+        hasFlushInterval = true;
+    }
+    if (!stream.atEnd())
+        stream >> useMessageTypes;
+    if (!stream.atEnd())
+        stream >> heapSnapshot;
+
+    // A request for a heap snapshot leaves the recording as it is
+    if (heapSnapshot) {
+        takeHeapSnapshot(qobject_cast<QJSEngine *>(objectForId(engineId)));
+        return;
+    }
+
+    if (hasFlushInterval) {
         m_flushTimer.setInterval(flushInterval);
         auto timerStart = static_cast<void(QTimer::*)()>(&QTimer::start);
         if (flushInterval > 0) {
@@ -432,8 +449,7 @@ void QQmlProfilerServiceImpl::messageReceived(const QByteArray &message)
                        &m_flushTimer, &QTimer::stop);
         }
     }
-    if (!stream.atEnd())
-        stream >> m_useMessageTypes;
+    m_useMessageTypes = useMessageTypes;
 
     // If engineId == -1 objectForId() and then the cast will return 0.
     if (enabled)
@@ -467,6 +483,18 @@ void QQmlProfilerServiceImpl::flush()
         profiler->reportData(m_useMessageTypes);
 }
 
+// The snapshots are sent with the next data that the engines report
+void QQmlProfilerServiceImpl::takeHeapSnapshot(QJSEngine *engine)
+{
+    for (QMultiHash<QJSEngine *, QQmlAbstractProfilerAdapter *>::const_iterator i(m_engineProfilers.constBegin());
+            i != m_engineProfilers.constEnd(); ++i) {
+        if ((engine == 0 || i.key() == engine) && i.value()->isRunning()) {
+            if (QV4ProfilerAdapter *v4Profiler = qobject_cast<QV4ProfilerAdapter *>(i.value()))
+                v4Profiler->takeHeapSnapshot();
+        }
+    }
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qqmlprofilerservice.cpp"
@@ -110,6 +110,7 @@ private:
     void addEngineProfiler(QQmlAbstractProfilerAdapter *profiler, QJSEngine *engine);
     void removeProfilerFromStartTimes(const QQmlAbstractProfilerAdapter *profiler);
     void flush();
+    void takeHeapSnapshot(QJSEngine *engine);
 
     QElapsedTimer m_timer;
     QTimer m_flushTimer;
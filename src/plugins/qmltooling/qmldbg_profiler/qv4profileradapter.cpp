@@ -43,7 +43,7 @@
 QT_BEGIN_NAMESPACE
 
 QV4ProfilerAdapter::QV4ProfilerAdapter(QQmlProfilerService *service, QV4::ExecutionEngine *engine) :
-    m_functionCallPos(0), m_memoryPos(0)
+    m_functionCallPos(0), m_memoryPos(0), m_garbageCollectionPos(0)
 {
     setService(service);
     engine->setProfiler(new QV4::Profiling::Profiler(engine));
@@ -62,6 +62,8 @@ QV4ProfilerAdapter::QV4ProfilerAdapter(QQmlProfilerService *service, QV4::Execut
             Qt::DirectConnection);
     connect(this, &QQmlAbstractProfilerAdapter::dataRequested,
             engine->profiler(), &QV4::Profiling::Profiler::reportData);
+    connect(this, &QV4ProfilerAdapter::v4HeapSnapshotRequested,
+            engine->profiler(), &QV4::Profiling::Profiler::takeHeapSnapshot);
     connect(this, &QQmlAbstractProfilerAdapter::referenceTimeKnown,
             engine->profiler(), &QV4::Profiling::Profiler::setTimer);
     connect(engine->profiler(), &QV4::Profiling::Profiler::dataReady,
@@ -84,6 +86,31 @@ qint64 QV4ProfilerAdapter::appendMemoryEvents(qint64 until, QList<QByteArray> &m
     return memoryData.length() == m_memoryPos ? -1 : memoryData[m_memoryPos].timestamp;
 }
 
+qint64 QV4ProfilerAdapter::appendGarbageCollectionEvents(qint64 until,
+                                                         QList<QByteArray> &messages,
+                                                         QQmlDebugPacket &d)
+{
+    // Make it const, so that we cannot accidentally detach it.
+    const QVector<QV4::Profiling::GarbageCollectionProperties> &gcData = m_garbageCollectionData;
+
+    while (gcData.length() > m_garbageCollectionPos
+           && gcData[m_garbageCollectionPos].timestamp <= until) {
+        const QV4::Profiling::GarbageCollectionProperties &props = gcData[m_garbageCollectionPos];
+        d << props.timestamp << int(GarbageCollection) << int(props.type);
+        if (props.type == QV4::Profiling::HeapSnapshotObjects) {
+            d << props.objectType << props.numericData[0] << props.numericData[1];
+        } else {
+            for (qint64 data : props.numericData)
+                d << data;
+        }
+        ++m_garbageCollectionPos;
+        messages.append(d.squeezedData());
+        d.clear();
+    }
+    return gcData.length() == m_garbageCollectionPos
+            ? -1 : gcData[m_garbageCollectionPos].timestamp;
+}
+
 qint64 QV4ProfilerAdapter::finalizeMessages(qint64 until, QList<QByteArray> &messages,
                                             qint64 callNext, QQmlDebugPacket &d)
 {
@@ -93,15 +120,26 @@ qint64 QV4ProfilerAdapter::finalizeMessages(qint64 until, QList<QByteArray> &mes
         m_functionCallPos = 0;
     }
 
+    qint64 next = callNext;
     qint64 memoryNext = appendMemoryEvents(until, messages, d);
 
     if (memoryNext == -1) {
         m_memoryData.clear();
         m_memoryPos = 0;
-        return callNext;
+    } else {
+        next = (next == -1) ? memoryNext : qMin(next, memoryNext);
     }
 
-    return callNext == -1 ? memoryNext : qMin(callNext, memoryNext);
+    qint64 gcNext = appendGarbageCollectionEvents(until, messages, d);
+
+    if (gcNext == -1) {
+        m_garbageCollectionData.clear();
+        m_garbageCollectionPos = 0;
+    } else {
+        next = (next == -1) ? gcNext : qMin(next, gcNext);
+    }
+
+    return next;
 }
 
 qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &messages,
@@ -120,6 +158,7 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
                 return finalizeMessages(until, messages, m_stack.top(), d);
 
             appendMemoryEvents(m_stack.top(), messages, d);
+            appendGarbageCollectionEvents(m_stack.top(), messages, d);
             d << m_stack.pop() << int(RangeEnd) << int(Javascript);
             messages.append(d.squeezedData());
             d.clear();
@@ -132,6 +171,7 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
                 return finalizeMessages(until, messages, props.start, d);
 
             appendMemoryEvents(props.start, messages, d);
+            appendGarbageCollectionEvents(props.start, messages, d);
             auto location = m_functionLocations.find(props.id);
 
             d << props.start << int(RangeStart) << int(Javascript);
@@ -166,7 +206,8 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
 void QV4ProfilerAdapter::receiveData(
         const QV4::Profiling::FunctionLocationHash &locations,
         const QVector<QV4::Profiling::FunctionCallProperties> &functionCallData,
-        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData)
+        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData,
+        const QVector<QV4::Profiling::GarbageCollectionProperties> &gcData)
 {
     // In rare cases it could be that another flush or stop event is processed while data from
     // the previous one is still pending. In that case we just append the data.
@@ -185,6 +226,11 @@ void QV4ProfilerAdapter::receiveData(
     else
         m_memoryData.append(memoryData);
 
+    if (m_garbageCollectionData.isEmpty())
+        m_garbageCollectionData = gcData;
+    else
+        m_garbageCollectionData.append(gcData);
+
     service->dataReady(this);
 }
 
@@ -196,6 +242,8 @@ quint64 QV4ProfilerAdapter::translateFeatures(quint64 qmlFeatures)
         v4Features |= (one << QV4::Profiling::FeatureFunctionCall);
     if (qmlFeatures & (one << ProfileMemory))
         v4Features |= (one << QV4::Profiling::FeatureMemoryAllocation);
+    if (qmlFeatures & (one << ProfileGarbageCollection))
+        v4Features |= (one << QV4::Profiling::FeatureGarbageCollection);
     return v4Features;
 }
 
@@ -72,20 +72,28 @@ public:
 
     void receiveData(const QV4::Profiling::FunctionLocationHash &,
                      const QVector<QV4::Profiling::FunctionCallProperties> &,
-                     const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                     const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                     const QVector<QV4::Profiling::GarbageCollectionProperties> &);
+
+    void takeHeapSnapshot() { emit v4HeapSnapshotRequested(); }
 
 signals:
     void v4ProfilingEnabled(quint64 v4Features);
     void v4ProfilingEnabledWhileWaiting(quint64 v4Features);
+    void v4HeapSnapshotRequested();
 
 private:
     QV4::Profiling::FunctionLocationHash m_functionLocations;
     QVector<QV4::Profiling::FunctionCallProperties> m_functionCallData;
     QVector<QV4::Profiling::MemoryAllocationProperties> m_memoryData;
+    QVector<QV4::Profiling::GarbageCollectionProperties> m_garbageCollectionData;
     int m_functionCallPos;
     int m_memoryPos;
+    int m_garbageCollectionPos;
     QStack<qint64> m_stack;
     qint64 appendMemoryEvents(qint64 until, QList<QByteArray> &messages, QQmlDebugPacket &d);
+    qint64 appendGarbageCollectionEvents(qint64 until, QList<QByteArray> &messages,
+                                         QQmlDebugPacket &d);
     qint64 finalizeMessages(qint64 until, QList<QByteArray> &messages, qint64 callNext,
                             QQmlDebugPacket &d);
     void forwardEnabled(quint64 features);
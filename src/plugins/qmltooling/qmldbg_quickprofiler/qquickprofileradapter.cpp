@@ -138,6 +138,15 @@ static void qQuickProfilerDataToByteArrays(const QQuickProfilerData &data,
                     default:break;
                 }
                 break;
+            case QQuickProfiler::ItemViewFrame:
+                switch (decodedDetailType) {
+                    // DelegateCounts: created, incubated, released, destroyed, reused
+                    case QQuickProfiler::ItemViewDelegateCounts: ds << data.subtime_1 << data.subtime_2 << data.subtime_3 << data.subtime_4 << data.subtime_5; break;
+                    // DelegateTimes: createTime, releaseTime
+                    case QQuickProfiler::ItemViewDelegateTimes: ds << data.subtime_1 << data.subtime_2; break;
+                    default:break;
+                }
+                break;
             default:
                 Q_ASSERT_X(false, Q_FUNC_INFO, "Invalid message type.");
                 break;
@@ -228,6 +228,10 @@ void CompilationUnit::unlink()
     engine = 0;
     free(runtimeStrings);
     runtimeStrings = 0;
+    if (runtimeLookups) {
+        for (uint i = 0; i < data->lookupTableSize; ++i)
+            runtimeLookups[i].releasePolymorphicCache();
+    }
     delete [] runtimeLookups;
     runtimeLookups = 0;
     delete [] runtimeRegularExpressions;
@@ -69,6 +69,8 @@ struct QQmlProfilerDefinitions {
         PixmapCacheEvent,
         SceneGraphFrame,
         MemoryAllocation,
+        ItemViewFrame,
+        GarbageCollection,
 
         MaximumMessage
     };
@@ -128,7 +130,15 @@ struct QQmlProfilerDefinitions {
         NumGUIThreadFrameTypes = MaximumSceneGraphFrameType - NumRenderThreadFrameTypes
     };
 
+    enum ItemViewFrameType {
+        ItemViewDelegateCounts, // created, incubated, released, destroyed, reused
+        ItemViewDelegateTimes,  // time spent creating and releasing delegate items
+
+        MaximumItemViewFrameType
+    };
+
     typedef QV4::Profiling::MemoryType MemoryType;
+    typedef QV4::Profiling::GarbageCollectionType GarbageCollectionType;
 
     enum ProfileFeature {
         ProfileJavaScript,
@@ -143,6 +153,8 @@ struct QQmlProfilerDefinitions {
         ProfileHandlingSignal,
         ProfileInputEvents,
         ProfileDebugMessages,
+        ProfileItemViews,
+        ProfileGarbageCollection,
 
         MaximumProfileFeature
     };
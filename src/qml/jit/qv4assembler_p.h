@@ -159,10 +159,13 @@ struct RegisterSizeDependentAssembler<JITAssembler, MacroAssembler, TargetPlatfo
     static void emitSetGrayBit(JITAssembler *as, RegisterID base)
     {
         bool returnValueUsed = (base == TargetPlatform::ReturnValueRegister);
+        RegisterID grayBitmap = returnValueUsed ? TargetPlatform::ScratchRegister : TargetPlatform::ReturnValueRegister;
 
+        // The code after the store might still need the registers used here
+        as->push(base);
+        as->push(grayBitmap);
         as->push(TargetPlatform::EngineRegister); // free up one register for work
 
-        RegisterID grayBitmap = returnValueUsed ? TargetPlatform::ScratchRegister : TargetPlatform::ReturnValueRegister;
         as->move(base, grayBitmap);
         Q_ASSERT(base != grayBitmap);
         as->urshift32(TrustedImm32(Chunk::ChunkShift), grayBitmap);
@@ -189,7 +192,22 @@ struct RegisterSizeDependentAssembler<JITAssembler, MacroAssembler, TargetPlatfo
         as->store32(index, Pointer(grayBitmap, 0));
 
         as->pop(TargetPlatform::EngineRegister);
+        as->pop(grayBitmap);
+        as->pop(base);
+    }
+
+#if WRITEBARRIER(steele)
+    static void emitWriteBarrier(JITAssembler *as, Address addr)
+    {
+        // writeBarrierActive is a byte next to hasException, which is pointer aligned
+        const qint32 writeBarrierActiveOffset = JITAssembler::targetStructureOffset(offsetof(EngineBase, hasException))
+                + qint32(offsetof(EngineBase, writeBarrierActive) - offsetof(EngineBase, hasException));
+        Jump inactive = as->branchTest8(ResultCondition::Zero, Address(TargetPlatform::EngineRegister, writeBarrierActiveOffset));
+        // The base of the address points to the object that is written to, see loadArgLocalAddressForWriting()
+        emitSetGrayBit(as, addr.base);
+        inactive.link(as);
     }
+#endif
 
 #if WRITEBARRIER(none)
     static Q_ALWAYS_INLINE void emitWriteBarrier(JITAssembler *, Address) {}
@@ -455,10 +473,13 @@ struct RegisterSizeDependentAssembler<JITAssembler, MacroAssembler, TargetPlatfo
     static void emitSetGrayBit(JITAssembler *as, RegisterID base)
     {
         bool returnValueUsed = (base == TargetPlatform::ReturnValueRegister);
+        RegisterID grayBitmap = returnValueUsed ? TargetPlatform::ScratchRegister : TargetPlatform::ReturnValueRegister;
 
+        // The code after the store might still need the registers used here
+        as->push(base);
+        as->push(grayBitmap);
         as->push(TargetPlatform::EngineRegister); // free up one register for work
 
-        RegisterID grayBitmap = returnValueUsed ? TargetPlatform::ScratchRegister : TargetPlatform::ReturnValueRegister;
         as->move(base, grayBitmap);
         Q_ASSERT(base != grayBitmap);
         as->urshift64(TrustedImm32(Chunk::ChunkShift), grayBitmap);
@@ -485,7 +506,22 @@ struct RegisterSizeDependentAssembler<JITAssembler, MacroAssembler, TargetPlatfo
         as->store64(index, Pointer(grayBitmap, 0));
 
         as->pop(TargetPlatform::EngineRegister);
+        as->pop(grayBitmap);
+        as->pop(base);
+    }
+
+#if WRITEBARRIER(steele)
+    static void emitWriteBarrier(JITAssembler *as, Address addr)
+    {
+        // writeBarrierActive is a byte next to hasException, which is pointer aligned
+        const qint32 writeBarrierActiveOffset = JITAssembler::targetStructureOffset(offsetof(EngineBase, hasException))
+                + qint32(offsetof(EngineBase, writeBarrierActive) - offsetof(EngineBase, hasException));
+        Jump inactive = as->branchTest8(ResultCondition::Zero, Address(TargetPlatform::EngineRegister, writeBarrierActiveOffset));
+        // The base of the address points to the object that is written to, see loadArgLocalAddressForWriting()
+        emitSetGrayBit(as, addr.base);
+        inactive.link(as);
     }
+#endif
 
 #if WRITEBARRIER(none)
     static Q_ALWAYS_INLINE void emitWriteBarrier(JITAssembler *, Address) {}
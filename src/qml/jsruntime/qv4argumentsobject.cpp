@@ -176,7 +176,8 @@ bool ArgumentsObject::putIndexed(Managed *m, uint index, const Value &value)
     if (args->fullyCreated())
         return Object::putIndexed(m, index, value);
 
-    args->context()->callData->args[index] = value;
+    Heap::CallContext *context = args->context();
+    WriteBarrier::write(args->engine(), context, context->callData->args + index, value);
     return true;
 }
 
@@ -232,7 +233,9 @@ void ArgumentsSetterFunction::call(const Managed *setter, Scope &scope, CallData
     }
 
     Q_ASSERT(s->index() < static_cast<unsigned>(o->context()->callData->argc));
-    o->context()->callData->args[s->index()] = callData->argc ? callData->args[0].asReturnedValue() : Encode::undefined();
+    Heap::CallContext *context = o->context();
+    WriteBarrier::write(v4, context, context->callData->args + s->index(),
+                        callData->argc ? callData->args[0] : Primitive::undefinedValue());
     scope.result = Encode::undefined();
 }
 
@@ -345,7 +345,8 @@ void ExecutionContext::setProperty(String *name, const Value &value)
                 uint index = c->v4Function->internalClass->find(id);
                 if (index < UINT_MAX) {
                     if (index < c->v4Function->nFormals) {
-                        c->callData->args[c->v4Function->nFormals - index - 1] = value;
+                        // The arguments of a CallContext live inside the context itself
+                        WriteBarrier::write(scope.engine, c, c->callData->args + c->v4Function->nFormals - index - 1, value);
                     } else {
                         Q_ASSERT(c->type == Heap::ExecutionContext::Type_CallContext);
                         index -= c->v4Function->nFormals;
@@ -54,6 +54,7 @@
 #include <qv4regexp_p.h>
 #include <qv4variantobject_p.h>
 #include <qv4runtime_p.h>
+#include <qv4lookup_p.h>
 #include <private/qv4mm_p.h>
 #include <qv4argumentsobject_p.h>
 #include <qv4dateobject_p.h>
@@ -79,6 +80,7 @@
 #include <private/qqmllocale_p.h>
 
 #include <QtCore/QTextStream>
+#include <QtCore/QDebug>
 #include <QDateTime>
 
 #ifdef V4_ENABLE_JIT
@@ -141,6 +143,7 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     , nArgumentsAccessors(0)
     , m_engineId(engineSerial.fetchAndAddOrdered(1))
     , regExpCache(0)
+    , megamorphicLookupCache(0)
     , m_multiplyWrappedQObjects(0)
 #ifndef QT_NO_QML_DEBUGGER
     , m_debugger(0)
@@ -501,6 +504,16 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
 
 ExecutionEngine::~ExecutionEngine()
 {
+    if (!qEnvironmentVariableIsEmpty(QV4_LOOKUP_STATS)) {
+        const LookupStatistics stats = Lookup::statistics(this);
+        qDebug() << "========== Lookups ==========";
+        qDebug() << "   " << stats.uninitialized << "sites never resolved";
+        qDebug() << "   " << stats.monomorphic << "monomorphic sites";
+        qDebug() << "   " << stats.polymorphic << "polymorphic sites";
+        qDebug() << "   " << stats.megamorphic << "megamorphic sites";
+        qDebug() << "   " << stats.fallback << "sites using the generic fallback";
+    }
+
 #ifndef QT_NO_QML_DEBUGGER
     delete m_debugger;
     m_debugger = 0;
@@ -521,6 +534,7 @@ ExecutionEngine::~ExecutionEngine()
     delete classPool;
     delete bumperPointerAllocator;
     delete regExpCache;
+    delete megamorphicLookupCache;
     delete regExpAllocator;
     delete executableAllocator;
     jsStack->deallocate();
@@ -319,6 +319,7 @@ public:
     quint32 m_engineId;
 
     RegExpCache *regExpCache;
+    MegamorphicLookupCache *megamorphicLookupCache;
 
     // Scarce resources are "exceptionally high cost" QVariant types where allowing the
     // normal JavaScript GC to clean them up is likely to lead to out-of-memory or other
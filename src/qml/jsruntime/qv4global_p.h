@@ -196,6 +196,7 @@ struct Value;
 template<size_t> struct HeapValue;
 template<size_t> struct ValueArray;
 struct Lookup;
+struct MegamorphicLookupCache;
 struct ArrayData;
 struct VTable;
 struct Function;
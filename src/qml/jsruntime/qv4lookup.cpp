@@ -116,6 +116,62 @@ ReturnedValue Lookup::lookup(const Object *thisObject, PropertyAttributes *attrs
     return Primitive::emptyValue().asReturnedValue();
 }
 
+Lookup::State Lookup::state() const
+{
+    if (getter == getterGeneric || setter == setterGeneric || globalGetter == globalGetterGeneric
+            || indexedGetter == indexedGetterGeneric || indexedSetter == indexedSetterGeneric)
+        return Uninitialized;
+    if (getter == getterFallback || setter == setterFallback
+            || indexedGetter == indexedGetterFallback || indexedSetter == indexedSetterFallback)
+        return Fallback;
+    if (getter == getterMegamorphic || setter == setterMegamorphic || globalGetter == globalGetterMegamorphic)
+        return Megamorphic;
+    if (getter == getterPolymorphic || setter == setterPolymorphic || globalGetter == globalGetterPolymorphic
+            || getter == getter0Inlinegetter0Inline || getter == getter0Inlinegetter0MemberData
+            || getter == getter0MemberDatagetter0MemberData || getter == getter0Inlinegetter1
+            || getter == getter0MemberDatagetter1 || getter == getter1getter1
+            || setter == setter0setter0)
+        return Polymorphic;
+    return Monomorphic;
+}
+
+void Lookup::releasePolymorphicCache()
+{
+    if (getter == getterPolymorphic || setter == setterPolymorphic || globalGetter == globalGetterPolymorphic) {
+        delete polymorphicCache;
+        polymorphicCache = 0;
+    }
+}
+
+LookupStatistics Lookup::statistics(const ExecutionEngine *engine)
+{
+    LookupStatistics stats;
+    for (const CompiledData::CompilationUnit *unit : engine->compilationUnits) {
+        if (!unit->runtimeLookups)
+            continue;
+        for (uint i = 0; i < unit->data->lookupTableSize; ++i) {
+            switch (unit->runtimeLookups[i].state()) {
+            case Uninitialized:
+                ++stats.uninitialized;
+                break;
+            case Monomorphic:
+                ++stats.monomorphic;
+                break;
+            case Polymorphic:
+                ++stats.polymorphic;
+                break;
+            case Megamorphic:
+                ++stats.megamorphic;
+                break;
+            case Fallback:
+                ++stats.fallback;
+                break;
+            }
+        }
+    }
+    return stats;
+}
+
 ReturnedValue Lookup::indexedGetterGeneric(Lookup *l, ExecutionEngine *engine, const Value &object, const Value &index)
 {
     uint idx;
@@ -250,6 +306,133 @@ void Lookup::indexedSetterObjectInt(Lookup *l, ExecutionEngine *engine, const Va
     indexedSetterFallback(l, engine, object, index, v);
 }
 
+static inline Lookup shapeLookup(uint nameIndex)
+{
+    Lookup shape;
+    memset(&shape, 0, sizeof(Lookup));
+    shape.getter = Lookup::getterFallback;
+    shape.level = -1;
+    shape.index = UINT_MAX;
+    shape.nameIndex = nameIndex;
+    return shape;
+}
+
+static inline Identifier *lookupName(const Lookup *l, ExecutionEngine *engine)
+{
+    return engine->current->compilationUnit->runtimeStrings[l->nameIndex]->identifier;
+}
+
+static bool getterCacheEntry(const Lookup &shape, PolymorphicLookupCache::Entry *e)
+{
+    // getter and globalGetter share their storage, so this works for both kinds of lookups
+    if (shape.getter == Lookup::getter0Inline || shape.globalGetter == Lookup::globalGetter0Inline)
+        e->kind = PolymorphicLookupCache::Inline;
+    else if (shape.getter == Lookup::getter0MemberData || shape.globalGetter == Lookup::globalGetter0MemberData)
+        e->kind = PolymorphicLookupCache::MemberData;
+    else if (shape.getter == Lookup::getter1 || shape.globalGetter == Lookup::globalGetter1)
+        e->kind = PolymorphicLookupCache::Prototype;
+    else
+        return false;
+
+    e->klass = shape.classList[0];
+    e->protoClass = shape.classList[1];
+    e->index = shape.index;
+    return true;
+}
+
+static bool setterCacheEntry(const Lookup &shape, PolymorphicLookupCache::Entry *e)
+{
+    if (shape.setter != Lookup::setter0 && shape.setter != Lookup::setter0Inline)
+        return false;
+
+    e->klass = shape.classList[0];
+    e->protoClass = 0;
+    e->index = shape.index;
+    e->kind = PolymorphicLookupCache::Inline;
+    return true;
+}
+
+static inline bool getFromCacheEntry(const PolymorphicLookupCache::Entry &e, Heap::Object *o, ReturnedValue *result)
+{
+    switch (e.kind) {
+    case PolymorphicLookupCache::Inline:
+        *result = o->inlinePropertyData(e.index)->asReturnedValue();
+        return true;
+    case PolymorphicLookupCache::MemberData:
+        *result = o->memberData->values.data()[e.index].asReturnedValue();
+        return true;
+    case PolymorphicLookupCache::Prototype: {
+        Heap::Object *p = o->prototype();
+        if (p->internalClass != e.protoClass)
+            return false;
+        *result = p->propertyData(e.index)->asReturnedValue();
+        return true;
+    }
+    default:
+        Q_UNREACHABLE();
+    }
+    return false;
+}
+
+// Adds the entry to the site's cache, replacing a stale one for the same class.
+// Returns false if the cache is full and the site should go megamorphic.
+static bool addCacheEntry(PolymorphicLookupCache *cache, const PolymorphicLookupCache::Entry &e)
+{
+    for (uint i = 0; i < cache->count; ++i) {
+        if (cache->entries[i].klass == e.klass) {
+            cache->entries[i] = e;
+            return true;
+        }
+    }
+    if (cache->count == PolymorphicLookupCache::Size)
+        return false;
+    cache->entries[cache->count++] = e;
+    return true;
+}
+
+static PolymorphicLookupCache *twoClassGetterCache(const Lookup *l)
+{
+    PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+    cache->count = 2;
+    PolymorphicLookupCache::Entry &first = cache->entries[0];
+    PolymorphicLookupCache::Entry &second = cache->entries[1];
+    first.klass = l->classList[0];
+    first.protoClass = l->classList[1];
+    first.index = l->index;
+    second.klass = l->classList[2];
+    second.protoClass = l->classList[3];
+    second.index = l->index2;
+
+    if (l->getter == Lookup::getter0Inlinegetter0Inline) {
+        first.kind = PolymorphicLookupCache::Inline;
+        second.kind = PolymorphicLookupCache::Inline;
+    } else if (l->getter == Lookup::getter0Inlinegetter0MemberData) {
+        first.kind = PolymorphicLookupCache::Inline;
+        second.kind = PolymorphicLookupCache::MemberData;
+    } else if (l->getter == Lookup::getter0MemberDatagetter0MemberData) {
+        first.kind = PolymorphicLookupCache::MemberData;
+        second.kind = PolymorphicLookupCache::MemberData;
+    } else if (l->getter == Lookup::getter0Inlinegetter1) {
+        first.kind = PolymorphicLookupCache::Inline;
+        second.kind = PolymorphicLookupCache::Prototype;
+    } else if (l->getter == Lookup::getter0MemberDatagetter1) {
+        first.kind = PolymorphicLookupCache::MemberData;
+        second.kind = PolymorphicLookupCache::Prototype;
+    } else {
+        Q_ASSERT(l->getter == Lookup::getter1getter1);
+        first.kind = PolymorphicLookupCache::Prototype;
+        second.kind = PolymorphicLookupCache::Prototype;
+    }
+    return cache;
+}
+
+static MegamorphicLookupCache *megamorphicCache(ExecutionEngine *engine)
+{
+    if (!engine->megamorphicLookupCache)
+        engine->megamorphicLookupCache = new MegamorphicLookupCache();
+    return engine->megamorphicLookupCache;
+}
+
 ReturnedValue Lookup::getterGeneric(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     if (const Object *o = object.as<Object>())
@@ -372,6 +555,77 @@ ReturnedValue Lookup::getterFallback(Lookup *l, ExecutionEngine *engine, const V
     return o->get(name);
 }
 
+ReturnedValue Lookup::getterManyClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    const Object *o = object.as<Object>();
+    if (!o)
+        return getterFallback(l, engine, object);
+
+    Lookup shape = shapeLookup(l->nameIndex);
+    ReturnedValue v = o->getLookup(&shape);
+    PolymorphicLookupCache::Entry e;
+    if (!getterCacheEntry(shape, &e))
+        return v;
+
+    // an accessor might have changed the state of the site in the meantime
+    if (l->getter == getterMegamorphic || l->getter == getterFallback)
+        return v;
+    if (l->getter != getterPolymorphic) {
+        l->polymorphicCache = twoClassGetterCache(l);
+        l->getter = getterPolymorphic;
+    }
+    if (addCacheEntry(l->polymorphicCache, e))
+        return v;
+
+    delete l->polymorphicCache;
+    l->polymorphicCache = 0;
+    l->getter = getterMegamorphic;
+    Identifier *name = lookupName(l, engine);
+    MegamorphicLookupCache::Entry &shared = megamorphicCache(engine)->getter(e.klass, name);
+    static_cast<PolymorphicLookupCache::Entry &>(shared) = e;
+    shared.name = name;
+    return v;
+}
+
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        const PolymorphicLookupCache *cache = l->polymorphicCache;
+        ReturnedValue v;
+        for (uint i = 0; i < cache->count; ++i) {
+            if (cache->entries[i].klass == o->internalClass && getFromCacheEntry(cache->entries[i], o, &v))
+                return v;
+        }
+    }
+    return getterManyClasses(l, engine, object);
+}
+
+ReturnedValue Lookup::getterMegamorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    const Object *o = object.as<Object>();
+    if (!o)
+        return getterFallback(l, engine, object);
+
+    InternalClass *klass = o->internalClass();
+    Identifier *name = lookupName(l, engine);
+    MegamorphicLookupCache::Entry &e = engine->megamorphicLookupCache->getter(klass, name);
+    ReturnedValue v;
+    if (e.klass == klass && e.name == name && getFromCacheEntry(e, o->d(), &v))
+        return v;
+
+    Lookup shape = shapeLookup(l->nameIndex);
+    v = o->getLookup(&shape);
+    PolymorphicLookupCache::Entry entry;
+    if (getterCacheEntry(shape, &entry)) {
+        static_cast<PolymorphicLookupCache::Entry &>(e) = entry;
+        e.name = name;
+    }
+    return v;
+}
+
 ReturnedValue Lookup::getter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     // we can safely cast to a QV4::Object here. If object is actually a string,
@@ -438,8 +692,7 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *eng
         if (l->classList[2] == o->internalClass)
             return o->inlinePropertyData(l->index2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterManyClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -453,8 +706,7 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine
         if (l->classList[2] == o->internalClass)
             return o->memberData->values.data()[l->index2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterManyClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -468,8 +720,7 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEng
         if (l->classList[2] == o->internalClass)
             return o->memberData->values.data()[l->index2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterManyClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter1(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -483,8 +734,7 @@ ReturnedValue Lookup::getter0Inlinegetter1(Lookup *l, ExecutionEngine *engine, c
         if (l->classList[2] == o->internalClass && l->classList[3] == o->prototype()->internalClass)
             return o->prototype()->propertyData(l->index2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterManyClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter1(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -498,8 +748,7 @@ ReturnedValue Lookup::getter0MemberDatagetter1(Lookup *l, ExecutionEngine *engin
         if (l->classList[2] == o->internalClass && l->classList[3] == o->prototype()->internalClass)
             return o->prototype()->propertyData(l->index2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterManyClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getter1getter1(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -514,10 +763,8 @@ ReturnedValue Lookup::getter1getter1(Lookup *l, ExecutionEngine *engine, const V
         if (l->classList[2] == o->internalClass &&
             l->classList[3] == o->prototype()->internalClass)
             return o->prototype()->propertyData(l->index2)->asReturnedValue();
-        return getterFallback(l, engine, object);
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterManyClasses(l, engine, object);
 }
 
 
@@ -729,8 +976,7 @@ ReturnedValue Lookup::globalGetter0Inline(Lookup *l, ExecutionEngine *engine)
     if (l->classList[0] == o->internalClass())
         return o->d()->inlinePropertyData(l->index)->asReturnedValue();
 
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
 }
 
 ReturnedValue Lookup::globalGetter0MemberData(Lookup *l, ExecutionEngine *engine)
@@ -739,8 +985,7 @@ ReturnedValue Lookup::globalGetter0MemberData(Lookup *l, ExecutionEngine *engine
     if (l->classList[0] == o->internalClass())
         return o->d()->memberData->values.data()[l->index].asReturnedValue();
 
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
 }
 
 ReturnedValue Lookup::globalGetter1(Lookup *l, ExecutionEngine *engine)
@@ -750,8 +995,7 @@ ReturnedValue Lookup::globalGetter1(Lookup *l, ExecutionEngine *engine)
         l->classList[1] == o->prototype()->internalClass)
         return o->prototype()->propertyData(l->index)->asReturnedValue();
 
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
 }
 
 ReturnedValue Lookup::globalGetter2(Lookup *l, ExecutionEngine *engine)
@@ -766,8 +1010,7 @@ ReturnedValue Lookup::globalGetter2(Lookup *l, ExecutionEngine *engine)
             }
         }
     }
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
 }
 
 ReturnedValue Lookup::globalGetterAccessor0(Lookup *l, ExecutionEngine *engine)
@@ -784,8 +1027,7 @@ ReturnedValue Lookup::globalGetterAccessor0(Lookup *l, ExecutionEngine *engine)
         getter->call(scope, callData);
         return scope.result.asReturnedValue();
     }
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
 }
 
 ReturnedValue Lookup::globalGetterAccessor1(Lookup *l, ExecutionEngine *engine)
@@ -803,8 +1045,7 @@ ReturnedValue Lookup::globalGetterAccessor1(Lookup *l, ExecutionEngine *engine)
         getter->call(scope, callData);
         return scope.result.asReturnedValue();
     }
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
 }
 
 ReturnedValue Lookup::globalGetterAccessor2(Lookup *l, ExecutionEngine *engine)
@@ -827,8 +1068,78 @@ ReturnedValue Lookup::globalGetterAccessor2(Lookup *l, ExecutionEngine *engine)
             }
         }
     }
-    l->globalGetter = globalGetterGeneric;
-    return globalGetterGeneric(l, engine);
+    return globalGetterManyClasses(l, engine);
+}
+
+ReturnedValue Lookup::globalGetterManyClasses(Lookup *l, ExecutionEngine *engine)
+{
+    Lookup shape = shapeLookup(l->nameIndex);
+    shape.globalGetter = globalGetterGeneric;
+    ReturnedValue v = globalGetterGeneric(&shape, engine);
+    if (engine->hasException)
+        return v;
+    PolymorphicLookupCache::Entry e;
+    if (!getterCacheEntry(shape, &e)) {
+        // rebind to the new shape, as globalGetterGeneric would have done
+        if (l->globalGetter != globalGetterPolymorphic && l->globalGetter != globalGetterMegamorphic)
+            *l = shape;
+        return v;
+    }
+
+    if (l->globalGetter == globalGetterMegamorphic)
+        return v;
+    if (l->globalGetter != globalGetterPolymorphic) {
+        // the global object changed its shape, keep what the site knew about the old one
+        PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+        cache->count = 0;
+        if (getterCacheEntry(*l, &cache->entries[0]))
+            cache->count = 1;
+        l->polymorphicCache = cache;
+        l->globalGetter = globalGetterPolymorphic;
+    }
+    if (addCacheEntry(l->polymorphicCache, e))
+        return v;
+
+    delete l->polymorphicCache;
+    l->polymorphicCache = 0;
+    l->globalGetter = globalGetterMegamorphic;
+    Identifier *name = lookupName(l, engine);
+    MegamorphicLookupCache::Entry &shared = megamorphicCache(engine)->getter(e.klass, name);
+    static_cast<PolymorphicLookupCache::Entry &>(shared) = e;
+    shared.name = name;
+    return v;
+}
+
+ReturnedValue Lookup::globalGetterPolymorphic(Lookup *l, ExecutionEngine *engine)
+{
+    Heap::Object *o = engine->globalObject->d();
+    const PolymorphicLookupCache *cache = l->polymorphicCache;
+    ReturnedValue v;
+    for (uint i = 0; i < cache->count; ++i) {
+        if (cache->entries[i].klass == o->internalClass && getFromCacheEntry(cache->entries[i], o, &v))
+            return v;
+    }
+    return globalGetterManyClasses(l, engine);
+}
+
+ReturnedValue Lookup::globalGetterMegamorphic(Lookup *l, ExecutionEngine *engine)
+{
+    Heap::Object *o = engine->globalObject->d();
+    Identifier *name = lookupName(l, engine);
+    MegamorphicLookupCache::Entry &e = engine->megamorphicLookupCache->getter(o->internalClass, name);
+    ReturnedValue v;
+    if (e.klass == o->internalClass && e.name == name && getFromCacheEntry(e, o, &v))
+        return v;
+
+    Lookup shape = shapeLookup(l->nameIndex);
+    shape.globalGetter = globalGetterGeneric;
+    v = globalGetterGeneric(&shape, engine);
+    PolymorphicLookupCache::Entry entry;
+    if (!engine->hasException && getterCacheEntry(shape, &entry)) {
+        static_cast<PolymorphicLookupCache::Entry &>(e) = entry;
+        e.name = name;
+    }
+    return v;
 }
 
 void Lookup::setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
@@ -965,9 +1276,94 @@ void Lookup::setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, c
         }
     }
 
-    l->setter = setterFallback;
-    setterFallback(l, engine, object, value);
+    setterManyClasses(l, engine, object, value);
+}
 
+void Lookup::setterManyClasses(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    Object *o = object.as<Object>();
+    if (!o) {
+        setterFallback(l, engine, object, value);
+        return;
+    }
+
+    Lookup shape = shapeLookup(l->nameIndex);
+    shape.setter = setterFallback;
+    o->setLookup(&shape, value);
+    PolymorphicLookupCache::Entry e;
+    if (!setterCacheEntry(shape, &e))
+        return;
+
+    // a setter might have changed the state of the site in the meantime
+    if (l->setter == setterMegamorphic || l->setter == setterFallback)
+        return;
+    if (l->setter != setterPolymorphic) {
+        Q_ASSERT(l->setter == setter0setter0);
+        PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+        cache->count = 2;
+        cache->entries[0].klass = l->classList[0];
+        cache->entries[0].index = l->index;
+        cache->entries[1].klass = l->classList[1];
+        cache->entries[1].index = l->index2;
+        for (uint i = 0; i < cache->count; ++i) {
+            cache->entries[i].protoClass = 0;
+            cache->entries[i].kind = PolymorphicLookupCache::Inline;
+        }
+        l->polymorphicCache = cache;
+        l->setter = setterPolymorphic;
+    }
+    if (addCacheEntry(l->polymorphicCache, e))
+        return;
+
+    delete l->polymorphicCache;
+    l->polymorphicCache = 0;
+    l->setter = setterMegamorphic;
+    Identifier *name = lookupName(l, engine);
+    MegamorphicLookupCache::Entry &shared = megamorphicCache(engine)->setter(e.klass, name);
+    static_cast<PolymorphicLookupCache::Entry &>(shared) = e;
+    shared.name = name;
+}
+
+void Lookup::setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    Object *o = static_cast<Object *>(object.managed());
+    if (o) {
+        const PolymorphicLookupCache *cache = l->polymorphicCache;
+        for (uint i = 0; i < cache->count; ++i) {
+            if (cache->entries[i].klass == o->internalClass()) {
+                o->setProperty(engine, cache->entries[i].index, value);
+                return;
+            }
+        }
+    }
+
+    setterManyClasses(l, engine, object, value);
+}
+
+void Lookup::setterMegamorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    Object *o = object.as<Object>();
+    if (!o) {
+        setterFallback(l, engine, object, value);
+        return;
+    }
+
+    InternalClass *klass = o->internalClass();
+    Identifier *name = lookupName(l, engine);
+    MegamorphicLookupCache::Entry &e = engine->megamorphicLookupCache->setter(klass, name);
+    if (e.klass == klass && e.name == name) {
+        o->setProperty(engine, e.index, value);
+        return;
+    }
+
+    Lookup shape = shapeLookup(l->nameIndex);
+    shape.setter = setterFallback;
+    o->setLookup(&shape, value);
+    PolymorphicLookupCache::Entry entry;
+    if (setterCacheEntry(shape, &entry)) {
+        static_cast<PolymorphicLookupCache::Entry &>(e) = entry;
+        e.name = name;
+    }
 }
 
 QT_END_NAMESPACE
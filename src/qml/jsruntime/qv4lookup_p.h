@@ -62,10 +62,65 @@
 
 QT_BEGIN_NAMESPACE
 
+#define QV4_LOOKUP_STATS "QV4_LOOKUP_STATS"
+
 namespace QV4 {
 
+// The shapes seen by a lookup site that has missed on more than two InternalClasses.
+// Getter entries are read according to their kind, setters always store the raw property index.
+struct PolymorphicLookupCache {
+    enum { Size = 4 };
+    enum Kind {
+        Inline,
+        MemberData,
+        Prototype
+    };
+    struct Entry {
+        InternalClass *klass;
+        InternalClass *protoClass;
+        uint index;
+        uint kind;
+    };
+
+    Entry entries[Size];
+    uint count;
+};
+
+// Shared by all sites that have seen more than PolymorphicLookupCache::Size shapes.
+struct MegamorphicLookupCache {
+    enum { Size = 512 };
+    struct Entry : PolymorphicLookupCache::Entry {
+        Identifier *name;
+    };
+
+    Entry getters[Size];
+    Entry setters[Size];
+
+    static uint hash(const InternalClass *klass, const Identifier *name)
+    { return uint((quintptr(klass) >> 4) ^ (quintptr(name) >> 3)) & (Size - 1); }
+    Entry &getter(const InternalClass *klass, const Identifier *name)
+    { return getters[hash(klass, name)]; }
+    Entry &setter(const InternalClass *klass, const Identifier *name)
+    { return setters[hash(klass, name)]; }
+};
+
+struct LookupStatistics {
+    uint uninitialized = 0;
+    uint monomorphic = 0;
+    uint polymorphic = 0;
+    uint megamorphic = 0;
+    uint fallback = 0;
+};
+
 struct Lookup {
     enum { Size = 4 };
+    enum State {
+        Uninitialized,
+        Monomorphic,
+        Polymorphic,
+        Megamorphic,
+        Fallback
+    };
     union {
         ReturnedValue (*indexedGetter)(Lookup *l, ExecutionEngine *engine, const Value &object, const Value &index);
         void (*indexedSetter)(Lookup *l, ExecutionEngine *engine, const Value &object, const Value &index, const Value &v);
@@ -81,6 +136,7 @@ struct Lookup {
             void *dummy2;
             Heap::Object *proto;
         };
+        PolymorphicLookupCache *polymorphicCache;
     };
     union {
         int level;
@@ -101,6 +157,9 @@ struct Lookup {
     static ReturnedValue getterGeneric(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterFallback(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterManyClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterMegamorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
 
     static ReturnedValue getter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getter0Inline(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -132,6 +191,9 @@ struct Lookup {
     static ReturnedValue globalGetterAccessor0(Lookup *l, ExecutionEngine *engine);
     static ReturnedValue globalGetterAccessor1(Lookup *l, ExecutionEngine *engine);
     static ReturnedValue globalGetterAccessor2(Lookup *l, ExecutionEngine *engine);
+    static ReturnedValue globalGetterManyClasses(Lookup *l, ExecutionEngine *engine);
+    static ReturnedValue globalGetterPolymorphic(Lookup *l, ExecutionEngine *engine);
+    static ReturnedValue globalGetterMegamorphic(Lookup *l, ExecutionEngine *engine);
 
     static void setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static void setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
@@ -142,10 +204,17 @@ struct Lookup {
     static void setterInsert1(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static void setterInsert2(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static void setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static void setterManyClasses(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static void setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static void setterMegamorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
 
     ReturnedValue lookup(const Value &thisObject, Object *obj, PropertyAttributes *attrs);
     ReturnedValue lookup(const Object *obj, PropertyAttributes *attrs);
 
+    State state() const;
+    void releasePolymorphicCache();
+    static LookupStatistics statistics(const ExecutionEngine *engine);
+
 };
 
 Q_STATIC_ASSERT(std::is_standard_layout<Lookup>::value);
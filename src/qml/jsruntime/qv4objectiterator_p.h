@@ -126,7 +126,12 @@ struct ForEachIteratorObject: Object {
     V4_OBJECT2(ForEachIteratorObject, Object)
     Q_MANAGED_TYPE(ForeachIteratorObject)
 
-    ReturnedValue nextPropertyName() { return d()->it().nextPropertyNameAsString(); }
+    ReturnedValue nextPropertyName() {
+        ReturnedValue name = d()->it().nextPropertyNameAsString();
+        // the iterator moves along the prototype chain in workArea without a barrier
+        WriteBarrier::rescan(engine(), d());
+        return name;
+    }
 
 protected:
     static void markObjects(Heap::Base *that, MarkStack *markStack);
@@ -138,6 +143,7 @@ void Heap::ForEachIteratorObject::init(QV4::Object *o)
     Object::init();
     it() = ObjectIterator(internalClass->engine, workArea, workArea + 1, o,
                           ObjectIterator::EnumerableOnly | ObjectIterator::WithProtoChain);
+    WriteBarrier::rescan(internalClass->engine, this);
 }
 
 
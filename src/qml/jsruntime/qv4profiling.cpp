@@ -69,6 +69,7 @@ Profiler::Profiler(QV4::ExecutionEngine *engine) : featuresEnabled(0), m_engine(
     static const int metatypes[] = {
         qRegisterMetaType<QVector<QV4::Profiling::FunctionCallProperties> >(),
         qRegisterMetaType<QVector<QV4::Profiling::MemoryAllocationProperties> >(),
+        qRegisterMetaType<QVector<QV4::Profiling::GarbageCollectionProperties> >(),
         qRegisterMetaType<FunctionLocationHash>()
     };
     Q_UNUSED(metatypes);
@@ -109,9 +110,43 @@ void Profiler::reportData(bool trackLocations)
         }
     }
 
-    emit dataReady(locations, properties, m_memory_data);
+    emit dataReady(locations, properties, m_memory_data, m_gc_data);
     m_data.clear();
     m_memory_data.clear();
+    m_gc_data.clear();
+}
+
+// Reports the objects on the heap, by type. Types can show up under different names in the
+// statistics of the memory manager, so they are merged here.
+void Profiler::trackObjectTypes(GarbageCollectionType type)
+{
+    const qint64 timestamp = m_timer.nsecsElapsed();
+    const MemoryManager::ObjectTypeStatisticsHash statistics
+            = m_engine->memoryManager->objectTypeStatistics();
+
+    QHash<QString, MemoryManager::ObjectTypeStatistics> types;
+    for (auto it = statistics.constBegin(), end = statistics.constEnd(); it != end; ++it) {
+        MemoryManager::ObjectTypeStatistics &merged = types[QString::fromUtf8(it.key())];
+        merged.count += it->count;
+        merged.size += it->size;
+    }
+
+    for (auto it = types.constBegin(), end = types.constEnd(); it != end; ++it) {
+        GarbageCollectionProperties properties = {
+            timestamp, type, it.key(), { it->count, it->size, 0, 0, 0 }
+        };
+        m_gc_data.append(properties);
+    }
+}
+
+// Lists the objects that are retained, by type. The garbage is collected first, so this is only
+// done when a client asks for it. The snapshot is sent with the next data that is reported.
+void Profiler::takeHeapSnapshot()
+{
+    if (!(featuresEnabled & (1 << FeatureGarbageCollection)))
+        return;
+    m_engine->memoryManager->runGC();
+    trackObjectTypes(HeapSnapshotObjects);
 }
 
 void Profiler::startProfiling(quint64 features)
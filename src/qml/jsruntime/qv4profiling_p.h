@@ -62,6 +62,7 @@
 #define Q_V4_PROFILE_ALLOC(engine, size, type) (!engine)
 #define Q_V4_PROFILE_DEALLOC(engine, size, type) (!engine)
 #define Q_V4_PROFILE(engine, function) (function->code(engine, function->codeData))
+#define Q_V4_PROFILING_GC(engine) (!engine)
 
 QT_BEGIN_NAMESPACE
 
@@ -91,6 +92,10 @@ QT_END_NAMESPACE
         Profiling::FunctionCallProfiler::profileCall(engine->profiler(), engine, function) :\
         function->code(engine, function->codeData))
 
+#define Q_V4_PROFILING_GC(engine)\
+    (engine->profiler() &&\
+            (engine->profiler()->featuresEnabled & (1 << Profiling::FeatureGarbageCollection)))
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -99,7 +104,8 @@ namespace Profiling {
 
 enum Features {
     FeatureFunctionCall,
-    FeatureMemoryAllocation
+    FeatureMemoryAllocation,
+    FeatureGarbageCollection
 };
 
 enum MemoryType {
@@ -108,6 +114,12 @@ enum MemoryType {
     SmallItem
 };
 
+enum GarbageCollectionType {
+    GarbageCollectionTimes,  // kind, reason, mark time, sweep time
+    GarbageCollectionMemory, // freed small items, freed large items, used small items, used large items, allocated
+    HeapSnapshotObjects      // live objects of one type in a heap snapshot: count, size
+};
+
 struct FunctionCallProperties {
     qint64 start;
     qint64 end;
@@ -139,6 +151,13 @@ struct MemoryAllocationProperties {
     MemoryType type;
 };
 
+struct GarbageCollectionProperties {
+    qint64 timestamp;
+    GarbageCollectionType type;
+    QString objectType;
+    qint64 numericData[5];
+};
+
 class FunctionCall {
 public:
 
@@ -242,23 +261,34 @@ public:
         return true;
     }
 
+    void trackGarbageCollection(const GarbageCollectionProperties &properties)
+    {
+        m_gc_data.append(properties);
+    }
+
+    void trackObjectTypes(GarbageCollectionType type);
+    qint64 timestamp() const { return m_timer.nsecsElapsed(); }
+
     quint64 featuresEnabled;
 
     void stopProfiling();
     void startProfiling(quint64 features);
     void reportData(bool trackLocations);
     void setTimer(const QElapsedTimer &timer) { m_timer = timer; }
+    void takeHeapSnapshot();
 
 signals:
     void dataReady(const QV4::Profiling::FunctionLocationHash &,
                    const QVector<QV4::Profiling::FunctionCallProperties> &,
-                   const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                   const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                   const QVector<QV4::Profiling::GarbageCollectionProperties> &);
 
 private:
     QV4::ExecutionEngine *m_engine;
     QElapsedTimer m_timer;
     QVector<FunctionCall> m_data;
     QVector<MemoryAllocationProperties> m_memory_data;
+    QVector<GarbageCollectionProperties> m_gc_data;
     QHash<quintptr, SentMarker> m_sentLocations;
 
     friend class FunctionCallProfiler;
@@ -296,6 +326,7 @@ public:
 
 Q_DECLARE_TYPEINFO(QV4::Profiling::MemoryAllocationProperties, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCallProperties, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(QV4::Profiling::GarbageCollectionProperties, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCall, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionLocation, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::Profiler::SentMarker, Q_MOVABLE_TYPE);
@@ -304,6 +335,7 @@ QT_END_NAMESPACE
 Q_DECLARE_METATYPE(QV4::Profiling::FunctionLocationHash)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::FunctionCallProperties>)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::MemoryAllocationProperties>)
+Q_DECLARE_METATYPE(QVector<QV4::Profiling::GarbageCollectionProperties>)
 
 #endif // QT_NO_QML_DEBUGGER
 
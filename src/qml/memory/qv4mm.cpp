@@ -52,11 +52,18 @@
 
 #include <QElapsedTimer>
 #include <QMap>
+#include <QMutex>
 #include <QScopedValueRollback>
+#include <QWaitCondition>
+#ifndef QT_NO_THREAD
+#include <QRunnable>
+#include <QThreadPool>
+#endif
 
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <functional>
 #include "qv4alloca_p.h"
 #include "qv4profiling_p.h"
 
@@ -408,6 +415,25 @@ bool Chunk::sweep(ClassDestroyStatsCallback classCountPtr)
     return hasUsedSlots;
 }
 
+// Whether sweeping calls destroy() on any of the objects. If not, any thread can sweep the chunk.
+bool Chunk::hasDeadObjectsToDestroy()
+{
+    HeapItem *o = realBase();
+    for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+        quintptr toFree = objectBitmap[i] ^ blackBitmap[i];
+        while (toFree) {
+            uint index = qCountTrailingZeroBits(toFree);
+            toFree ^= (static_cast<quintptr>(1) << index);
+
+            Heap::Base *b = *(o + index);
+            if (b->vtable()->destroy)
+                return true;
+        }
+        o += Chunk::Bits;
+    }
+    return false;
+}
+
 void Chunk::freeAll()
 {
     //    DEBUG << "sweeping chunk" << this << (*freeList);
@@ -482,6 +508,8 @@ void Chunk::collectGrayItems(MarkStack *markStack)
             ++nGrayItems;
 //            qDebug() << "adding gray item" << b << "to mark stack";
 #endif
+            if (markStack->top >= markStack->limit)
+                markStack->drain();
         }
         grayBitmap[i] = 0;
         o += Chunk::Bits;
@@ -597,6 +625,135 @@ void QV4::StackAllocator<T>::prevChunk() {
 
 template struct StackAllocator<Heap::CallContext>;
 
+/*
+ * Sweeps the chunks of the block allocator on a worker thread (QV4_MM_BACKGROUND_SWEEP), as long
+ * as no objects in them need to be destroyed. Destroying objects, sorting the free slots into the
+ * bins, and giving empty chunks back to the ChunkAllocator happens on the JS thread, when the
+ * chunks are taken back one by one in BlockAllocator::sweepNextChunk().
+ */
+struct ChunkSweeper {
+    Chunk *takeChunk(bool *swept, bool wait);
+    void sweepChunks();
+    size_t usedSlots();
+    // waits for the chunk that the worker is sweeping, if any
+    void forEachChunk(const std::function<void (Chunk *)> &f);
+
+    QMutex mutex;
+    QWaitCondition chunkSwept;
+    std::vector<Chunk *> queuedChunks;
+    std::vector<Chunk *> sweptChunks;
+    std::vector<Chunk *> chunksWithObjectsToDestroy;
+    size_t slotsInSweptChunk = 0; // the used slots of the chunk that the worker is sweeping
+    uint chunksSwept = 0; // by the worker, since the sweeper was created
+    bool sweeping = false; // the worker is sweeping a chunk that is in none of the lists
+    bool running = false; // a worker was started, and didn't run out of chunks yet
+};
+
+// Returns the next chunk for the JS thread, preferring those that the worker already swept.
+// If the worker has the last chunk, waits for it only if asked to, and returns null otherwise.
+Chunk *ChunkSweeper::takeChunk(bool *swept, bool wait)
+{
+    QMutexLocker locker(&mutex);
+    forever {
+        std::vector<Chunk *> *chunks = nullptr;
+        if (!sweptChunks.empty())
+            chunks = &sweptChunks;
+        else if (!chunksWithObjectsToDestroy.empty())
+            chunks = &chunksWithObjectsToDestroy;
+        else if (!queuedChunks.empty())
+            chunks = &queuedChunks;
+
+        if (chunks) {
+            *swept = (chunks == &sweptChunks);
+            Chunk *c = chunks->back();
+            chunks->pop_back();
+            return c;
+        }
+        if (!sweeping || !wait)
+            return nullptr;
+        chunkSwept.wait(&mutex);
+    }
+}
+
+void ChunkSweeper::sweepChunks()
+{
+    QMutexLocker locker(&mutex);
+    while (!queuedChunks.empty()) {
+        Chunk *c = queuedChunks.back();
+        queuedChunks.pop_back();
+        sweeping = true;
+        slotsInSweptChunk = c->nUsedSlots();
+        locker.unlock();
+
+        const bool hasObjectsToDestroy = c->hasDeadObjectsToDestroy();
+        if (!hasObjectsToDestroy)
+            c->sweep(nullptr);
+
+        locker.relock();
+        sweeping = false;
+        if (!hasObjectsToDestroy)
+            ++chunksSwept;
+        (hasObjectsToDestroy ? chunksWithObjectsToDestroy : sweptChunks).push_back(c);
+        chunkSwept.wakeAll();
+    }
+    running = false;
+}
+
+void ChunkSweeper::forEachChunk(const std::function<void (Chunk *)> &f)
+{
+    QMutexLocker locker(&mutex);
+    while (sweeping)
+        chunkSwept.wait(&mutex);
+    for (auto chunks : { &queuedChunks, &sweptChunks, &chunksWithObjectsToDestroy }) {
+        for (auto c : *chunks)
+            f(c);
+    }
+}
+
+size_t ChunkSweeper::usedSlots()
+{
+    QMutexLocker locker(&mutex);
+    size_t used = sweeping ? slotsInSweptChunk : 0;
+    for (auto chunks : { &queuedChunks, &sweptChunks, &chunksWithObjectsToDestroy }) {
+        for (auto c : *chunks)
+            used += c->nUsedSlots();
+    }
+    return used;
+}
+
+#ifndef QT_NO_THREAD
+struct ChunkSweeperJob : QRunnable {
+    ChunkSweeperJob(const QSharedPointer<ChunkSweeper> &sweeper) : sweeper(sweeper) {}
+    void run() override { sweeper->sweepChunks(); }
+
+    // The memory manager might be gone before the job runs
+    QSharedPointer<ChunkSweeper> sweeper;
+};
+
+// Not the global pool, which the application might keep busy
+Q_GLOBAL_STATIC(QThreadPool, chunkSweeperPool)
+#endif
+
+size_t BlockAllocator::usedMem() const
+{
+    size_t used = 0;
+    for (auto c : chunks)
+        used += c->nUsedSlots();
+    for (auto c : unsweptChunks)
+        used += c->nUsedSlots();
+    if (chunksInSweeper)
+        used += sweeper->usedSlots();
+    return used*Chunk::SlotSize;
+}
+
+uint BlockAllocator::chunksSweptInBackground() const
+{
+    if (!sweeper)
+        return 0;
+    QMutexLocker locker(&sweeper->mutex);
+    return sweeper->chunksSwept;
+}
+
 
 HeapItem *BlockAllocator::allocate(size_t size, bool forceAllocation) {
     Q_ASSERT((size % Chunk::SlotSize) == 0);
@@ -720,12 +877,74 @@ void BlockAllocator::sweep(ClassDestroyStatsCallback classCountPtr)
     chunks.erase(newEnd, chunks.end());
 }
 
+// Like sweep(), but leaves the chunks to be swept one by one in sweepNextChunk(),
+// as memory is needed. Until then they are neither allocated from nor marked.
+void BlockAllocator::startLazySweep(bool inBackground)
+{
+    Q_ASSERT(!hasUnsweptChunks());
+    nextFree = 0;
+    nFree = 0;
+    memset(freeBins, 0, sizeof(freeBins));
+
+    usedSlotsAfterLastSweep = 0;
+#ifndef QT_NO_THREAD
+    if (inBackground && !chunks.empty()) {
+        if (!sweeper)
+            sweeper.reset(new ChunkSweeper);
+
+        QMutexLocker locker(&sweeper->mutex);
+        sweeper->queuedChunks.swap(chunks);
+        chunksInSweeper = sweeper->queuedChunks.size();
+        if (!sweeper->running) {
+            sweeper->running = true;
+            chunkSweeperPool()->start(new ChunkSweeperJob(sweeper));
+        }
+        return;
+    }
+#else
+    Q_UNUSED(inBackground);
+#endif
+    unsweptChunks.swap(chunks);
+}
+
+bool BlockAllocator::sweepNextChunk(bool wait)
+{
+    Chunk *c;
+    bool swept = false;
+    if (!unsweptChunks.empty()) {
+        c = unsweptChunks.back();
+        unsweptChunks.pop_back();
+    } else if (chunksInSweeper) {
+        c = sweeper->takeChunk(&swept, wait);
+        if (!c)
+            return false;
+        --chunksInSweeper;
+    } else {
+        return false;
+    }
+
+    const bool isUsed = swept ? Chunk::hasNonZeroBit(c->objectBitmap) : c->sweep(nullptr);
+    if (isUsed) {
+        c->resetBlackBits();
+        c->sortIntoBins(freeBins, NumBins);
+        usedSlotsAfterLastSweep += c->nUsedSlots();
+        chunks.push_back(c);
+    } else {
+        chunkAllocator->free(c);
+    }
+    return true;
+}
+
 void BlockAllocator::freeAll()
 {
     for (auto c : chunks) {
         c->freeAll();
         chunkAllocator->free(c);
     }
+    for (auto c : unsweptChunks) {
+        c->freeAll();
+        chunkAllocator->free(c);
+    }
 }
 
 void BlockAllocator::resetBlackBits()
@@ -815,14 +1034,18 @@ void HugeItemAllocator::resetBlackBits()
 
 void HugeItemAllocator::collectGrayItems(MarkStack *markStack)
 {
-    for (auto c : chunks)
-        // Correct for a Steele type barrier
-        if (Chunk::testBit(c.chunk->blackBitmap, c.chunk->first() - c.chunk->realBase()) &&
-            Chunk::testBit(c.chunk->grayBitmap, c.chunk->first() - c.chunk->realBase())) {
+    for (auto c : chunks) {
+        const size_t index = c.chunk->first() - c.chunk->realBase();
+        // Correct for a Steele type barrier. The item is black already, so mark() would skip it.
+        if (Chunk::testBit(c.chunk->blackBitmap, index) && Chunk::testBit(c.chunk->grayBitmap, index)) {
             HeapItem *i = c.chunk->first();
             Heap::Base *b = *i;
-            b->mark(markStack);
+            markStack->push(b);
+            if (markStack->top >= markStack->limit)
+                markStack->drain();
         }
+        Chunk::clearBit(c.chunk->grayBitmap, index);
+    }
 }
 
 void HugeItemAllocator::freeAll()
@@ -842,9 +1065,36 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     , m_persistentValues(new PersistentValueStorage(engine))
     , m_weakValues(new PersistentValueStorage(engine))
     , unmanagedHeapSizeGCLimit(MIN_UNMANAGED_HEAPSIZE_GC_LIMIT)
+    , nurserySlots(MinSlotsGCLimit)
+    , gcSliceTime(2)
     , aggressiveGC(!qEnvironmentVariableIsEmpty("QV4_MM_AGGRESSIVE_GC"))
     , gcStats(!qEnvironmentVariableIsEmpty(QV4_MM_STATS))
 {
+    bool ok = false;
+#if WRITEBARRIER(steele)
+#ifdef QT_NO_DEBUG
+    verifyGC = !qEnvironmentVariableIsEmpty(QV4_MM_VERIFY_GC);
+#else
+    verifyGC = true;
+#endif
+    // The statistics are about complete collections, so they need the GC to stop the world
+    incrementalGC = !qEnvironmentVariableIsEmpty(QV4_MM_INCREMENTAL_GC) && !gcStats;
+    generationalGC = !qEnvironmentVariableIsEmpty(QV4_MM_GENERATIONAL_GC) && !gcStats && !incrementalGC;
+    if (generationalGC) {
+        // The barrier records the old objects that get written into
+        engine->writeBarrierActive = true;
+        const int nurserySize = qEnvironmentVariableIntValue(QV4_MM_NURSERY_SIZE, &ok);
+        if (ok && nurserySize > 0)
+            nurserySlots = std::max<size_t>(nurserySize >> Chunk::SlotSizeShift, Chunk::AvailableSlots);
+    }
+#endif
+#ifndef QT_NO_THREAD
+    backgroundSweep = !qEnvironmentVariableIsEmpty(QV4_MM_BACKGROUND_SWEEP);
+#endif
+    const int sliceTime = qEnvironmentVariableIntValue(QV4_MM_GC_SLICE_TIME, &ok);
+    if (ok && sliceTime > 0)
+        gcSliceTime = sliceTime;
+
 #ifdef V4_USE_VALGRIND
     VALGRIND_CREATE_MEMPOOL(this, 0, true);
 #endif
@@ -865,33 +1115,35 @@ Heap::Base *MemoryManager::allocString(std::size_t unmanagedSize)
 
     bool didGCRun = false;
     if (aggressiveGC) {
-        runGC();
+        runGC(GCAggressive);
         didGCRun = true;
     }
 
     unmanagedHeapSize += unmanagedSize;
-    if (unmanagedHeapSize > unmanagedHeapSizeGCLimit) {
+    if (unmanagedHeapSize > unmanagedHeapSizeGCLimit && !gcInProgress()) {
         if (!didGCRun)
-            runGC();
-
-        if (3*unmanagedHeapSizeGCLimit <= 4*unmanagedHeapSize)
-            // more than 75% full, raise limit
-            unmanagedHeapSizeGCLimit = std::max(unmanagedHeapSizeGCLimit, unmanagedHeapSize) * 2;
-        else if (unmanagedHeapSize * 4 <= unmanagedHeapSizeGCLimit)
-            // less than 25% full, lower limit
-            unmanagedHeapSizeGCLimit = qMax(MIN_UNMANAGED_HEAPSIZE_GC_LIMIT, unmanagedHeapSizeGCLimit/2);
+            triggerGC(GCUnmanagedHeapLimit);
+
+        // An incremental collection frees the unmanaged memory only once it has swept the heap
+        if (gcInProgress())
+            unmanagedHeapSizeGCLimitOutdated = true;
+        else
+            updateUnmanagedHeapSizeGCLimit();
         didGCRun = true;
     }
 
     HeapItem *m = blockAllocator.allocate(stringSize);
+    if (!m && blockAllocator.hasUnsweptChunks())
+        m = allocateFromUnsweptChunks(stringSize);
     if (!m) {
         if (!didGCRun && shouldRunGC())
-            runGC();
+            triggerGC(GCHeapLimit);
         m = blockAllocator.allocate(stringSize, true);
     }
 
 //    qDebug() << "allocated string" << m;
     memset(m, 0, stringSize);
+    grayAllocatedItem(m);
     return *m;
 }
 
@@ -904,7 +1156,7 @@ Heap::Base *MemoryManager::allocData(std::size_t size)
 
     bool didRunGC = false;
     if (aggressiveGC) {
-        runGC();
+        runGC(GCAggressive);
         didRunGC = true;
     }
 #ifdef DETAILED_MM_STATS
@@ -919,17 +1171,21 @@ Heap::Base *MemoryManager::allocData(std::size_t size)
     if (size > Chunk::DataSize) {
         HeapItem *h = hugeItemAllocator.allocate(size);
 //        qDebug() << "allocating huge item" << h;
+        grayAllocatedItem(h);
         return *h;
     }
 
     HeapItem *m = blockAllocator.allocate(size);
+    if (!m && blockAllocator.hasUnsweptChunks())
+        m = allocateFromUnsweptChunks(size);
     if (!m) {
         if (!didRunGC && shouldRunGC())
-            runGC();
+            triggerGC(GCHeapLimit);
         m = blockAllocator.allocate(size, true);
     }
 
     memset(m, 0, size);
+    grayAllocatedItem(m);
 //    qDebug() << "allocating data" << m;
     return *m;
 }
@@ -950,7 +1206,9 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
         Heap::MemberData *m;
         if (totalSize > Chunk::DataSize) {
             o = static_cast<Heap::Object *>(allocData(size));
-            m = hugeItemAllocator.allocate(memberSize)->as<Heap::MemberData>();
+            HeapItem *mh = hugeItemAllocator.allocate(memberSize);
+            grayAllocatedItem(mh);
+            m = mh->as<Heap::MemberData>();
         } else {
             HeapItem *mh = reinterpret_cast<HeapItem *>(allocData(totalSize));
             Heap::Base *b = *mh;
@@ -961,6 +1219,7 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
             size_t index = mh - c->realBase();
             Chunk::setBit(c->objectBitmap, index);
             Chunk::clearBit(c->extendsBitmap, index);
+            grayAllocatedItem(mh);
         }
         o->memberData.set(engine, m);
         m->internalClass = engine->internalClasses[EngineBase::Class_MemberData];
@@ -994,6 +1253,24 @@ void MarkStack::drain()
     }
 }
 
+// Returns whether the stack was drained before the deadline
+bool MarkStack::drain(QDeadlineTimer deadline)
+{
+    // Reading the clock after every object would take longer than marking most of them
+    enum { ObjectsBetweenDeadlineChecks = 64 };
+    while (top > base) {
+        for (int i = 0; i < ObjectsBetweenDeadlineChecks && top > base; ++i) {
+            Heap::Base *h = pop();
+            ++markStackSize;
+            Q_ASSERT(h);
+            h->markChildren(this);
+        }
+        if (deadline.hasExpired())
+            return top == base;
+    }
+    return true;
+}
+
 void MemoryManager::collectRoots(MarkStack *markStack)
 {
     engine->markObjects(markStack);
@@ -1031,8 +1308,13 @@ void MemoryManager::collectRoots(MarkStack *markStack)
             }
         }
 
-        if (keepAlive)
+        if (engine->writeBarrierActive && qobjectWrapper->d()->isMarked()) {
+            // The wrapper reaches its VME properties and floating children outside of the JS heap,
+            // where the write barrier doesn't see new references. Scan it again.
+            markStack->push(qobjectWrapper->d());
+        } else if (keepAlive) {
             qobjectWrapper->mark(markStack);
+        }
 
         if (markStack->top >= markStack->limit)
             markStack->drain();
@@ -1041,6 +1323,12 @@ void MemoryManager::collectRoots(MarkStack *markStack)
 
 void MemoryManager::mark()
 {
+    if (incrementalMarkStack) {
+        // Do the rest of the incremental marking in one go
+        finishIncrementalMark();
+        return;
+    }
+
     markStackSize = 0;
 
     MarkStack markStack(engine);
@@ -1049,7 +1337,7 @@ void MemoryManager::mark()
     markStack.drain();
 }
 
-void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr)
+void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr, bool lazily)
 {
     for (PersistentValueStorage::Iterator it = m_weakValues->begin(); it != m_weakValues->end(); ++it) {
         Managed *m = (*it).managed();
@@ -1096,13 +1384,20 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
         }
     }
 
-    blockAllocator.sweep(classCountPtr);
+    if (lazily)
+        blockAllocator.startLazySweep(backgroundSweep);
+    else
+        blockAllocator.sweep(classCountPtr);
     hugeItemAllocator.sweep(classCountPtr);
 }
 
 bool MemoryManager::shouldRunGC() const
 {
     size_t total = blockAllocator.totalSlots();
+    if (generationalGC) {
+        // All free slots got allocated since the last collection, before the heap needs to grow
+        return total > usedSlotsAfterLastFullSweep + nurserySlots;
+    }
     if (total > MinSlotsGCLimit && usedSlotsAfterLastFullSweep * GCOverallocation < total * 100)
         return true;
     return false;
@@ -1136,20 +1431,161 @@ size_t dumpBins(BlockAllocator *b, bool printOutput = true)
     return totalSlotMem*Chunk::SlotSize;
 }
 
-void MemoryManager::runGC()
+// Measures a collection for the profiler, if it asks for that
+class CollectionProfile
+{
+    Q_DISABLE_COPY(CollectionProfile)
+public:
+#ifndef QT_NO_QML_DEBUGGER
+    CollectionProfile(MemoryManager *mm)
+        : mm(mm), profiler(Q_V4_PROFILING_GC(mm->engine) ? mm->engine->profiler() : nullptr)
+    {
+        if (!profiler)
+            return;
+        start = profiler->timestamp();
+        usedBefore = mm->getUsedMem();
+        largeItemsBefore = mm->getLargeItemsMem();
+        timer.start();
+    }
+#else
+    CollectionProfile(MemoryManager *) {}
+#endif
+
+    void markFinished()
+    {
+#ifndef QT_NO_QML_DEBUGGER
+        if (profiler)
+            markTime = timer.nsecsElapsed();
+#endif
+    }
+
+    void report(GCKind kind, GCReason reason)
+    {
+#ifndef QT_NO_QML_DEBUGGER
+        if (!profiler)
+            return;
+        sweepTime = timer.nsecsElapsed() - markTime;
+        send(kind, reason);
+#else
+        Q_UNUSED(kind);
+        Q_UNUSED(reason);
+#endif
+    }
+
+    // A collection that runs in steps, in between JavaScript code, only takes the time of the steps
+    void addStepTime(qint64 time, bool marking)
+    {
+#ifndef QT_NO_QML_DEBUGGER
+        (marking ? markTime : sweepTime) += time;
+#else
+        Q_UNUSED(time);
+        Q_UNUSED(marking);
+#endif
+    }
+
+    void reportSteps(GCKind kind, GCReason reason)
+    {
+#ifndef QT_NO_QML_DEBUGGER
+        if (profiler && Q_V4_PROFILING_GC(mm->engine))
+            send(kind, reason);
+#else
+        Q_UNUSED(kind);
+        Q_UNUSED(reason);
+#endif
+    }
+
+private:
+#ifndef QT_NO_QML_DEBUGGER
+    void send(GCKind kind, GCReason reason)
+    {
+        const qint64 usedAfter = mm->getUsedMem();
+        const qint64 largeItemsAfter = mm->getLargeItemsMem();
+
+        Profiling::GarbageCollectionProperties times = {
+            start, Profiling::GarbageCollectionTimes, QString(),
+            { kind, reason, markTime, sweepTime, 0 }
+        };
+        profiler->trackGarbageCollection(times);
+        Profiling::GarbageCollectionProperties memory = {
+            start, Profiling::GarbageCollectionMemory, QString(),
+            { usedBefore - usedAfter, largeItemsBefore - largeItemsAfter, usedAfter,
+              largeItemsAfter, qint64(mm->getAllocatedMem()) }
+        };
+        profiler->trackGarbageCollection(memory);
+    }
+
+    MemoryManager *mm;
+    Profiling::Profiler *profiler;
+    QElapsedTimer timer;
+    qint64 start = 0;
+    qint64 markTime = 0;
+    qint64 sweepTime = 0;
+    qint64 usedBefore = 0;
+    qint64 largeItemsBefore = 0;
+#endif
+};
+
+// Adds the time of one step to the profile of a collection that runs in steps, if it has one
+class CollectionStep
+{
+    Q_DISABLE_COPY(CollectionStep)
+public:
+    CollectionStep(CollectionProfile *profile, bool marking)
+        : profile(profile), marking(marking)
+    {
+        if (profile)
+            timer.start();
+    }
+
+    ~CollectionStep()
+    {
+        if (profile)
+            profile->addStepTime(timer.nsecsElapsed(), marking);
+    }
+
+private:
+    CollectionProfile *profile;
+    QElapsedTimer timer;
+    bool marking;
+};
+
+void MemoryManager::reportSteppedCollection()
+{
+    if (!steppedProfile || incrementalMarkStack || blockAllocator.hasUnsweptChunks())
+        return;
+    steppedProfile->reportSteps(incrementalGC ? IncrementalGC : FullGC, steppedGCReason);
+    delete steppedProfile;
+    steppedProfile = nullptr;
+}
+
+void MemoryManager::runGC(GCReason reason)
 {
     if (gcBlocked) {
 //        qDebug() << "Not running GC.";
         return;
     }
 
+    if (generationalGC) {
+        collectGenerations(/*major*/true, reason);
+        return;
+    }
+
     QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
 //    qDebug() << "runGC";
 
+    // Chunks that weren't swept yet still have the black bits of the last collection
+    finishLazySweep();
+    // An incremental collection in progress is finished, and reported, as a complete one
+    delete steppedProfile;
+    steppedProfile = nullptr;
+
     if (!gcStats) {
 //        uint oldUsed = allocator.usedMem();
+        CollectionProfile profile(this);
         mark();
+        profile.markFinished();
         sweep();
+        profile.report(FullGC, reason);
 //        DEBUG << "RUN GC: allocated:" << allocator.allocatedMem() << "used before" << oldUsed << "used now" << allocator.usedMem();
     } else {
         bool triggeredByUnmanagedHeap = (unmanagedHeapSize > unmanagedHeapSizeGCLimit);
@@ -1233,12 +1669,357 @@ void MemoryManager::runGC()
     }
 
     usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep;
+    if (unmanagedHeapSizeGCLimitOutdated) {
+        updateUnmanagedHeapSizeGCLimit();
+        unmanagedHeapSizeGCLimitOutdated = false;
+    }
 
     // reset all black bits
     blockAllocator.resetBlackBits();
     hugeItemAllocator.resetBlackBits();
 }
 
+void MemoryManager::updateUnmanagedHeapSizeGCLimit()
+{
+    if (3*unmanagedHeapSizeGCLimit <= 4*unmanagedHeapSize)
+        // more than 75% full, raise limit
+        unmanagedHeapSizeGCLimit = std::max(unmanagedHeapSizeGCLimit, unmanagedHeapSize) * 2;
+    else if (unmanagedHeapSize * 4 <= unmanagedHeapSizeGCLimit)
+        // less than 25% full, lower limit
+        unmanagedHeapSizeGCLimit = qMax(MIN_UNMANAGED_HEAPSIZE_GC_LIMIT, unmanagedHeapSizeGCLimit/2);
+}
+
+/*
+ * Incremental collection (QV4_MM_INCREMENTAL_GC)
+ *
+ * Instead of marking the whole heap at once, the GC collects the roots, and then marks in slices
+ * of at most gcSliceTime ms. The slices run when the heap needs to grow, and from the event loop,
+ * so that JS code keeps running in between.
+ *
+ * While marking, the write barrier is active: objects that get heap objects written into them
+ * are grayed, and are scanned again in finishIncrementalMark(), together with the roots, as
+ * writes to the roots aren't covered by the barrier. Objects allocated while marking are both
+ * black and gray, so that they survive the collection, and the final step scans what was stored
+ * in them during initialization.
+ *
+ * The chunks of the block allocator are then swept one by one, either when memory is needed,
+ * or in later slices. The next collection only starts once all of them have been swept.
+ *
+ * This needs the write barrier, so it is only available when Qt QML is configured with
+ * -feature-qml-write-barrier. QV4_MM_VERIFY_GC, or a debug build, checks the result of every
+ * incremental marking against a complete one.
+ */
+
+// Called when the heap should be collected, instead of runGC(), which always collects completely
+void MemoryManager::triggerGC(GCReason reason)
+{
+    if (generationalGC) {
+        collectGenerations(shouldRunMajorGC(), reason);
+        return;
+    }
+
+    // The statistics are about complete collections
+    if (gcStats || (!incrementalGC && !backgroundSweep)) {
+        runGC(reason);
+        return;
+    }
+    if (gcBlocked)
+        return;
+
+    // While the last collection is still being swept, the slice continues that instead
+    if (!incrementalMarkStack && !blockAllocator.hasUnsweptChunks()) {
+        QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+        if (Q_V4_PROFILING_GC(engine)) {
+            steppedProfile = new CollectionProfile(this);
+            steppedGCReason = reason;
+        }
+
+        if (incrementalGC) {
+            CollectionStep step(steppedProfile, /*marking*/true);
+            markStackSize = 0;
+            incrementalMarkStack = new MarkStack(engine);
+            collectRoots(incrementalMarkStack);
+            engine->writeBarrierActive = true;
+        } else {
+            // Only marking stops the world, sweeping is mostly done in the background
+            {
+                CollectionStep step(steppedProfile, /*marking*/true);
+                mark();
+            }
+            CollectionStep step(steppedProfile, /*marking*/false);
+            sweep(/*lastSweep*/false, nullptr, /*lazily*/true);
+            hugeItemAllocator.resetBlackBits();
+        }
+    }
+    runGCSlice();
+}
+
+void MemoryManager::runGCSlice()
+{
+    if (gcBlocked)
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    const QDeadlineTimer deadline(gcSliceTime, Qt::PreciseTimer);
+
+    if (incrementalMarkStack) {
+        ++markingSlices;
+        {
+            CollectionStep step(steppedProfile, /*marking*/true);
+            if (!incrementalMarkStack->drain(deadline)) {
+                scheduleGCSlice();
+                return;
+            }
+            finishIncrementalMark();
+        }
+        CollectionStep step(steppedProfile, /*marking*/false);
+        sweep(/*lastSweep*/false, nullptr, /*lazily*/true);
+        hugeItemAllocator.resetBlackBits();
+    }
+
+    // Taking back the chunks swept in the background, and sweeping the others
+    while (!deadline.hasExpired() && sweepNextChunk(/*wait*/false)) {}
+    if (blockAllocator.hasUnsweptChunks())
+        scheduleGCSlice();
+    else
+        reportSteppedCollection();
+}
+
+void MemoryManager::scheduleGCSlice()
+{
+    if (gcSliceScheduled)
+        return;
+
+    // Without an event loop, the next slice runs when the heap needs to grow
+    QJSEngine *jsEngine = engine->v8Engine ? engine->jsEngine() : nullptr;
+    if (!jsEngine)
+        return;
+
+    gcSliceScheduled = true;
+    QMetaObject::invokeMethod(jsEngine, [this]() {
+        gcSliceScheduled = false;
+        runGCSlice();
+    }, Qt::QueuedConnection);
+}
+
+void MemoryManager::finishIncrementalMark()
+{
+    Q_ASSERT(incrementalMarkStack);
+    collectRoots(incrementalMarkStack);
+    blockAllocator.collectGrayItems(incrementalMarkStack);
+    hugeItemAllocator.collectGrayItems(incrementalMarkStack);
+    incrementalMarkStack->drain();
+
+    engine->writeBarrierActive = false;
+    delete incrementalMarkStack;
+    incrementalMarkStack = nullptr;
+
+    if (verifyGC)
+        verifyMarking();
+}
+
+/*
+ * Marks everything again from the roots, and aborts if that reaches objects that the incremental
+ * or generational marking left white. Those would be swept while still in use, because something
+ * stored a reference to them into the heap without going through the write barrier.
+ */
+void MemoryManager::verifyMarking()
+{
+    std::vector<Chunk *> markedChunks = blockAllocator.chunks;
+    for (const auto &c : hugeItemAllocator.chunks)
+        markedChunks.push_back(c.chunk);
+
+    std::vector<quintptr> blackBits(markedChunks.size() * Chunk::EntriesInBitmap);
+    quintptr *bits = blackBits.data();
+    for (Chunk *c : markedChunks) {
+        memcpy(bits, c->blackBitmap, sizeof(c->blackBitmap));
+        c->resetBlackBits();
+        bits += Chunk::EntriesInBitmap;
+    }
+
+    MarkStack markStack(engine);
+    collectRoots(&markStack);
+    markStack.drain();
+
+    bits = blackBits.data();
+    for (Chunk *c : markedChunks) {
+        HeapItem *o = c->realBase();
+        for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+            if (quintptr missed = c->blackBitmap[i] & ~bits[i]) {
+                Heap::Base *b = *(o + qCountTrailingZeroBits(missed));
+                qFatal("QV4::MemoryManager: reachable %s at %p was not marked, a heap write bypassed the write barrier",
+                       b->vtable()->className, static_cast<void *>(b));
+            }
+            // Keep the objects that became garbage while marking, the collection must not change
+            c->blackBitmap[i] = bits[i];
+            o += Chunk::Bits;
+        }
+        bits += Chunk::EntriesInBitmap;
+    }
+}
+
+void MemoryManager::grayAllocatedItem(HeapItem *item)
+{
+    if (Q_LIKELY(!incrementalMarkStack))
+        return;
+    Heap::Base *b = *item;
+    b->setMarkBit();
+    b->setGrayBit();
+}
+
+bool MemoryManager::sweepNextChunk(bool wait)
+{
+    {
+        CollectionStep step(steppedProfile, /*marking*/false);
+        if (!blockAllocator.sweepNextChunk(wait))
+            return false;
+    }
+
+    if (!blockAllocator.hasUnsweptChunks()) {
+        usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep;
+        if (unmanagedHeapSizeGCLimitOutdated) {
+            updateUnmanagedHeapSizeGCLimit();
+            unmanagedHeapSizeGCLimitOutdated = false;
+        }
+        reportSteppedCollection();
+    }
+    return true;
+}
+
+void MemoryManager::finishLazySweep()
+{
+    while (sweepNextChunk()) {}
+}
+
+// Sweeps the chunks left over from the last collection until one of them has room
+HeapItem *MemoryManager::allocateFromUnsweptChunks(std::size_t size)
+{
+    // Destroying the swept objects must not start another collection
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    HeapItem *m = nullptr;
+    // Rather than waiting for the chunk on the worker, the heap grows
+    while (!m && sweepNextChunk(/*wait*/false))
+        m = blockAllocator.allocate(size);
+    return m;
+}
+
+/*
+ * Generational collection (QV4_MM_GENERATIONAL_GC)
+ *
+ * Heap objects can't be moved, as C++ code holds on to plain pointers to them. So instead of
+ * copying the survivors out of a nursery, the generations are told apart by the black bits,
+ * which aren't reset after a collection: objects that survived a collection are black, and
+ * are the old generation. Everything allocated since is white, and is the young generation.
+ *
+ * A minor collection only marks the young objects reachable from the roots and from the
+ * remembered set, as mark() skips black objects. The write barrier stays active, and grays
+ * every object that gets written into. The gray old objects are the remembered set, and they
+ * are scanned again. The sweep then frees the unreachable young objects, and clears the gray
+ * bits. The young survivors keep their black bits, and so they get promoted.
+ *
+ * A minor collection runs once nurserySlots slots were allocated since the last collection.
+ * Once the old generation has grown by GCOverallocation percent since the last major
+ * collection, the black bits are reset first, so that the whole heap is collected.
+ *
+ * A young object that is only referenced from an old one that the barrier missed would be freed
+ * while in use. QV4_MM_VERIFY_GC, or a debug build, checks every minor collection against
+ * a complete marking, see verifyMarking().
+ */
+
+bool MemoryManager::shouldRunMajorGC() const
+{
+    return usedSlotsAfterLastFullSweep > MinSlotsGCLimit
+            && usedSlotsAfterLastFullSweep * 100 > usedSlotsAfterLastMajorGC * GCOverallocation;
+}
+
+void MemoryManager::collectGenerations(bool major, GCReason reason)
+{
+    if (gcBlocked)
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    CollectionProfile profile(this);
+
+    if (major) {
+        blockAllocator.resetBlackBits();
+        hugeItemAllocator.resetBlackBits();
+    }
+
+    markStackSize = 0;
+    MarkStack markStack(engine);
+    collectRoots(&markStack);
+    // After a reset of the black bits, this only clears the gray bits
+    blockAllocator.collectGrayItems(&markStack);
+    hugeItemAllocator.collectGrayItems(&markStack);
+    markStack.drain();
+    profile.markFinished();
+
+    if (!major) {
+        ++minorGCs;
+        // The old objects are all black, so missed barriers only show up in minor collections
+        if (verifyGC)
+            verifyMarking();
+    }
+
+    sweep();
+    profile.report(major ? MajorGC : MinorGC, reason);
+
+    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep;
+    if (major)
+        usedSlotsAfterLastMajorGC = usedSlotsAfterLastFullSweep;
+    if (unmanagedHeapSizeGCLimitOutdated) {
+        updateUnmanagedHeapSizeGCLimit();
+        unmanagedHeapSizeGCLimitOutdated = false;
+    }
+}
+
+// Counts the objects in the heap by type, so it expects all chunks to be swept.
+// QObject wrappers are counted under the class name of their object.
+MemoryManager::ObjectTypeStatisticsHash MemoryManager::objectTypeStatistics() const
+{
+    ObjectTypeStatisticsHash statistics;
+    auto count = [&statistics](Heap::Base *b, size_t size) {
+        const char *type = b->vtable()->className;
+        for (const VTable *vt = b->vtable(); vt; vt = vt->parent) {
+            if (vt == QObjectWrapper::staticVTable()) {
+                if (QObject *object = static_cast<Heap::QObjectWrapper *>(b)->object())
+                    type = object->metaObject()->className();
+                break;
+            }
+        }
+        ObjectTypeStatistics &s = statistics[type];
+        ++s.count;
+        s.size += size;
+    };
+
+    // Chunks that aren't swept yet still hold the garbage, only their black objects are alive
+    auto countChunk = [&count](Chunk *c, bool swept) {
+        HeapItem *base = c->realBase();
+        for (size_t i = Chunk::HeaderSize/Chunk::SlotSize; i < Chunk::NumSlots; ++i) {
+            if (!Chunk::testBit(c->objectBitmap, i))
+                continue;
+            size_t nSlots = 1;
+            while (i + nSlots < Chunk::NumSlots && Chunk::testBit(c->extendsBitmap, i + nSlots))
+                ++nSlots;
+            if (swept || Chunk::testBit(c->blackBitmap, i))
+                count(*(base + i), nSlots*Chunk::SlotSize);
+            i += nSlots - 1;
+        }
+    };
+
+    for (Chunk *c : blockAllocator.chunks)
+        countChunk(c, true);
+    for (Chunk *c : blockAllocator.unsweptChunks)
+        countChunk(c, false);
+    if (blockAllocator.chunksInSweeper) {
+        // The chunks that the worker swept keep their black bits until they are taken back
+        blockAllocator.sweeper->forEachChunk([&countChunk](Chunk *c) { countChunk(c, false); });
+    }
+    for (const auto &c : hugeItemAllocator.chunks)
+        count(*c.chunk->first(), c.size);
+    return statistics;
+}
+
 size_t MemoryManager::getUsedMem() const
 {
     return blockAllocator.usedMem();
@@ -1257,6 +2038,19 @@ size_t MemoryManager::getLargeItemsMem() const
 MemoryManager::~MemoryManager()
 {
     delete m_persistentValues;
+    delete steppedProfile;
+    steppedProfile = nullptr;
+
+    // Drop an unfinished incremental collection and the old generation,
+    // so that the last sweep frees everything
+    if (incrementalMarkStack || generationalGC) {
+        engine->writeBarrierActive = false;
+        delete incrementalMarkStack;
+        incrementalMarkStack = nullptr;
+        blockAllocator.resetBlackBits();
+        hugeItemAllocator.resetBlackBits();
+    }
+    finishLazySweep();
 
     sweep(/*lastSweep*/true);
     blockAllocator.freeAll();
@@ -56,13 +56,21 @@
 #include <private/qv4scopedvalue_p.h>
 #include <private/qv4object_p.h>
 #include <private/qv4mmdefs_p.h>
+#include <QHash>
 #include <QVector>
+#include <QSharedPointer>
 
 //#define DETAILED_MM_STATS
 
 #define QV4_MM_MAXBLOCK_SHIFT "QV4_MM_MAXBLOCK_SHIFT"
 #define QV4_MM_MAX_CHUNK_SIZE "QV4_MM_MAX_CHUNK_SIZE"
 #define QV4_MM_STATS "QV4_MM_STATS"
+#define QV4_MM_INCREMENTAL_GC "QV4_MM_INCREMENTAL_GC"
+#define QV4_MM_GC_SLICE_TIME "QV4_MM_GC_SLICE_TIME"
+#define QV4_MM_BACKGROUND_SWEEP "QV4_MM_BACKGROUND_SWEEP"
+#define QV4_MM_GENERATIONAL_GC "QV4_MM_GENERATIONAL_GC"
+#define QV4_MM_NURSERY_SIZE "QV4_MM_NURSERY_SIZE"
+#define QV4_MM_VERIFY_GC "QV4_MM_VERIFY_GC"
 
 #define MM_DEBUG 0
 
@@ -71,6 +79,7 @@ QT_BEGIN_NAMESPACE
 namespace QV4 {
 
 struct ChunkAllocator;
+struct ChunkSweeper;
 
 template<typename T>
 struct StackAllocator {
@@ -140,20 +149,19 @@ struct BlockAllocator {
     HeapItem *allocate(size_t size, bool forceAllocation = false);
 
     size_t totalSlots() const {
-        return Chunk::AvailableSlots*chunks.size();
+        return Chunk::AvailableSlots*(chunks.size() + unsweptChunks.size() + chunksInSweeper);
     }
 
     size_t allocatedMem() const {
-        return chunks.size()*Chunk::DataSize;
-    }
-    size_t usedMem() const {
-        uint used = 0;
-        for (auto c : chunks)
-            used += c->nUsedSlots()*Chunk::SlotSize;
-        return used;
+        return (chunks.size() + unsweptChunks.size() + chunksInSweeper)*Chunk::DataSize;
     }
+    size_t usedMem() const;
+    uint chunksSweptInBackground() const;
 
     void sweep(ClassDestroyStatsCallback classCountPtr);
+    void startLazySweep(bool inBackground = false);
+    bool sweepNextChunk(bool wait = true);
+    bool hasUnsweptChunks() const { return !unsweptChunks.empty() || chunksInSweeper; }
     void freeAll();
     void resetBlackBits();
     void collectGrayItems(MarkStack *markStack);
@@ -165,6 +173,11 @@ struct BlockAllocator {
     HeapItem *freeBins[NumBins];
     ChunkAllocator *chunkAllocator;
     std::vector<Chunk *> chunks;
+    // chunks that were marked, but not swept yet. They still have their black bits.
+    std::vector<Chunk *> unsweptChunks;
+    // sweeps unswept chunks on a worker thread, until they are taken back in sweepNextChunk()
+    QSharedPointer<ChunkSweeper> sweeper;
+    size_t chunksInSweeper = 0;
 #if MM_DEBUG
     uint allocations[NumBins];
 #endif
@@ -197,12 +210,34 @@ struct HugeItemAllocator {
     std::vector<HugeChunk> chunks;
 };
 
+// Why a collection ran. Reported to the profiler, together with the GCKind.
+enum GCReason {
+    GCRequested,          // runGC() was called, for example through gc() in JS
+    GCHeapLimit,          // the heap would have to grow
+    GCUnmanagedHeapLimit, // heap objects hold too much memory outside of the heap
+    GCAggressive          // QV4_MM_AGGRESSIVE_GC is set
+};
+
+enum GCKind {
+    FullGC,
+    MinorGC,
+    MajorGC,
+    IncrementalGC // marked in slices, in between JavaScript code
+};
+
+class CollectionProfile;
 
 class Q_QML_EXPORT MemoryManager
 {
     Q_DISABLE_COPY(MemoryManager);
 
 public:
+    struct ObjectTypeStatistics {
+        qint64 count;
+        qint64 size;
+    };
+    typedef QHash<const char *, ObjectTypeStatistics> ObjectTypeStatisticsHash;
+
     MemoryManager(ExecutionEngine *engine);
     ~MemoryManager();
 
@@ -434,13 +469,14 @@ public:
         return t->d();
     }
 
-    void runGC();
+    void runGC(GCReason reason = GCRequested);
 
     void dumpStats() const;
 
     size_t getUsedMem() const;
     size_t getAllocatedMem() const;
     size_t getLargeItemsMem() const;
+    ObjectTypeStatisticsHash objectTypeStatistics() const;
 
     // called when a JS object grows itself. Specifically: Heap::String::append
     void changeUnmanagedHeapSizeUsage(qptrdiff delta) { unmanagedHeapSize += delta; }
@@ -458,9 +494,24 @@ protected:
 private:
     void collectFromJSStack(MarkStack *markStack) const;
     void mark();
-    void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr);
+    void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr, bool lazily = false);
     bool shouldRunGC() const;
     void collectRoots(MarkStack *markStack);
+    void updateUnmanagedHeapSizeGCLimit();
+
+    bool gcInProgress() const { return incrementalMarkStack || blockAllocator.hasUnsweptChunks(); }
+    void triggerGC(GCReason reason);
+    void runGCSlice();
+    void scheduleGCSlice();
+    void finishIncrementalMark();
+    void verifyMarking();
+    void reportSteppedCollection();
+    void grayAllocatedItem(HeapItem *item);
+    bool sweepNextChunk(bool wait = true);
+    void finishLazySweep();
+    HeapItem *allocateFromUnsweptChunks(std::size_t size);
+    bool shouldRunMajorGC() const;
+    void collectGenerations(bool major, GCReason reason);
 
 public:
     QV4::ExecutionEngine *engine;
@@ -475,10 +526,27 @@ public:
     std::size_t unmanagedHeapSize = 0; // the amount of bytes of heap that is not managed by the memory manager, but which is held onto by managed items.
     std::size_t unmanagedHeapSizeGCLimit;
     std::size_t usedSlotsAfterLastFullSweep = 0;
+    std::size_t usedSlotsAfterLastMajorGC = 0; // the size of the old generation after the last major GC
+    std::size_t nurserySlots; // the young allocations that trigger a minor GC
+
+    // the mark stack of the incremental collection in progress, if any
+    MarkStack *incrementalMarkStack = nullptr;
+    // the profile of the collection in progress, if it runs in steps and the profiler asks for it
+    CollectionProfile *steppedProfile = nullptr;
+    GCReason steppedGCReason = GCRequested;
+    int gcSliceTime; // the time in ms that one incremental step of the GC may take
+    uint markingSlices = 0; // the incremental marking steps run so far
+    uint minorGCs = 0; // the generational collections so far that only collected the young objects
 
     bool gcBlocked = false;
     bool aggressiveGC = false;
     bool gcStats = false;
+    bool verifyGC = false; // check the incremental and generational marking against a full one
+    bool incrementalGC = false;
+    bool backgroundSweep = false;
+    bool generationalGC = false;
+    bool gcSliceScheduled = false;
+    bool unmanagedHeapSizeGCLimitOutdated = false;
 };
 
 }
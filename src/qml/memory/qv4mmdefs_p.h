@@ -53,6 +53,7 @@
 #include <private/qv4global_p.h>
 #include <private/qv4runtimeapi_p.h>
 #include <QtCore/qalgorithms.h>
+#include <QtCore/qdeadlinetimer.h>
 #include <qdebug.h>
 
 QT_BEGIN_NAMESPACE
@@ -187,6 +188,7 @@ struct Chunk {
     }
 
     bool sweep(ClassDestroyStatsCallback classCountPtr);
+    bool hasDeadObjectsToDestroy();
     void freeAll();
     void resetBlackBits();
     void collectGrayItems(QV4::MarkStack *markStack);
@@ -284,7 +286,7 @@ struct MarkStack {
         return *top;
     }
     void drain();
-
+    bool drain(QDeadlineTimer deadline);
 };
 
 // Some helper classes and macros to automate the generation of our
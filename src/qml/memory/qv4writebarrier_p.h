@@ -51,11 +51,21 @@
 //
 
 #include <private/qv4global_p.h>
+#include <private/qv4enginebase_p.h>
 #include <private/qv4value_p.h>
 
 QT_BEGIN_NAMESPACE
 
+// The Steele barrier grays the objects written to while the GC is marking incrementally or
+// remembers old objects for generational collection. It is only built in when Qt QML is configured
+// with -feature-qml-write-barrier, otherwise heap writes stay plain stores.
+#if defined(QT_FEATURE_qml_write_barrier) && QT_FEATURE_qml_write_barrier == 1
+#define WRITEBARRIER_steele 1
+#define WRITEBARRIER_none -1
+#else
+#define WRITEBARRIER_steele -1
 #define WRITEBARRIER_none 1
+#endif
 
 #define WRITEBARRIER(x) (1/WRITEBARRIER_##x == 1)
 
@@ -77,6 +87,53 @@ enum NewValueType {
 // ### this needs to be filled with a real memory fence once marking is concurrent
 Q_ALWAYS_INLINE void fence() {}
 
+#if WRITEBARRIER(steele)
+
+template <NewValueType type>
+static Q_CONSTEXPR inline bool isRequired() {
+    return type != Primitive;
+}
+
+// Only writes of heap objects into objects that might already have been marked matter. The gray
+// bit makes the GC scan the object again before it finishes marking.
+inline void write(EngineBase *engine, Heap::Base *base, Value *slot, Value value)
+{
+    *slot = value;
+    if (Q_UNLIKELY(engine->writeBarrierActive) && value.isManaged()) {
+        fence();
+        base->setGrayBit();
+    }
+}
+
+inline void write(EngineBase *engine, Heap::Base *base, Value *slot, Heap::Base *value)
+{
+    *slot = value;
+    if (Q_UNLIKELY(engine->writeBarrierActive) && value) {
+        fence();
+        base->setGrayBit();
+    }
+}
+
+inline void write(EngineBase *engine, Heap::Base *base, Heap::Base **slot, Heap::Base *value)
+{
+    *slot = value;
+    if (Q_UNLIKELY(engine->writeBarrierActive) && value) {
+        fence();
+        base->setGrayBit();
+    }
+}
+
+// For objects that update their references with plain stores, after the stores
+inline void rescan(EngineBase *engine, Heap::Base *base)
+{
+    if (Q_UNLIKELY(engine->writeBarrierActive)) {
+        fence();
+        base->setGrayBit();
+    }
+}
+
+#endif
+
 #if WRITEBARRIER(none)
 
 template <NewValueType type>
@@ -105,6 +162,12 @@ inline void write(EngineBase *engine, Heap::Base *base, Heap::Base **slot, Heap:
     *slot = value;
 }
 
+inline void rescan(EngineBase *engine, Heap::Base *base)
+{
+    Q_UNUSED(engine);
+    Q_UNUSED(base);
+}
+
 #endif
 
 }
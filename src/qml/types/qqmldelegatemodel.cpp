@@ -39,6 +39,7 @@
 
 #include "qqmldelegatemodel_p_p.h"
 
+#include <QtCore/qregexp.h>
 #include <QtQml/qqmlinfo.h>
 
 #include <private/qquickpackage_p.h>
@@ -49,6 +50,10 @@
 #include <private/qqmlcomponent_p.h>
 #include <private/qqmlincubator_p.h>
 #include <private/qqmlexpression_p.h>
+#include <private/qqmlbinding_p.h>
+#include <private/qqmlscriptstring_p.h>
+#include <private/qqmljavascriptexpression_p.h>
+#include <private/qv4qmlcontext_p.h>
 
 #include <private/qv4value_p.h>
 #include <private/qv4functionobject_p.h>
@@ -56,6 +61,12 @@
 
 QT_BEGIN_NAMESPACE
 
+// Number of delegate choices that are remembered (see resolveDelegate()),
+// or twice the number of cached items, if that is more.
+#ifndef QML_DELEGATEMODEL_MINRESOLVEDDELEGATES
+#define QML_DELEGATEMODEL_MINRESOLVEDDELEGATES 1024
+#endif
+
 class QQmlDelegateModelItem;
 
 namespace QV4 {
@@ -202,12 +213,18 @@ QQmlDelegateModelParts::QQmlDelegateModelParts(QQmlDelegateModel *parent)
 
 QQmlDelegateModelPrivate::QQmlDelegateModelPrivate(QQmlContext *ctxt)
     : m_delegate(0)
+    , m_delegateTableDirty(true)
     , m_cacheMetaType(0)
     , m_context(ctxt)
     , m_parts(0)
+    , m_sortOrder(Qt::AscendingOrder)
+    , m_sortRoleId(-1)
+    , m_filterRoleId(-1)
     , m_filterGroup(QStringLiteral("items"))
     , m_count(0)
     , m_groupCount(Compositor::MinimumGroupCount)
+    , m_fetchFromRow(0)
+    , m_fetchToRow(0)
     , m_compositorGroup(Compositor::Cache)
     , m_complete(false)
     , m_delegateValidated(false)
@@ -231,8 +248,40 @@ QQmlDelegateModelPrivate::~QQmlDelegateModelPrivate()
 
 void QQmlDelegateModelPrivate::requestMoreIfNecessary()
 {
+    requestRows(m_adaptorModel.rowCount(), 1);
+}
+
+void QQmlDelegateModelPrivate::requestRows(int row, int count)
+{
+    // The rows are fetched from the event loop, since the model will most likely
+    // insert them right away, and we might be in the middle of creating items.
+    // Requests that arrive before that are merged into one range.
     Q_Q(QQmlDelegateModel);
-    if (!m_waitingToFetchMore && m_adaptorModel.canFetchMore()) {
+    if (count <= 0)
+        return;
+
+    if (m_adaptorModel.sortFilterIndex) {
+        // The rows are given in view order, but a sorted and filtered row can
+        // come from anywhere in the model, and a model only fetches rows at its
+        // end. Only the part of the range past the last view row needs rows the
+        // model doesn't have yet, so ask for as many past its last row.
+        const int viewRowCount = m_adaptorModel.rowCount();
+        const qint64 end = qint64(row) + count;
+        if (end <= viewRowCount)
+            return;
+        count = int(end - qMax(row, viewRowCount));
+        row = m_adaptorModel.sourceRowCount();
+    }
+
+    if (!m_adaptorModel.canFetchRows(row, count))
+        return;
+
+    if (m_waitingToFetchMore) {
+        m_fetchFromRow = qMin(m_fetchFromRow, row);
+        m_fetchToRow = qMax(m_fetchToRow, row + count);
+    } else {
+        m_fetchFromRow = row;
+        m_fetchToRow = row + count;
         m_waitingToFetchMore = true;
         QCoreApplication::postEvent(q, new QEvent(QEvent::UpdateRequest));
     }
@@ -265,7 +314,10 @@ QQmlDelegateModel::~QQmlDelegateModel()
 {
     Q_D(QQmlDelegateModel);
 
-    for (QQmlDelegateModelItem *cacheItem : qAsConst(d->m_cache)) {
+    QList<QQmlDelegateModelItem *> cacheItems = d->m_cache;
+    for (const QList<QQmlDelegateModelItem *> &pool : qAsConst(d->m_reusableItemsPools))
+        cacheItems += pool;
+    for (QQmlDelegateModelItem *cacheItem : cacheItems) {
         if (cacheItem->object) {
             delete cacheItem->object;
 
@@ -336,6 +388,7 @@ void QQmlDelegateModel::componentComplete()
         static_cast<QQmlPartsModel *>(d->m_pendingParts.first())->updateFilterGroup();
 
     QVector<Compositor::Insert> inserts;
+    d->resetSortFilterIndex();
     d->m_count = d->m_adaptorModel.count();
     d->m_compositor.append(
             &d->m_adaptorModel,
@@ -375,6 +428,9 @@ void QQmlDelegateModel::setModel(const QVariant &model)
     if (d->m_complete)
         _q_itemsRemoved(0, d->m_count);
 
+    // The pooled items are bound to the data type of the old model
+    d->drainReusableItemsPool(0);
+
     d->m_adaptorModel.setModel(model, this, d->m_context->engine());
     d->m_adaptorModel.replaceWatchedRoles(QList<QByteArray>(), d->m_watchedRoles);
     for (int i = 0; d->m_parts && i < d->m_parts->models.count(); ++i) {
@@ -383,6 +439,7 @@ void QQmlDelegateModel::setModel(const QVariant &model)
     }
 
     if (d->m_complete) {
+        d->resetSortFilterIndex();
         _q_itemsInserted(0, d->m_adaptorModel.count());
         d->requestMoreIfNecessary();
     }
@@ -411,6 +468,8 @@ void QQmlDelegateModel::setDelegate(QQmlComponent *delegate)
     bool wasValid = d->m_delegate != 0;
     d->m_delegate = delegate;
     d->m_delegateValidated = false;
+    d->m_resolvedDelegates.clear();
+    d->drainReusableItemsPool(0);
 
     bool remove = wasValid;
     bool add = d->m_delegate;
@@ -426,6 +485,10 @@ void QQmlDelegateModelPrivate::delegates_append(QQmlListProperty<QQmlDelegate> *
         return;
     }
     d->m_delegates.append(delegate);
+    d->m_resolvedDelegates.clear();
+    d->m_delegateTableDirty = true;
+    QObject::connect(delegate, SIGNAL(changed()), q, SLOT(_q_delegateChanged()));
+    d->drainReusableItemsPool(0);
     d->refillItems();
 }
 
@@ -450,7 +513,12 @@ void QQmlDelegateModelPrivate::delegates_clear(QQmlListProperty<QQmlDelegate> *p
         qmlInfo(q) << QQmlDelegateModel::tr("The delegates of a DelegateModel cannot be changed within onUpdated.");
         return;
     }
+    for (QQmlDelegate *delegate : qAsConst(d->m_delegates))
+        QObject::disconnect(delegate, SIGNAL(changed()), q, SLOT(_q_delegateChanged()));
     d->m_delegates.clear();
+    d->m_resolvedDelegates.clear();
+    d->m_delegateTableDirty = true;
+    d->drainReusableItemsPool(0);
     d->refillItems();
 }
 
@@ -510,6 +578,7 @@ void QQmlDelegateModel::setRootIndex(const QVariant &root)
         d->m_adaptorModel.rootIndex = modelIndex;
         if (!d->m_adaptorModel.isValid() && d->m_adaptorModel.aim())  // The previous root index was invalidated, so we need to reconnect the model.
             d->m_adaptorModel.setModel(d->m_adaptorModel.list.list(), this, d->m_context->engine());
+        d->resetSortFilterIndex();
         if (d->m_adaptorModel.canFetchMore())
             d->m_adaptorModel.fetchMore();
         if (d->m_complete) {
@@ -528,7 +597,15 @@ void QQmlDelegateModel::setRootIndex(const QVariant &root)
     \since QtQml.Models 2.10
     \qmlproperty int QtQml.Models::DelegateModel::rows
 
-    TODO
+    This property holds the number of rows in the table of cells that the
+    model provides when \l columns is more than one.
+
+    The cells are indexed row by row, so that the index of a cell is at most
+    the largest value an \c int can hold (2147483647). Rows with cells past
+    that index are left out, and are not counted.
+
+    When the model is sorted or filtered, at most the rows that pass the
+    filter are counted, even if this property is set to more than that.
 
     The default value is \c count.
 */
@@ -628,6 +705,141 @@ void QQmlDelegateModel::resetColumns()
     d->setColumns(-1);
 }
 
+/*!
+    \since QtQml.Models 2.10
+    \qmlproperty string QtQml.Models::DelegateModel::sortRole
+
+    This property holds the role to sort the rows of a QAbstractItemModel on.
+    The values are read from the first column, and compared the same way as
+    QVariant compares them. Rows with equal values keep their order in the model.
+
+    Sorting and filtering is done by DelegateModel itself, and kept up to date as
+    the model changes, without resetting the view. By default, no sorting is done.
+
+    \sa sortOrder, filterRole
+*/
+QString QQmlDelegateModel::sortRole() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_sortRole;
+}
+
+void QQmlDelegateModel::setSortRole(const QString &role)
+{
+    Q_D(QQmlDelegateModel);
+    if (d->m_sortRole == role)
+        return;
+
+    d->m_sortRole = role;
+    d->sortFilterChanged();
+    emit sortRoleChanged();
+}
+
+/*!
+    \since QtQml.Models 2.10
+    \qmlproperty enumeration QtQml.Models::DelegateModel::sortOrder
+
+    This property holds the order in which the rows are sorted on \l sortRole,
+    which is either \c Qt.AscendingOrder (the default), or \c Qt.DescendingOrder.
+*/
+Qt::SortOrder QQmlDelegateModel::sortOrder() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_sortOrder;
+}
+
+void QQmlDelegateModel::setSortOrder(Qt::SortOrder order)
+{
+    Q_D(QQmlDelegateModel);
+    if (d->m_sortOrder == order)
+        return;
+
+    d->m_sortOrder = order;
+    d->sortFilterChanged();
+    emit sortOrderChanged();
+}
+
+/*!
+    \since QtQml.Models 2.10
+    \qmlproperty string QtQml.Models::DelegateModel::filterRole
+
+    This property holds the role to filter the rows of a QAbstractItemModel on.
+    Only the rows where the value in the first column matches \l filterValue
+    are included. By default, no filtering is done.
+
+    \sa sortRole
+*/
+QString QQmlDelegateModel::filterRole() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_filterRole;
+}
+
+void QQmlDelegateModel::setFilterRole(const QString &role)
+{
+    Q_D(QQmlDelegateModel);
+    if (d->m_filterRole == role)
+        return;
+
+    d->m_filterRole = role;
+    d->sortFilterChanged();
+    emit filterRoleChanged();
+}
+
+/*!
+    \since QtQml.Models 2.10
+    \qmlproperty var QtQml.Models::DelegateModel::filterValue
+
+    This property holds the value that the \l filterRole of a row must have
+    for the row to be included. If it is a regular expression, the value of
+    the row must match it instead.
+*/
+QVariant QQmlDelegateModel::filterValue() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_filterValue;
+}
+
+void QQmlDelegateModel::setFilterValue(const QVariant &value)
+{
+    Q_D(QQmlDelegateModel);
+    if (d->m_filterValue == value)
+        return;
+
+    d->m_filterValue = value;
+    if (!d->m_filterRole.isEmpty())
+        d->sortFilterChanged();
+    emit filterValueChanged();
+}
+
+/*!
+    \internal
+
+    Returns whether the model has more rows to fetch. Views can use this to
+    avoid working out which rows to ask for with fetchRows() when there
+    is nothing left to fetch.
+*/
+bool QQmlDelegateModel::canFetchMore() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_adaptorModel.canFetchMore();
+}
+
+/*!
+    \internal
+
+    Asks the model to fetch \a count rows from \a row, for views that
+    want rows to be available before they scroll them into view. Unlike
+    QAbstractItemModel::fetchMore(), this is cheap to call repeatedly, as
+    nothing happens if the rows are already there. The rows are view rows,
+    and are mapped to the rows of the model when it is sorted or filtered.
+*/
+void QQmlDelegateModel::fetchRows(int row, int count)
+{
+    Q_D(QQmlDelegateModel);
+    d->requestRows(row, count);
+}
+
 /*!
     \qmlmethod QModelIndex QtQml.Models::DelegateModel::modelIndex(int index)
 
@@ -682,14 +894,26 @@ bool QQmlDelegateModel::isValid() const
     return d->hasDelegate();
 }
 
-QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *object)
+QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(
+        QObject *object, QQmlInstanceModel::ReusableFlag reusableFlag)
 {
+    Q_Q(QQmlDelegateModel);
     QQmlDelegateModel::ReleaseFlags stat = 0;
     if (!object)
         return stat;
 
     if (QQmlDelegateModelItem *cacheItem = QQmlDelegateModelItem::dataForObject(object)) {
         if (cacheItem->releaseObject()) {
+            if (reusableFlag == QQmlInstanceModel::Reusable && isReusable(cacheItem)) {
+                // Take the item out of the cache, so that the compositor no longer
+                // maps its old index to it, and park it in the pool until it is
+                // either reused for another index or drained.
+                removeCacheItem(cacheItem);
+                cacheItem->poolTime = 0;
+                m_reusableItemsPools[cacheItem->delegate].append(cacheItem);
+                emit q->itemPooled(cacheItem->index, object);
+                return QQmlInstanceModel::Pooled;
+            }
             cacheItem->destroyObject();
             emitDestroyingItem(object);
             if (cacheItem->incubationTask) {
@@ -705,18 +929,139 @@ QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *objec
     return stat;
 }
 
+bool QQmlDelegateModelPrivate::isReusable(QQmlDelegateModelItem *cacheItem) const
+{
+    // Only reuse items that are fully created and not referenced from anywhere
+    // else. A scriptRef above one means that JS code holds on to the model item
+    // (e.g through DelegateModelGroup::get()), and rebinding it to another index
+    // would change what that code sees. Items that proxy a QObject from an
+    // object list cannot be rebound either, since the proxied object is part of
+    // the item's context.
+    return cacheItem->object
+            && cacheItem->delegate
+            && !cacheItem->incubationTask
+            && cacheItem->scriptRef == 1
+            && !m_adaptorModel.hasProxyObject()
+            && !qmlobject_cast<QQuickPackage *>(cacheItem->object);
+}
+
+QQmlDelegateModelItem *QQmlDelegateModelPrivate::takeReusableItem(int modelIndex, QQmlDelegateModelItem **newItem)
+{
+    // The items are pooled per delegate, so the delegate for the index is resolved
+    // first, and the oldest item of its pool is taken.
+    bool needsItem = false;
+    QQmlComponent *component = resolveDelegate(modelIndex, nullptr, &needsItem);
+    if (needsItem) {
+        // The choice depends on the model data, so it can only be made with an
+        // item bound to the index. Use a new one rather than rebinding a pooled
+        // item that might turn out to be for another delegate. If no pooled item
+        // can be reused, the new item is handed back to be used instead.
+        *newItem = m_adaptorModel.createItem(m_cacheMetaType, m_context->engine(), modelIndex);
+        if (!*newItem)
+            return nullptr;
+        component = resolveDelegate(*newItem);
+    }
+
+    const auto pool = m_reusableItemsPools.find(component);
+    if (pool == m_reusableItemsPools.end())
+        return nullptr;
+    QQmlDelegateModelItem *cacheItem = pool->takeFirst();
+    if (pool->isEmpty())
+        m_reusableItemsPools.erase(pool);
+    cacheItem->rebindIndex(m_adaptorModel, modelIndex);
+
+    if (*newItem) {
+        delete *newItem;
+        *newItem = nullptr;
+    }
+    return cacheItem;
+}
+
+void QQmlDelegateModelPrivate::destroyReusableItem(QQmlDelegateModelItem *cacheItem)
+{
+    Q_ASSERT(!m_reusableItemsPools.value(cacheItem->delegate).contains(cacheItem));
+    QObject *object = cacheItem->object;
+    cacheItem->destroyObject();
+    emitDestroyingItem(object);
+    cacheItem->Dispose();
+}
+
+void QQmlDelegateModelPrivate::drainReusableItemsPool(int maxPoolTime)
+{
+    // Each call ages the items in the pool by one. Items that have been in the
+    // pool for more than maxPoolTime calls without being reused are destroyed.
+    QList<QQmlDelegateModelItem *> expiredItems;
+    for (auto pool = m_reusableItemsPools.begin(); pool != m_reusableItemsPools.end(); ) {
+        for (auto it = pool->begin(); it != pool->end(); ) {
+            QQmlDelegateModelItem *cacheItem = *it;
+            if (cacheItem->poolTime++ < maxPoolTime) {
+                ++it;
+            } else {
+                expiredItems.append(cacheItem);
+                it = pool->erase(it);
+            }
+        }
+        if (pool->isEmpty())
+            pool = m_reusableItemsPools.erase(pool);
+        else
+            ++pool;
+    }
+
+    for (QQmlDelegateModelItem *cacheItem : qAsConst(expiredItems))
+        destroyReusableItem(cacheItem);
+}
+
 /*
   Returns ReleaseStatus flags.
+
+  If reusableFlag is Reusable, and the model is able to rebind the item to
+  another index later, the item is moved to a pool instead of being destroyed,
+  and Pooled is returned. The item can then be handed out again by object() for
+  a different index. Pooled items that are not reused are destroyed by
+  drainReusableItemsPool().
 */
 
-QQmlDelegateModel::ReleaseFlags QQmlDelegateModel::release(QObject *item)
+QQmlDelegateModel::ReleaseFlags QQmlDelegateModel::release(QObject *item, ReusableFlag reusableFlag)
 {
     Q_D(QQmlDelegateModel);
-    QQmlInstanceModel::ReleaseFlags stat = d->release(item);
+    QQmlInstanceModel::ReleaseFlags stat = d->release(item, reusableFlag);
     return stat;
 }
 
+void QQmlDelegateModel::drainReusableItemsPool(int maxPoolTime)
+{
+    Q_D(QQmlDelegateModel);
+    d->drainReusableItemsPool(maxPoolTime);
+}
+
+int QQmlDelegateModel::poolSize()
+{
+    Q_D(QQmlDelegateModel);
+    int count = 0;
+    for (const QList<QQmlDelegateModelItem *> &pool : qAsConst(d->m_reusableItemsPools))
+        count += pool.count();
+    return count;
+}
+
 // Cancel a requested async item
+QQmlIncubator::Status QQmlDelegateModel::incubationStatus(int index)
+{
+    // Tells an object that is still being incubated apart from one
+    // that is ready, or that has not been (or could not be) created.
+    Q_D(QQmlDelegateModel);
+    if (index < 0 || index >= d->m_compositor.count(d->m_compositorGroup))
+        return QQmlIncubator::Null;
+
+    Compositor::iterator it = d->m_compositor.find(d->m_compositorGroup, index);
+    if (!it->inCache())
+        return QQmlIncubator::Null;
+
+    QQmlDelegateModelItem *cacheItem = d->m_cache.at(it.cacheIndex);
+    if (cacheItem->incubationTask)
+        return cacheItem->incubationTask->status();
+    return cacheItem->object ? QQmlIncubator::Ready : QQmlIncubator::Null;
+}
+
 void QQmlDelegateModel::cancel(int index)
 {
     Q_D(QQmlDelegateModel);
@@ -956,6 +1301,117 @@ QObject *QQmlDelegateModel::parts()
     return d->m_parts;
 }
 
+QQmlComponent *QQmlDelegateModelPrivate::resolveDelegate(QQmlDelegateModelItem *cacheItem) const
+{
+    return resolveDelegate(cacheItem->index, cacheItem, nullptr);
+}
+
+QQmlComponent *QQmlDelegateModelPrivate::resolveDelegate(
+        int modelIndex, QQmlDelegateModelItem *cacheItem, bool *needsItem) const
+{
+    // Returns the delegate for the index. Delegates with a when script can only be
+    // asked with an item bound to the index. If there is none, needsItem is set.
+    if (m_delegates.isEmpty())
+        return m_delegate;
+
+    // The choice is remembered for the index, unless one of the delegates
+    // asked before the chosen one might depend on more than the model data.
+    const auto cached = m_resolvedDelegates.constFind(modelIndex);
+    if (cached != m_resolvedDelegates.constEnd())
+        return cached.value();
+
+    const int row = m_adaptorModel.rowAt(modelIndex);
+    const int column = m_adaptorModel.columnAt(modelIndex);
+
+    QQmlComponent *component = m_delegate;
+    bool cacheable = true;
+    for (QQmlDelegate *delegate : delegatesForColumn(column)) {
+        QQmlDelegatePrivate *delegatePrivate = QQmlDelegatePrivate::get(delegate);
+        if (!delegatePrivate->matchesCell(modelIndex, row, column))
+            continue;
+        if (delegatePrivate->needsItem()) {
+            if (!cacheItem) {
+                *needsItem = true;
+                return nullptr;
+            }
+            cacheable &= delegatePrivate->isCacheable();
+        }
+        if (delegatePrivate->matches(cacheItem)) {
+            component = delegate->component();
+            break;
+        }
+    }
+
+    if (cacheable) {
+        // Views only ask for the indexes around the ones they show, so rather
+        // than keeping track of which choices are still of use, start over
+        // once there are many more of them than there are items.
+        if (m_resolvedDelegates.count() >= qMax(QML_DELEGATEMODEL_MINRESOLVEDDELEGATES, 2 * m_cache.count()))
+            m_resolvedDelegates.clear();
+        m_resolvedDelegates.insert(modelIndex, component);
+    }
+    return component;
+}
+
+void QQmlDelegateModelPrivate::forgetResolvedDelegates(int index, int count)
+{
+    if (m_resolvedDelegates.isEmpty())
+        return;
+
+    if (count < m_resolvedDelegates.count()) {
+        for (int i = index; i < index + count; ++i)
+            m_resolvedDelegates.remove(i);
+    } else {
+        for (auto it = m_resolvedDelegates.begin(); it != m_resolvedDelegates.end();) {
+            if (it.key() >= index && it.key() < index + count)
+                it = m_resolvedDelegates.erase(it);
+            else
+                ++it;
+        }
+    }
+}
+
+const QVector<QQmlDelegate *> &QQmlDelegateModelPrivate::delegatesForColumn(int column) const
+{
+    // Returns the delegates that can be used for a column, in the order they were
+    // declared, so that finding the delegate for a cell of a table that uses one
+    // delegate per column only looks at the delegate(s) for that column.
+    if (m_delegateTableDirty) {
+        m_anyColumnDelegates.clear();
+        m_columnDelegates.clear();
+
+        int columnCount = 0;
+        for (QQmlDelegate *delegate : m_delegates)
+            columnCount = qMax(columnCount, delegate->column() + 1);
+        m_columnDelegates.resize(columnCount);
+
+        for (QQmlDelegate *delegate : m_delegates) {
+            if (delegate->column() == -1) {
+                m_anyColumnDelegates.append(delegate);
+                for (QVector<QQmlDelegate *> &columnDelegates : m_columnDelegates)
+                    columnDelegates.append(delegate);
+            } else if (delegate->column() >= 0) {
+                m_columnDelegates[delegate->column()].append(delegate);
+            }
+        }
+        m_delegateTableDirty = false;
+    }
+
+    if (column >= 0 && column < m_columnDelegates.count())
+        return m_columnDelegates.at(column);
+    return m_anyColumnDelegates;
+}
+
+void QQmlDelegateModel::_q_delegateChanged()
+{
+    // The items already created are left alone, but the
+    // delegates for new items are chosen from scratch
+    Q_D(QQmlDelegateModel);
+    d->m_resolvedDelegates.clear();
+    d->m_delegateTableDirty = true;
+    d->drainReusableItemsPool(0);
+}
+
 void QQmlDelegateModelPrivate::emitCreatedPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package)
 {
     for (int i = 1; i < m_groupCount; ++i)
@@ -1088,9 +1544,18 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
     Compositor::iterator it = m_compositor.find(group, index);
 
     QQmlDelegateModelItem *cacheItem = it->inCache() ? m_cache.at(it.cacheIndex) : 0;
+    bool reused = false;
 
     if (!cacheItem) {
-        cacheItem = m_adaptorModel.createItem(m_cacheMetaType, m_context->engine(), it.modelIndex());
+        QQmlDelegateModelItem *newItem = nullptr;
+        if (!m_reusableItemsPools.isEmpty()) {
+            cacheItem = takeReusableItem(it.modelIndex(), &newItem);
+            reused = cacheItem;
+        }
+        if (!cacheItem)
+            cacheItem = newItem;
+        if (!cacheItem)
+            cacheItem = m_adaptorModel.createItem(m_cacheMetaType, m_context->engine(), it.modelIndex());
         if (!cacheItem)
             return 0;
 
@@ -1099,6 +1564,15 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
         m_cache.insert(it.cacheIndex, cacheItem);
         m_compositor.setFlags(it, 1, Compositor::CacheFlag);
         Q_ASSERT(m_cache.count() == m_compositor.count(Compositor::Cache));
+
+        if (reused) {
+            if (QQmlDelegateModelAttached *attached = cacheItem->attached) {
+                for (int i = 1; i < m_groupCount; ++i)
+                    attached->m_currentIndex[i] = it.index[i];
+                attached->emitChanges();
+            }
+            emit q_func()->itemReused(index, cacheItem->object);
+        }
     }
 
     // Bump the reference counts temporarily so neither the content data or the delegate object
@@ -1137,16 +1611,7 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
             }
         }
 
-        QQmlComponent *component = m_delegate;
-        if (!m_delegates.isEmpty()) {
-            for (QQmlDelegate *delegate : qAsConst(m_delegates)) {
-                if (cacheItem->selectDelegate(delegate, ctxt)) {
-                    component = delegate->component();
-                    break;
-                }
-            }
-        }
-
+        QQmlComponent *component = resolveDelegate(cacheItem);
         if (component) {
             cacheItem->delegate = component;
             QQmlComponentPrivate *cp = QQmlComponentPrivate::get(component);
@@ -1283,7 +1748,7 @@ bool QQmlDelegateModel::event(QEvent *e)
     Q_D(QQmlDelegateModel);
     if (e->type() == QEvent::UpdateRequest) {
         d->m_waitingToFetchMore = false;
-        d->m_adaptorModel.fetchMore();
+        d->m_adaptorModel.fetchRows(d->m_fetchFromRow, d->m_fetchToRow - d->m_fetchFromRow);
     } else if (e->type() == QEvent::User) {
         d->m_incubatorCleanupScheduled = false;
         qDeleteAll(d->m_finishedIncubating);
@@ -1317,6 +1782,8 @@ void QQmlDelegateModel::_q_itemsChanged(int index, int count, const QVector<int>
     if (count <= 0 || !d->m_complete)
         return;
 
+    // The delegates chosen for the changed items might depend on the new data
+    d->forgetResolvedDelegates(index, count);
     if (d->m_adaptorModel.notify(d->m_cache, index, count, roles)) {
         QVector<Compositor::Change> changes;
         d->m_compositor.listItemsChanged(&d->m_adaptorModel, index, count, &changes);
@@ -1396,6 +1863,7 @@ void QQmlDelegateModelPrivate::itemsInserted(
 
 void QQmlDelegateModelPrivate::itemsInserted(const QVector<Compositor::Insert> &inserts)
 {
+    m_resolvedDelegates.clear();
     QVarLengthArray<QVector<QQmlChangeSet::Change>, Compositor::MaximumGroupCount> translatedInserts(m_groupCount);
     itemsInserted(inserts, &translatedInserts);
     Q_ASSERT(m_cache.count() == m_compositor.count(Compositor::Cache));
@@ -1528,6 +1996,7 @@ void QQmlDelegateModelPrivate::itemsRemoved(
 
 void QQmlDelegateModelPrivate::itemsRemoved(const QVector<Compositor::Remove> &removes)
 {
+    m_resolvedDelegates.clear();
     QVarLengthArray<QVector<QQmlChangeSet::Change>, Compositor::MaximumGroupCount> translatedRemoves(m_groupCount);
     itemsRemoved(removes, &translatedRemoves);
     Q_ASSERT(m_cache.count() == m_compositor.count(Compositor::Cache));
@@ -1569,6 +2038,7 @@ void QQmlDelegateModel::_q_itemsRemoved(int index, int count)
 void QQmlDelegateModelPrivate::itemsMoved(
         const QVector<Compositor::Remove> &removes, const QVector<Compositor::Insert> &inserts)
 {
+    m_resolvedDelegates.clear();
     QHash<int, QList<QQmlDelegateModelItem *> > movedItems;
 
     QVarLengthArray<QVector<QQmlChangeSet::Change>, Compositor::MaximumGroupCount> translatedRemoves(m_groupCount);
@@ -1675,6 +2145,7 @@ void QQmlDelegateModel::_q_modelReset()
     d->m_adaptorModel.rootIndex = QModelIndex();
 
     if (d->m_complete) {
+        d->resetSortFilterIndex();
         d->m_count = d->m_adaptorModel.count();
 
         const QList<QQmlDelegateModelItem *> cache = d->m_cache;
@@ -1701,11 +2172,18 @@ void QQmlDelegateModel::_q_modelReset()
     emit rootIndexChanged();
 }
 
+// The cells of a table are laid out row by row, so the cells of a range of
+// rows always form a single range of indexes. That way, inserting, removing
+// or moving rows is one operation, regardless of the number of columns.
+
 void QQmlDelegateModel::_q_rowsInserted(const QModelIndex &parent, int begin, int end)
 {
     Q_D(QQmlDelegateModel);
-    if (parent == d->m_adaptorModel.rootIndex)
-        _q_itemsInserted(begin, end - begin + 1);
+    if (parent == d->m_adaptorModel.rootIndex && d->m_sortFilterIndex) {
+        d->sortFilterRowsInserted(begin, end - begin + 1);
+    } else if (parent == d->m_adaptorModel.rootIndex) {
+        d->modelRowsInserted(begin, end - begin + 1);
+    }
 }
 
 void QQmlDelegateModel::_q_rowsAboutToBeRemoved(const QModelIndex &parent, int begin, int end)
@@ -1731,8 +2209,11 @@ void QQmlDelegateModel::_q_rowsAboutToBeRemoved(const QModelIndex &parent, int b
 void QQmlDelegateModel::_q_rowsRemoved(const QModelIndex &parent, int begin, int end)
 {
     Q_D(QQmlDelegateModel);
-    if (parent == d->m_adaptorModel.rootIndex)
-        _q_itemsRemoved(begin, end - begin + 1);
+    if (parent == d->m_adaptorModel.rootIndex && d->m_sortFilterIndex) {
+        d->sortFilterRowsRemoved(begin, end - begin + 1);
+    } else if (parent == d->m_adaptorModel.rootIndex) {
+        d->modelRowsRemoved(begin, end - begin + 1);
+    }
 }
 
 void QQmlDelegateModel::_q_rowsMoved(
@@ -1741,20 +2222,370 @@ void QQmlDelegateModel::_q_rowsMoved(
 {
    Q_D(QQmlDelegateModel);
     const int count = sourceEnd - sourceStart + 1;
+    if (d->m_sortFilterIndex) {
+        // Where the rows end up in the view depends on their keys, so moving
+        // them in the model is the same as removing and inserting them again
+        if (sourceParent == d->m_adaptorModel.rootIndex)
+            d->sortFilterRowsRemoved(sourceStart, count);
+        if (destinationParent == d->m_adaptorModel.rootIndex) {
+            const bool sameParent = sourceParent == destinationParent;
+            d->sortFilterRowsInserted(sameParent && sourceStart < destinationRow ? destinationRow - count : destinationRow, count);
+        }
+        return;
+    }
+
+    const int columns = d->m_adaptorModel.columnCount();
+    const int rows = columns > 0 ? d->m_count / columns : 0;
+    const int to = sourceStart > destinationRow ? destinationRow : destinationRow - count;
     if (destinationParent == d->m_adaptorModel.rootIndex && sourceParent == d->m_adaptorModel.rootIndex) {
-        _q_itemsMoved(sourceStart, sourceStart > destinationRow ? destinationRow : destinationRow - count, count);
+        if (sourceEnd < rows && destinationRow <= rows) {
+            _q_itemsMoved(sourceStart * columns, to * columns, count * columns);
+        } else {
+            // Some of the rows move from or to past the rows that can be addressed
+            d->modelRowsRemoved(sourceStart, count);
+            d->modelRowsInserted(to, count);
+        }
     } else if (sourceParent == d->m_adaptorModel.rootIndex) {
-        _q_itemsRemoved(sourceStart, count);
+        d->modelRowsRemoved(sourceStart, count);
     } else if (destinationParent == d->m_adaptorModel.rootIndex) {
-        _q_itemsInserted(destinationRow, count);
+        d->modelRowsInserted(destinationRow, count);
+    }
+}
+
+void QQmlDelegateModelPrivate::modelRowsInserted(int row, int count)
+{
+    // Only the rows that can be addressed by a flat index have cells, so rows
+    // inserted before the last of them push as many rows out of the table.
+    Q_Q(QQmlDelegateModel);
+    const int columns = m_adaptorModel.columnCount();
+    if (columns <= 0)
+        return;
+    const int oldRows = m_count / columns;
+    const int newRows = m_adaptorModel.rowCount();
+    if (row >= newRows)
+        return;
+
+    const int inserted = qMin(count, newRows - row);
+    const int pushedOut = oldRows + inserted - newRows;
+    const bool wasInTransaction = m_transaction;
+    m_transaction = true;
+    if (pushedOut > 0)
+        q->_q_itemsRemoved((oldRows - pushedOut) * columns, pushedOut * columns);
+    q->_q_itemsInserted(row * columns, inserted * columns);
+    m_transaction = wasInTransaction;
+    emitChanges();
+}
+
+void QQmlDelegateModelPrivate::modelRowsRemoved(int row, int count)
+{
+    // The opposite of modelRowsInserted(); the rows that were past the last
+    // row that could be addressed take the place of the removed rows.
+    Q_Q(QQmlDelegateModel);
+    const int columns = m_adaptorModel.columnCount();
+    if (columns <= 0)
+        return;
+    const int oldRows = m_count / columns;
+    if (row >= oldRows)
+        return;
+
+    const int removed = qMin(count, oldRows - row);
+    const int pulledIn = m_adaptorModel.rowCount() - (oldRows - removed);
+    const bool wasInTransaction = m_transaction;
+    m_transaction = true;
+    q->_q_itemsRemoved(row * columns, removed * columns);
+    if (pulledIn > 0)
+        q->_q_itemsInserted((oldRows - removed) * columns, pulledIn * columns);
+    m_transaction = wasInTransaction;
+    emitChanges();
+}
+
+void QQmlDelegateModel::_q_columnsInserted(const QModelIndex &parent, int begin, int end)
+{
+    Q_D(QQmlDelegateModel);
+    Q_UNUSED(begin);
+    Q_UNUSED(end);
+    if (parent == d->m_adaptorModel.rootIndex)
+        d->modelColumnsChanged();
+}
+
+void QQmlDelegateModel::_q_columnsRemoved(const QModelIndex &parent, int begin, int end)
+{
+    Q_D(QQmlDelegateModel);
+    Q_UNUSED(begin);
+    Q_UNUSED(end);
+    if (parent == d->m_adaptorModel.rootIndex)
+        d->modelColumnsChanged();
+}
+
+void QQmlDelegateModel::_q_columnsMoved(
+        const QModelIndex &sourceParent, int sourceStart, int sourceEnd,
+        const QModelIndex &destinationParent, int destinationColumn)
+{
+    Q_D(QQmlDelegateModel);
+    Q_UNUSED(sourceStart);
+    Q_UNUSED(sourceEnd);
+    Q_UNUSED(destinationColumn);
+    if (sourceParent == d->m_adaptorModel.rootIndex || destinationParent == d->m_adaptorModel.rootIndex)
+        d->modelColumnsChanged();
+}
+
+void QQmlDelegateModelPrivate::modelColumnsChanged()
+{
+    Q_Q(QQmlDelegateModel);
+    if (!m_complete)
+        return;
+
+    if (m_sortFilterIndex) {
+        // The keys are read from the first column, which might not be the same anymore
+        sortFilterChanged();
+        if (!m_adaptorModel.columns.isValid())
+            emit q->columnsChanged();
+        return;
+    }
+
+    if (m_adaptorModel.columns.isValid()) {
+        // The view decides the number of columns, so every cell keeps its
+        // index. But the data shown by the cells might have moved.
+        q->_q_itemsChanged(0, m_count, QVector<int>());
+        return;
+    }
+
+    // Inserting or removing a column moves the start of every row. Rather than
+    // moving the cells row by row, which would be one operation per row, let
+    // the cells keep their indexes and only add or remove cells at the end.
+    // The cells that are left look up their row and column again, and are
+    // reported as changed, so that views keep their items.
+    const int oldCount = m_count;
+    const int newCount = m_adaptorModel.count();
+    const bool wasInTransaction = m_transaction;
+    m_transaction = true;
+    if (newCount < oldCount)
+        q->_q_itemsRemoved(newCount, oldCount - newCount);
+    else if (newCount > oldCount)
+        q->_q_itemsInserted(oldCount, newCount - oldCount);
+    syncItemIndexes();
+    q->_q_itemsChanged(0, qMin(oldCount, newCount), QVector<int>());
+    m_transaction = wasInTransaction;
+    emitChanges();
+    emit q->columnsChanged();
+}
+
+QAbstractItemModel *QQmlDelegateModelPrivate::sortFilterModel() const
+{
+    // Returns the model to sort and filter, if there is anything to sort and filter
+    if (m_sortRole.isEmpty() && m_filterRole.isEmpty())
+        return nullptr;
+    return qobject_cast<QAbstractItemModel *>(m_adaptorModel.object());
+}
+
+QVariant QQmlDelegateModelPrivate::sortKey(const QAbstractItemModel *model, int row) const
+{
+    if (m_sortRoleId == -1)
+        return QVariant();
+    return model->index(row, 0, m_adaptorModel.rootIndex).data(m_sortRoleId);
+}
+
+bool QQmlDelegateModelPrivate::acceptsRow(const QAbstractItemModel *model, int row) const
+{
+    if (m_filterRoleId == -1)
+        return m_filterRole.isEmpty();
+
+    const QVariant value = model->index(row, 0, m_adaptorModel.rootIndex).data(m_filterRoleId);
+    // A regular expression in QML ends up as a QRegExp
+    if (m_filterValue.userType() == QMetaType::QRegExp)
+        return m_filterValue.toRegExp().indexIn(value.toString()) != -1;
+    return value == m_filterValue;
+}
+
+bool QQmlDelegateModelPrivate::affectsSortFilter(const QVector<int> &roles) const
+{
+    if (roles.isEmpty())
+        return true;
+    return (m_sortRoleId != -1 && roles.contains(m_sortRoleId))
+            || (m_filterRoleId != -1 && roles.contains(m_filterRoleId));
+}
+
+void QQmlDelegateModelPrivate::resetSortFilterIndex()
+{
+    // Builds the index from scratch, which is O(n log n) in the number of rows
+    QAbstractItemModel *model = sortFilterModel();
+    if (!model) {
+        m_adaptorModel.sortFilterIndex = nullptr;
+        m_sortFilterIndex.reset();
+        return;
+    }
+
+    const QHash<int, QByteArray> roleNames = model->roleNames();
+    m_sortRoleId = roleNames.key(m_sortRole.toUtf8(), -1);
+    m_filterRoleId = roleNames.key(m_filterRole.toUtf8(), -1);
+
+    const int rowCount = model->rowCount(m_adaptorModel.rootIndex);
+    QVector<QVariant> keys;
+    QVector<bool> accepted;
+    keys.reserve(rowCount);
+    accepted.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        keys.append(sortKey(model, row));
+        accepted.append(acceptsRow(model, row));
+    }
+
+    if (!m_sortFilterIndex)
+        m_sortFilterIndex.reset(new QQmlSortFilterIndex);
+    m_sortFilterIndex->clear();
+    m_sortFilterIndex->setSortOrder(m_sortOrder);
+    m_sortFilterIndex->reset(keys, accepted);
+    m_adaptorModel.sortFilterIndex = m_sortFilterIndex.data();
+}
+
+void QQmlDelegateModelPrivate::sortFilterChanged()
+{
+    // Replaces all the items, the same way as when the columns change
+    Q_Q(QQmlDelegateModel);
+    if (!m_complete)
+        return;
+
+    const bool wasInTransaction = m_transaction;
+    m_transaction = true;
+    if (m_count)
+        q->_q_itemsRemoved(0, m_count);
+    resetSortFilterIndex();
+    const int newCount = m_adaptorModel.count();
+    if (newCount)
+        q->_q_itemsInserted(0, newCount);
+    m_transaction = wasInTransaction;
+    emitChanges();
+}
+
+void QQmlDelegateModelPrivate::sortFilterRowsInserted(int row, int count)
+{
+    // The rows end up wherever their keys put them. They are reported in
+    // ascending order, so each run of adjacent rows can be inserted in turn.
+    const QAbstractItemModel *model = m_adaptorModel.aim();
+    QVector<QVariant> keys;
+    QVector<bool> accepted;
+    keys.reserve(count);
+    accepted.reserve(count);
+    for (int i = row; i < row + count; ++i) {
+        keys.append(sortKey(model, i));
+        accepted.append(acceptsRow(model, i));
+    }
+
+    // Rows set by the view limit the rows shown, so each run might push rows out
+    const QVector<int> viewRows = m_sortFilterIndex->insertSourceRows(row, keys, accepted);
+    const bool wasInTransaction = m_transaction;
+    m_transaction = true;
+    for (int i = 0; i < viewRows.count();) {
+        int end = i + 1;
+        while (end < viewRows.count() && viewRows.at(end) == viewRows.at(end - 1) + 1)
+            ++end;
+        modelRowsInserted(viewRows.at(i), end - i);
+        i = end;
+    }
+    syncItemIndexes(row);
+    m_transaction = wasInTransaction;
+    emitChanges();
+}
+
+void QQmlDelegateModelPrivate::sortFilterRowsRemoved(int row, int count)
+{
+    // The rows are reported in descending order, so each
+    // run of adjacent rows can be removed in turn
+    const QVector<int> viewRows = m_sortFilterIndex->removeSourceRows(row, count);
+    const bool wasInTransaction = m_transaction;
+    m_transaction = true;
+    for (int i = 0; i < viewRows.count();) {
+        int end = i + 1;
+        while (end < viewRows.count() && viewRows.at(end) == viewRows.at(end - 1) - 1)
+            ++end;
+        modelRowsRemoved(viewRows.at(end - 1), end - i);
+        i = end;
+    }
+    syncItemIndexes(row);
+    m_transaction = wasInTransaction;
+    emitChanges();
+}
+
+void QQmlDelegateModelPrivate::sortFilterRowChanged(int row, int firstColumn, int lastColumn, const QVector<int> &roles)
+{
+    Q_Q(QQmlDelegateModel);
+    const int columns = m_adaptorModel.columnCount();
+    lastColumn = qMin(lastColumn, columns - 1);
+
+    int viewRow = m_sortFilterIndex->viewRow(row);
+    if (firstColumn == 0 && affectsSortFilter(roles)) {
+        // The row might move, or be filtered in or out
+        const QAbstractItemModel *model = m_adaptorModel.aim();
+        int fromViewRow;
+        m_sortFilterIndex->changeSourceRow(row, sortKey(model, row), acceptsRow(model, row), &fromViewRow, &viewRow);
+        const int rows = columns > 0 ? m_count / columns : 0;
+        if (fromViewRow != -1 && viewRow == -1) {
+            modelRowsRemoved(fromViewRow, 1);
+        } else if (fromViewRow == -1 && viewRow != -1) {
+            modelRowsInserted(viewRow, 1);
+            return;
+        } else if (fromViewRow != viewRow && fromViewRow < rows && viewRow < rows) {
+            q->_q_itemsMoved(fromViewRow * columns, viewRow * columns, columns);
+        } else if (fromViewRow != viewRow) {
+            // The row moves past the rows shown, or back from there
+            modelRowsRemoved(fromViewRow, 1);
+            modelRowsInserted(viewRow, 1);
+            return;
+        }
+    }
+
+    if (viewRow != -1 && viewRow < m_count / qMax(1, columns) && lastColumn >= firstColumn)
+        q->_q_itemsChanged(viewRow * columns + firstColumn, lastColumn - firstColumn + 1, roles);
+}
+
+void QQmlDelegateModelPrivate::syncItemIndexes(int fromRow)
+{
+    // Inserting or removing rows in the model moves the rows after them, even
+    // if the items for those rows stay where they are in the view. The same goes
+    // for the columns. So let the items on those rows look up their row and
+    // column again, and rebind only the ones that now show another cell.
+    const QList<QQmlDelegateModelItem *> cache = m_cache;
+    for (QQmlDelegateModelItem *item : cache) {
+        const int index = item->modelIndex();
+        if (index == -1 || item->sourceRow() < fromRow || !m_cache.contains(item))
+            continue;
+        if (m_adaptorModel.rowAt(index) != item->sourceRow() || m_adaptorModel.columnAt(index) != item->sourceColumn())
+            item->setModelIndex(index);
     }
 }
 
 void QQmlDelegateModel::_q_dataChanged(const QModelIndex &begin, const QModelIndex &end, const QVector<int> &roles)
 {
     Q_D(QQmlDelegateModel);
-    if (begin.parent() == d->m_adaptorModel.rootIndex)
-        _q_itemsChanged(begin.row(), end.row() - begin.row() + 1, roles);
+    if (begin.parent() != d->m_adaptorModel.rootIndex)
+        return;
+
+    if (d->m_sortFilterIndex) {
+        const bool wasInTransaction = d->m_transaction;
+        d->m_transaction = true;
+        for (int row = begin.row(); row <= end.row(); ++row)
+            d->sortFilterRowChanged(row, begin.column(), end.column(), roles);
+        d->m_transaction = wasInTransaction;
+        d->emitChanges();
+        return;
+    }
+
+    // Rows past the last row that can be addressed have no cells
+    const int lastRow = qMin(end.row(), d->m_adaptorModel.rowCount() - 1);
+    if (begin.row() > lastRow)
+        return;
+
+    if (begin.row() == lastRow) {
+        const int index = d->m_adaptorModel.indexAt(begin.row(), begin.column());
+        if (index >= 0) {
+            const int lastColumn = qMin(end.column(), d->m_adaptorModel.columnCount() - 1);
+            _q_itemsChanged(index, lastColumn - begin.column() + 1, roles);
+        }
+    } else {
+        // Mark the whole rows as changed, rather than one range of columns per
+        // row. Only the cells that have delegates are updated anyway.
+        const int columns = d->m_adaptorModel.columnCount();
+        _q_itemsChanged(d->m_adaptorModel.indexAt(begin.row(), 0), (lastRow - begin.row() + 1) * columns, roles);
+    }
 }
 
 bool QQmlDelegateModel::isDescendantOf(const QPersistentModelIndex& desc, const QList< QPersistentModelIndex >& parents) const
@@ -1780,6 +2611,13 @@ void QQmlDelegateModel::_q_layoutChanged(const QList<QPersistentModelIndex> &par
             return;
         }
 
+        if (d->m_sortFilterIndex) {
+            // The rows have been sorted in the model, which only
+            // matters for rows that compare equal in the view
+            d->sortFilterChanged();
+            return;
+        }
+
         // mark all items as changed
         _q_itemsChanged(0, d->m_count, QVector<int>());
 
@@ -2088,6 +2926,7 @@ QQmlDelegateModelItem::QQmlDelegateModelItem(
     , scriptRef(0)
     , groups(0)
     , index(modelIndex)
+    , poolTime(0)
 {
     metaType->addref();
 }
@@ -2166,23 +3005,6 @@ int QQmlDelegateModelItem::groupIndex(Compositor::Group group)
     return -1;
 }
 
-bool QQmlDelegateModelItem::selectDelegate(QQmlDelegate *delegate, QQmlContextData *context)
-{
-    QQmlContext *delegateContext = qmlContext(delegate);
-    delegateContext->setParent(context->asQQmlContext());
-
-    const QQmlScriptString when = delegate->when();
-    if (when.isEmpty())
-        return delegate->index() == index;
-
-    QQmlExpression expression(when, delegateContext, this, this);
-    bool undefined = false;
-    bool result = expression.evaluate(&undefined).toBool();
-    if (undefined)
-        qWarning() << "### undefined:" << expression.expression() << "(" << index << ")";
-    return !undefined && result;
-}
-
 //---------------------------------------------------------------------------
 
 QQmlDelegateModelAttachedMetaObject::QQmlDelegateModelAttachedMetaObject(
@@ -3340,7 +4162,7 @@ QObject *QQmlPartsModel::object(int index, bool asynchronous)
     return 0;
 }
 
-QQmlInstanceModel::ReleaseFlags QQmlPartsModel::release(QObject *item)
+QQmlInstanceModel::ReleaseFlags QQmlPartsModel::release(QObject *item, ReusableFlag)
 {
     QQmlInstanceModel::ReleaseFlags flags = 0;
 
@@ -3525,26 +4347,130 @@ QV4::ReturnedValue QQmlDelegateModelEngineData::array(QV8Engine *engine, const Q
     return o.asReturnedValue();
 }
 
-class QQmlDelegatePrivate : public QObjectPrivate
+// Evaluates the when script of a QQmlDelegate for an item. The script is compiled
+// once, together with the QML context it runs in. Before each evaluation, the scope
+// object of that context is pointed at the item, so that the model data of the item
+// is in scope, without creating a new expression or context for every item.
+class QQmlDelegateSelector : public QQmlJavaScriptExpression
 {
 public:
-    QQmlDelegatePrivate();
+    QQmlDelegateSelector(const QQmlScriptString &script, QQmlContextData *context);
+
+    bool select(QQmlDelegateModelItem *item, bool *isUndefined);
+
+    QString expressionIdentifier() const override;
+    void expressionChanged() override {}
 
-    bool complete;
-    bool validated;
-    int index;
-    QQmlScriptString when;
-    QQmlComponent *component;
+private:
+    QString m_script;
+    QV4::PersistentValue m_qmlContext;
 };
 
+QQmlDelegateSelector::QQmlDelegateSelector(const QQmlScriptString &script, QQmlContextData *context)
+{
+    const QQmlScriptStringPrivate *scriptPrivate = QQmlScriptStringPrivate::get(script);
+    m_script = scriptPrivate->script;
+    setContext(context);
+
+    // Use the function compiled together with the document, if there is one
+    QV4::Function *function = nullptr;
+    QQmlContextData *scriptContext = scriptPrivate->context ? QQmlContextData::get(scriptPrivate->context) : nullptr;
+    if (scriptContext && scriptContext->typeCompilationUnit && scriptPrivate->bindingId != QQmlBinding::Invalid)
+        function = scriptContext->typeCompilationUnit->runtimeFunctions.at(scriptPrivate->bindingId);
+    if (!function) {
+        createQmlBinding(context, nullptr, m_script, context->urlString(), scriptPrivate->lineNumber);
+        function = this->function();
+    }
+
+    QV4::ExecutionEngine *engine = QQmlEnginePrivate::getV4Engine(context->engine);
+    QV4::Scope scope(engine);
+    QV4::Scoped<QV4::QmlContext> qmlContext(scope, QV4::QmlContext::create(engine->rootContext(), context, nullptr));
+    m_qmlContext.set(engine, qmlContext);
+    setupFunction(qmlContext, function);
+}
+
+bool QQmlDelegateSelector::select(QQmlDelegateModelItem *item, bool *isUndefined)
+{
+    *isUndefined = true;
+    if (!context() || !context()->isValid())
+        return false;
+
+    QV4::Scope scope(QQmlEnginePrivate::getV4Engine(context()->engine));
+    QV4::Scoped<QV4::QmlContext> qmlContext(scope, m_qmlContext.value());
+    qmlContext->d()->qml->scopeObject = item;
+    setScopeObject(item);
+
+    QV4::ScopedCallData callData(scope);
+    evaluate(callData, isUndefined, scope);
+    const bool result = !*isUndefined && scope.result.toBoolean();
+
+    qmlContext->d()->qml->scopeObject = nullptr;
+    setScopeObject(nullptr);
+    return result;
+}
+
+QString QQmlDelegateSelector::expressionIdentifier() const
+{
+    return QLatin1Char('"') + m_script + QLatin1Char('"');
+}
+
 QQmlDelegatePrivate::QQmlDelegatePrivate()
     : complete(false),
       validated(false),
+      cacheable(false),
       index(-1),
+      row(-1),
+      column(-1),
+      whenLiteral(-1),
       component(nullptr)
 {
 }
 
+QQmlDelegatePrivate::~QQmlDelegatePrivate()
+{
+}
+
+bool QQmlDelegatePrivate::matchesCell(int modelIndex, int modelRow, int modelColumn) const
+{
+    // A delegate without index, row, column or when is used for every cell
+    return (index == -1 || index == modelIndex)
+            && (row == -1 || row == modelRow)
+            && (column == -1 || column == modelColumn);
+}
+
+bool QQmlDelegatePrivate::needsItem()
+{
+    // Returns true if when is a script that needs to be evaluated for each item
+    Q_Q(QQmlDelegate);
+    if (when.isEmpty())
+        return false;
+
+    if (whenLiteral == -1 && !selector) {
+        // Literals, like when: true, are common enough to not evaluate them at all
+        bool ok = false;
+        const bool value = when.booleanLiteral(&ok);
+        if (ok)
+            whenLiteral = value ? 1 : 0;
+        else if (QQmlContext *context = qmlContext(q))
+            selector.reset(new QQmlDelegateSelector(when, QQmlContextData::get(context)));
+    }
+    return whenLiteral == -1;
+}
+
+bool QQmlDelegatePrivate::matches(QQmlDelegateModelItem *item)
+{
+    if (!needsItem())
+        return when.isEmpty() || whenLiteral == 1;
+    if (!selector)
+        return false;
+
+    bool undefined = false;
+    const bool result = selector->select(item, &undefined);
+    if (undefined)
+        qWarning() << "### undefined:" << selector->expressionIdentifier() << "(" << item->index << ")";
+    return result;
+}
+
 QQmlDelegate::QQmlDelegate(QObject *parent)
     : QObject(*(new QQmlDelegatePrivate), parent)
 {
@@ -3565,6 +4491,7 @@ void QQmlDelegate::setComponent(QQmlComponent *component)
     d->validated = false;
     d->component = component;
     // TODO
+    emit changed();
 }
 
 int QQmlDelegate::index() const
@@ -3576,7 +4503,40 @@ int QQmlDelegate::index() const
 void QQmlDelegate::setIndex(int index)
 {
     Q_D(QQmlDelegate);
+    if (d->index == index)
+        return;
     d->index = index;
+    emit changed();
+}
+
+int QQmlDelegate::row() const
+{
+    Q_D(const QQmlDelegate);
+    return d->row;
+}
+
+void QQmlDelegate::setRow(int row)
+{
+    Q_D(QQmlDelegate);
+    if (d->row == row)
+        return;
+    d->row = row;
+    emit changed();
+}
+
+int QQmlDelegate::column() const
+{
+    Q_D(const QQmlDelegate);
+    return d->column;
+}
+
+void QQmlDelegate::setColumn(int column)
+{
+    Q_D(QQmlDelegate);
+    if (d->column == column)
+        return;
+    d->column = column;
+    emit changed();
 }
 
 QQmlScriptString QQmlDelegate::when() const
@@ -3589,6 +4549,24 @@ void QQmlDelegate::setWhen(const QQmlScriptString &when)
 {
     Q_D(QQmlDelegate);
     d->when = when;
+    d->whenLiteral = -1;
+    d->selector.reset();
+    emit changed();
+}
+
+bool QQmlDelegate::isCacheable() const
+{
+    Q_D(const QQmlDelegate);
+    return d->cacheable;
+}
+
+void QQmlDelegate::setCacheable(bool cacheable)
+{
+    Q_D(QQmlDelegate);
+    if (d->cacheable == cacheable)
+        return;
+    d->cacheable = cacheable;
+    emit changed();
 }
 
 void QQmlDelegate::classBegin()
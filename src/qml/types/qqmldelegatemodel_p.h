@@ -92,6 +92,10 @@ class Q_QML_PRIVATE_EXPORT QQmlDelegateModel : public QQmlInstanceModel, public
     Q_PROPERTY(QVariant rootIndex READ rootIndex WRITE setRootIndex NOTIFY rootIndexChanged)
     Q_PROPERTY(int rows READ rows WRITE setRows RESET resetRows NOTIFY rowsChanged REVISION 10)
     Q_PROPERTY(int columns READ columns WRITE setColumns RESET resetColumns NOTIFY columnsChanged REVISION 10)
+    Q_PROPERTY(QString sortRole READ sortRole WRITE setSortRole NOTIFY sortRoleChanged REVISION 10)
+    Q_PROPERTY(Qt::SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortOrderChanged REVISION 10)
+    Q_PROPERTY(QString filterRole READ filterRole WRITE setFilterRole NOTIFY filterRoleChanged REVISION 10)
+    Q_PROPERTY(QVariant filterValue READ filterValue WRITE setFilterValue NOTIFY filterValueChanged REVISION 10)
     Q_CLASSINFO("DefaultProperty", "delegate")
     Q_INTERFACES(QQmlParserStatus)
 public:
@@ -121,14 +125,32 @@ public:
     void setColumns(int columns);
     void resetColumns();
 
+    QString sortRole() const;
+    void setSortRole(const QString &role);
+
+    Qt::SortOrder sortOrder() const;
+    void setSortOrder(Qt::SortOrder order);
+
+    QString filterRole() const;
+    void setFilterRole(const QString &role);
+
+    QVariant filterValue() const;
+    void setFilterValue(const QVariant &value);
+
+    bool canFetchMore() const;
+    void fetchRows(int row, int count);
+
     Q_INVOKABLE QVariant modelIndex(int idx) const;
     Q_INVOKABLE QVariant parentModelIndex() const;
 
     int count() const override;
     bool isValid() const override;
     QObject *object(int index, bool asynchronous = false) override;
-    ReleaseFlags release(QObject *object) override;
+    ReleaseFlags release(QObject *object, ReusableFlag reusableFlag = NotReusable) override;
     void cancel(int index) override;
+    QQmlIncubator::Status incubationStatus(int index) override;
+    void drainReusableItemsPool(int maxPoolTime) override;
+    int poolSize() override;
     QString stringValue(int index, const QString &role) override;
     void setWatchedRoles(const QList<QByteArray> &roles) override;
 
@@ -153,9 +175,14 @@ Q_SIGNALS:
     void rootIndexChanged();
     Q_REVISION(10) void rowsChanged();
     Q_REVISION(10) void columnsChanged();
+    Q_REVISION(10) void sortRoleChanged();
+    Q_REVISION(10) void sortOrderChanged();
+    Q_REVISION(10) void filterRoleChanged();
+    Q_REVISION(10) void filterValueChanged();
 
 private Q_SLOTS:
     void _q_itemsChanged(int index, int count, const QVector<int> &roles);
+    void _q_delegateChanged();
     void _q_itemsInserted(int index, int count);
     void _q_itemsRemoved(int index, int count);
     void _q_itemsMoved(int from, int to, int count);
@@ -164,6 +191,9 @@ private Q_SLOTS:
     void _q_rowsAboutToBeRemoved(const QModelIndex &parent, int begin, int end);
     void _q_rowsRemoved(const QModelIndex &,int,int);
     void _q_rowsMoved(const QModelIndex &, int, int, const QModelIndex &, int);
+    void _q_columnsInserted(const QModelIndex &, int, int);
+    void _q_columnsRemoved(const QModelIndex &, int, int);
+    void _q_columnsMoved(const QModelIndex &, int, int, const QModelIndex &, int);
     void _q_dataChanged(const QModelIndex&,const QModelIndex&,const QVector<int> &);
     void _q_layoutChanged(const QList<QPersistentModelIndex>&, QAbstractItemModel::LayoutChangeHint);
 
@@ -257,9 +287,12 @@ class Q_QML_PRIVATE_EXPORT QQmlDelegate : public QObject, public QQmlParserStatu
 {
     Q_OBJECT
     Q_INTERFACES(QQmlParserStatus)
-    Q_PROPERTY(QQmlComponent *component READ component WRITE setComponent)
-    Q_PROPERTY(int index READ index WRITE setIndex)
-    Q_PROPERTY(QQmlScriptString when READ when WRITE setWhen)
+    Q_PROPERTY(QQmlComponent *component READ component WRITE setComponent NOTIFY changed)
+    Q_PROPERTY(int index READ index WRITE setIndex NOTIFY changed)
+    Q_PROPERTY(int row READ row WRITE setRow NOTIFY changed)
+    Q_PROPERTY(int column READ column WRITE setColumn NOTIFY changed)
+    Q_PROPERTY(QQmlScriptString when READ when WRITE setWhen NOTIFY changed)
+    Q_PROPERTY(bool cacheable READ isCacheable WRITE setCacheable NOTIFY changed)
     Q_CLASSINFO("DefaultProperty", "component")
 
 public:
@@ -274,9 +307,20 @@ public:
     int row() const;
     void setRow(int row);
 
+    int column() const;
+    void setColumn(int column);
+
     QQmlScriptString when() const;
     void setWhen(const QQmlScriptString &when);
 
+    // Set to true if when only depends on the model data, so that
+    // the choice of delegate can be remembered for each index.
+    bool isCacheable() const;
+    void setCacheable(bool cacheable);
+
+Q_SIGNALS:
+    void changed();
+
 protected:
     void classBegin() override;
     void componentComplete() override;
@@ -45,9 +45,11 @@
 
 #include <QtQml/qqmlcontext.h>
 #include <QtQml/qqmlincubator.h>
+#include <QtQml/qqmlscriptstring.h>
 
 #include <private/qqmladaptormodel_p.h>
 #include <private/qqmlopenmetaobject_p.h>
+#include <private/qqmlsortfilterindex_p.h>
 
 //
 //  W A R N I N G
@@ -118,15 +120,17 @@ public:
 
     int groupIndex(Compositor::Group group);
 
-    bool selectDelegate(QQmlDelegate *delegate, QQmlContextData *context);
-
     int modelIndex() const { return index; }
     virtual void setModelIndex(int idx) { index = idx; Q_EMIT modelIndexChanged(); }
+    // The row and column of a table model that the item reads its data from, if any
+    virtual int sourceRow() const { return -1; }
+    virtual int sourceColumn() const { return -1; }
 
     virtual QV4::ReturnedValue get() { return QV4::QObjectWrapper::wrap(v4, this); }
 
     virtual void setValue(const QString &role, const QVariant &value) { Q_UNUSED(role); Q_UNUSED(value); }
     virtual bool resolveIndex(const QQmlAdaptorModel &, int) { return false; }
+    virtual void rebindIndex(const QQmlAdaptorModel &, int idx) { setModelIndex(idx); }
 
     static void get_model(const QV4::BuiltinFunction *, QV4::Scope &scope, QV4::CallData *callData);
     static void get_groups(const QV4::BuiltinFunction *, QV4::Scope &scope, QV4::CallData *callData);
@@ -146,6 +150,7 @@ public:
     int scriptRef;
     int groups;
     int index;
+    int poolTime;
 
 Q_SIGNALS:
     void modelIndexChanged();
@@ -259,8 +264,18 @@ public:
     void connectModel(QQmlAdaptorModel *model);
 
     void requestMoreIfNecessary();
+    void requestRows(int row, int count);
     QObject *object(Compositor::Group group, int index, bool asynchronous);
-    QQmlDelegateModel::ReleaseFlags release(QObject *object);
+    QQmlDelegateModel::ReleaseFlags release(
+            QObject *object, QQmlInstanceModel::ReusableFlag reusableFlag = QQmlInstanceModel::NotReusable);
+    bool isReusable(QQmlDelegateModelItem *cacheItem) const;
+    QQmlDelegateModelItem *takeReusableItem(int modelIndex, QQmlDelegateModelItem **newItem);
+    void destroyReusableItem(QQmlDelegateModelItem *cacheItem);
+    void drainReusableItemsPool(int maxPoolTime);
+    QQmlComponent *resolveDelegate(QQmlDelegateModelItem *cacheItem) const;
+    QQmlComponent *resolveDelegate(int modelIndex, QQmlDelegateModelItem *cacheItem, bool *needsItem) const;
+    const QVector<QQmlDelegate *> &delegatesForColumn(int column) const;
+    void forgetResolvedDelegates(int index, int count);
     QString stringValue(Compositor::Group group, int index, const QString &name);
     void emitCreatedPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
     void emitInitPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
@@ -307,6 +322,20 @@ public:
 
     void setRows(int rows);
     void setColumns(int columns);
+    void modelRowsInserted(int row, int count);
+    void modelRowsRemoved(int row, int count);
+    void modelColumnsChanged();
+
+    QAbstractItemModel *sortFilterModel() const;
+    QVariant sortKey(const QAbstractItemModel *model, int row) const;
+    bool acceptsRow(const QAbstractItemModel *model, int row) const;
+    bool affectsSortFilter(const QVector<int> &roles) const;
+    void resetSortFilterIndex();
+    void sortFilterChanged();
+    void sortFilterRowsInserted(int row, int count);
+    void sortFilterRowsRemoved(int row, int count);
+    void sortFilterRowChanged(int row, int firstColumn, int lastColumn, const QVector<int> &roles);
+    void syncItemIndexes(int fromRow = 0);
 
     bool hasDelegate() const { return m_delegate || !m_delegates.isEmpty(); }
 
@@ -319,12 +348,32 @@ public:
     QQmlListCompositor m_compositor;
     QQmlComponent *m_delegate;
     QList<QQmlDelegate *> m_delegates;
+    // The delegate chosen for each model index. Cleared when items are inserted,
+    // removed or moved, and when it grows much larger than m_cache.
+    mutable QHash<int, QQmlComponent *> m_resolvedDelegates;
+    // m_delegates split up by the column they are for. Delegates for any
+    // column are included in every column, and kept in m_anyColumnDelegates.
+    mutable QVector<QVector<QQmlDelegate *> > m_columnDelegates;
+    mutable QVector<QQmlDelegate *> m_anyColumnDelegates;
+    mutable bool m_delegateTableDirty;
     QQmlDelegateModelItemMetaType *m_cacheMetaType;
     QPointer<QQmlContext> m_context;
     QQmlDelegateModelParts *m_parts;
     QQmlDelegateModelGroupEmitterList m_pendingParts;
 
+    // Maps the rows of the view to the rows of the model, when sortRole or filterRole
+    // is set. The keys to sort and filter on are read from the first column.
+    QScopedPointer<QQmlSortFilterIndex> m_sortFilterIndex;
+    QString m_sortRole;
+    QString m_filterRole;
+    QVariant m_filterValue;
+    Qt::SortOrder m_sortOrder;
+    int m_sortRoleId;
+    int m_filterRoleId;
+
     QList<QQmlDelegateModelItem *> m_cache;
+    // Released items waiting to be reused, per delegate. Empty pools are removed.
+    QHash<QQmlComponent *, QList<QQmlDelegateModelItem *> > m_reusableItemsPools;
     QList<QQDMIncubationTask *> m_finishedIncubating;
     QList<QByteArray> m_watchedRoles;
 
@@ -333,6 +382,10 @@ public:
     int m_count;
     int m_groupCount;
 
+    // The rows to fetch once the posted UpdateRequest arrives
+    int m_fetchFromRow;
+    int m_fetchToRow;
+
     QQmlListCompositor::Group m_compositorGroup;
     bool m_complete : 1;
     bool m_delegateValidated : 1;
@@ -368,7 +421,7 @@ public:
     int count() const override;
     bool isValid() const override;
     QObject *object(int index, bool asynchronous = false) override;
-    ReleaseFlags release(QObject *item) override;
+    ReleaseFlags release(QObject *item, ReusableFlag reusableFlag = NotReusable) override;
     QString stringValue(int index, const QString &role) override;
     QList<QByteArray> watchedRoles() const { return m_watchedRoles; }
     void setWatchedRoles(const QList<QByteArray> &roles) override;
@@ -406,6 +459,36 @@ public:
     QVariant initialValue(int) override;
 };
 
+class QQmlDelegateSelector;
+
+class QQmlDelegatePrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QQmlDelegate)
+public:
+    QQmlDelegatePrivate();
+    ~QQmlDelegatePrivate();
+
+    static QQmlDelegatePrivate *get(QQmlDelegate *delegate) {
+        return static_cast<QQmlDelegatePrivate *>(QObjectPrivate::get(delegate));
+    }
+
+    bool matchesCell(int modelIndex, int modelRow, int modelColumn) const;
+    bool needsItem();
+    bool matches(QQmlDelegateModelItem *item);
+    bool isCacheable() const { return cacheable || when.isEmpty() || whenLiteral != -1; }
+
+    bool complete;
+    bool validated;
+    bool cacheable;
+    int index;
+    int row;
+    int column;
+    int whenLiteral; // -1 if when is not a boolean literal
+    QQmlScriptString when;
+    QScopedPointer<QQmlDelegateSelector> selector;
+    QQmlComponent *component;
+};
+
 class QQmlDelegateModelParts : public QObject
 {
 Q_OBJECT
@@ -40,6 +40,7 @@
 #include "qqmladaptormodel_p.h"
 
 #include <private/qqmldelegatemodel_p_p.h>
+#include <private/qqmlsortfilterindex_p.h>
 #include <private/qmetaobjectbuilder_p.h>
 #include <private/qqmlproperty_p.h>
 #include <private/qv8engine_p.h>
@@ -47,6 +48,8 @@
 #include <private/qv4value_p.h>
 #include <private/qv4functionobject_p.h>
 
+#include <QtCore/qbitarray.h>
+
 QT_BEGIN_NAMESPACE
 
 class QQmlAdaptorModelEngineData : public QV8Engine::Deletable
@@ -100,16 +103,27 @@ public:
     int metaCall(QMetaObject::Call call, int id, void **arguments);
 
     virtual QVariant value(int role) const = 0;
+    // Same as value(), for the role of a property of the delegate data
+    virtual QVariant propertyValue(int propertyId) const = 0;
     virtual void setValue(int role, const QVariant &value) = 0;
 
     void setValue(const QString &role, const QVariant &value) override;
     bool resolveIndex(const QQmlAdaptorModel &model, int idx) override;
+    void rebindIndex(const QQmlAdaptorModel &model, int idx) override;
 
     static QV4::ReturnedValue get_property(QV4::CallContext *ctx, uint propertyId);
     static QV4::ReturnedValue set_property(QV4::CallContext *ctx, uint propertyId);
 
+    void invalidateRoleValues();
+    void invalidateRoleValues(const QVector<int> &propertyIds);
+
     VDMModelDelegateDataType *type;
     QVector<QVariant> cachedData;
+
+    // The values read from the model for the current index, by property id.
+    // Only valid where fetchedRoles is set.
+    mutable QVector<QVariant> roleValues;
+    mutable QBitArray fetchedRoles;
 };
 
 class VDMModelDelegateDataType
@@ -153,6 +167,7 @@ public:
             const_cast<VDMModelDelegateDataType *>(this)->watchedRoleIds = roleIds;
         }
 
+        QVector<int> propertyIds;
         QVector<int> signalIndexes;
         for (int i = 0; i < roles.count(); ++i) {
             const int role = roles.at(i);
@@ -160,20 +175,31 @@ public:
                 changed = true;
 
             int propertyId = propertyRoles.indexOf(role);
-            if (propertyId != -1)
+            if (propertyId != -1) {
+                propertyIds.append(propertyId);
                 signalIndexes.append(propertyId + signalOffset);
+            }
         }
         if (roles.isEmpty()) {
             const int propertyRolesCount = propertyRoles.count();
             signalIndexes.reserve(propertyRolesCount);
             for (int propertyId = 0; propertyId < propertyRolesCount; ++propertyId)
                 signalIndexes.append(propertyId + signalOffset);
+        } else if (propertyIds.isEmpty()) {
+            // None of the changed roles are properties of the delegate data,
+            // so the values the items hold are still good
+            return changed;
         }
 
         for (int i = 0, c = items.count();  i < c; ++i) {
             QQmlDelegateModelItem *item = items.at(i);
             const int idx = item->modelIndex();
             if (idx >= index && idx < index + count) {
+                QQmlDMCachedModelData *modelData = static_cast<QQmlDMCachedModelData *>(item);
+                if (roles.isEmpty())
+                    modelData->invalidateRoleValues();
+                else
+                    modelData->invalidateRoleValues(propertyIds);
                 for (int i = 0; i < signalIndexes.count(); ++i)
                     QMetaObject::activate(item, signalIndexes.at(i), 0);
             }
@@ -252,6 +278,10 @@ public:
     QList<int> watchedRoleIds;
     QList<QByteArray> watchedRoles;
     QHash<QByteArray, int> roleNames;
+    // The properties that delegates have read so far, by property id. When a delegate
+    // reads a role, the others in here are read together with it, since delegates
+    // mostly read the same roles.
+    QBitArray readRoles;
     QQmlAdaptorModel *model;
     QMetaObject *metaObject;
     QQmlPropertyCache *propertyCache;
@@ -287,7 +317,7 @@ int QQmlDMCachedModelData::metaCall(QMetaObject::Call call, int id, void **argum
                     type->hasModelData ? 0 : propertyIndex);
             }
         } else  if (*type->model) {
-            *static_cast<QVariant *>(arguments[0]) = value(type->propertyRoles.at(propertyIndex));
+            *static_cast<QVariant *>(arguments[0]) = propertyValue(propertyIndex);
         }
         return -1;
     } else if (call == QMetaObject::WriteProperty && id >= type->propertyOffset) {
@@ -311,6 +341,19 @@ int QQmlDMCachedModelData::metaCall(QMetaObject::Call call, int id, void **argum
     }
 }
 
+void QQmlDMCachedModelData::invalidateRoleValues()
+{
+    fetchedRoles.fill(false);
+}
+
+void QQmlDMCachedModelData::invalidateRoleValues(const QVector<int> &propertyIds)
+{
+    for (int propertyId : propertyIds) {
+        if (propertyId < fetchedRoles.size())
+            fetchedRoles.clearBit(propertyId);
+    }
+}
+
 void QQmlDMCachedModelData::setValue(const QString &role, const QVariant &value)
 {
     QHash<QByteArray, int>::iterator it = type->roleNames.find(role.toUtf8());
@@ -341,6 +384,18 @@ bool QQmlDMCachedModelData::resolveIndex(const QQmlAdaptorModel &, int idx)
     }
 }
 
+void QQmlDMCachedModelData::rebindIndex(const QQmlAdaptorModel &, int idx)
+{
+    Q_ASSERT(idx >= 0);
+    setModelIndex(idx);
+    // The role values are read from the model on demand, so just notify
+    // that all of them might have changed.
+    const QMetaObject *meta = metaObject();
+    const int propertyCount = type->propertyRoles.count();
+    for (int i = 0; i < propertyCount; ++i)
+        QMetaObject::activate(this, meta, i, 0);
+}
+
 QV4::ReturnedValue QQmlDMCachedModelData::get_property(QV4::CallContext *ctx, uint propertyId)
 {
     QV4::Scope scope(ctx);
@@ -355,8 +410,7 @@ QV4::ReturnedValue QQmlDMCachedModelData::get_property(QV4::CallContext *ctx, ui
                     modelData->cachedData.at(modelData->type->hasModelData ? 0 : propertyId));
         }
     } else if (*modelData->type->model) {
-        return scope.engine->fromVariant(
-                modelData->value(modelData->type->propertyRoles.at(propertyId)));
+        return scope.engine->fromVariant(modelData->propertyValue(propertyId));
     }
     return QV4::Encode::undefined();
 }
@@ -420,9 +474,21 @@ public:
 
     QVariant value(int role) const override
     {
-        return type->model->aim()->index(row, column, type->model->rootIndex).data(role);
+        const int propertyId = type->propertyRoles.indexOf(role);
+        if (propertyId == -1)
+            return type->model->aim()->index(row, column, type->model->rootIndex).data(role);
+        return propertyValue(propertyId);
+    }
+
+    QVariant propertyValue(int propertyId) const override
+    {
+        if (propertyId >= fetchedRoles.size() || !fetchedRoles.testBit(propertyId))
+            fetchRoleValues(propertyId);
+        return roleValues.at(propertyId);
     }
 
+    void fetchRoleValues(int propertyId) const;
+
     void setValue(int role, const QVariant &value) override
     {
         type->model->aim()->setData(
@@ -447,6 +513,9 @@ public:
     bool resolveIndex(const QQmlAdaptorModel &model, int idx) override;
     void syncIndex(int idx);
 
+    int sourceRow() const override { return row; }
+    int sourceColumn() const override { return column; }
+
 Q_SIGNALS:
     void rowChanged();
     void columnChanged();
@@ -488,6 +557,12 @@ public:
                                 vdm, SLOT(_q_dataChanged(QModelIndex,QModelIndex,QVector<int>)));
             QObject::disconnect(aim, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
                                 vdm, SLOT(_q_rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+            QObject::disconnect(aim, SIGNAL(columnsInserted(QModelIndex,int,int)),
+                                vdm, SLOT(_q_columnsInserted(QModelIndex,int,int)));
+            QObject::disconnect(aim, SIGNAL(columnsRemoved(QModelIndex,int,int)),
+                                vdm, SLOT(_q_columnsRemoved(QModelIndex,int,int)));
+            QObject::disconnect(aim, SIGNAL(columnsMoved(QModelIndex,int,int,QModelIndex,int)),
+                                vdm, SLOT(_q_columnsMoved(QModelIndex,int,int,QModelIndex,int)));
             QObject::disconnect(aim, SIGNAL(modelReset()),
                                 vdm, SLOT(_q_modelReset()));
             QObject::disconnect(aim, SIGNAL(layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)),
@@ -599,6 +674,31 @@ void QQmlDMAbstractItemModelData::syncIndex(int idx)
     VDMAbstractItemModelDataType *dataType = static_cast<VDMAbstractItemModelDataType *>(type);
     row = dataType->model->rowAt(idx);
     column = dataType->model->columnAt(idx);
+    fetchedRoles.fill(false);
+}
+
+void QQmlDMAbstractItemModelData::fetchRoleValues(int propertyId) const
+{
+    // Reads all the roles that delegates have read so far, through one model index.
+    // This saves a model index, and a call to the model, for each role after the
+    // first one that a delegate binds to. The values are kept until the model
+    // reports that they have changed, or the item gets another index.
+    const int propertyCount = type->propertyRoles.count();
+    if (fetchedRoles.size() != propertyCount) {
+        roleValues.resize(propertyCount);
+        fetchedRoles.resize(propertyCount);
+    }
+    if (type->readRoles.size() != propertyCount)
+        type->readRoles.resize(propertyCount);
+    type->readRoles.setBit(propertyId);
+
+    const QModelIndex modelIndex = type->model->aim()->index(row, column, type->model->rootIndex);
+    for (int i = 0; i < propertyCount; ++i) {
+        if (fetchedRoles.testBit(i) || !type->readRoles.testBit(i))
+            continue;
+        roleValues[i] = modelIndex.data(type->propertyRoles.at(i));
+        fetchedRoles.setBit(i);
+    }
 }
 
 //-----------------------------------------------------------------
@@ -680,6 +780,12 @@ public:
         }
     }
 
+    void rebindIndex(const QQmlAdaptorModel &model, int idx) override
+    {
+        cachedData = model.list.at(idx);
+        setModelIndex(idx);
+        emit modelDataChanged();
+    }
 
 Q_SIGNALS:
     void modelDataChanged();
@@ -947,8 +1053,30 @@ QQmlAdaptorModel::Accessors::~Accessors()
 {
 }
 
+bool QQmlAdaptorModel::Accessors::canFetchRows(const QQmlAdaptorModel &model, int row, int count) const
+{
+    // Models can only fetch more rows at the end. So unless the model overrides
+    // this, only a range that reaches past the last row can be fetched.
+    return qint64(row) + count > model.sourceRowCount() && canFetchMore(model);
+}
+
+void QQmlAdaptorModel::Accessors::fetchRows(QQmlAdaptorModel &model, int row, int count) const
+{
+    // Keep asking for more until the range is covered. A model that fetches
+    // asynchronously will not grow right away, and will insert the rows later.
+    int rowCount = model.sourceRowCount();
+    while (qint64(row) + count > rowCount && canFetchMore(model)) {
+        fetchMore(model);
+        const int newRowCount = model.sourceRowCount();
+        if (newRowCount <= rowCount)
+            break;
+        rowCount = newRowCount;
+    }
+}
+
 QQmlAdaptorModel::QQmlAdaptorModel()
     : accessors(&qt_vdm_null_accessors)
+    , sortFilterIndex(nullptr)
 {
 }
 
@@ -960,6 +1088,7 @@ QQmlAdaptorModel::~QQmlAdaptorModel()
 void QQmlAdaptorModel::setModel(const QVariant &variant, QQmlDelegateModel *vdm, QQmlEngine *engine)
 {
     accessors->cleanup(*this, vdm);
+    sortFilterIndex = nullptr;
 
     list.setList(variant, engine);
 
@@ -978,6 +1107,12 @@ void QQmlAdaptorModel::setModel(const QVariant &variant, QQmlDelegateModel *vdm,
                               vdm, QQmlDelegateModel, SLOT(_q_dataChanged(QModelIndex,QModelIndex,QVector<int>)));
             qmlobject_connect(model, QAbstractItemModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
                               vdm, QQmlDelegateModel, SLOT(_q_rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+            qmlobject_connect(model, QAbstractItemModel, SIGNAL(columnsInserted(QModelIndex,int,int)),
+                              vdm, QQmlDelegateModel, SLOT(_q_columnsInserted(QModelIndex,int,int)));
+            qmlobject_connect(model, QAbstractItemModel, SIGNAL(columnsRemoved(QModelIndex,int,int)),
+                              vdm, QQmlDelegateModel, SLOT(_q_columnsRemoved(QModelIndex,int,int)));
+            qmlobject_connect(model, QAbstractItemModel, SIGNAL(columnsMoved(QModelIndex,int,int,QModelIndex,int)),
+                              vdm, QQmlDelegateModel, SLOT(_q_columnsMoved(QModelIndex,int,int,QModelIndex,int)));
             qmlobject_connect(model, QAbstractItemModel, SIGNAL(modelReset()),
                               vdm, QQmlDelegateModel, SLOT(_q_modelReset()));
             qmlobject_connect(model, QAbstractItemModel, SIGNAL(layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)),
@@ -1002,6 +1137,7 @@ void QQmlAdaptorModel::invalidateModel(QQmlDelegateModel *vdm)
 {
     accessors->cleanup(*this, vdm);
     accessors = &qt_vdm_null_accessors;
+    sortFilterIndex = nullptr;
     // Don't clear the model object as we still need the guard to clear the list variant if the
     // object is destroyed.
 }
@@ -1018,9 +1154,28 @@ int QQmlAdaptorModel::count() const
 
 int QQmlAdaptorModel::rowCount() const
 {
-    if (rows.isValid())
-        return rows.value;
-    return accessors->rowCount(*this);
+    // Rows set by the view can only leave out rows, not bring back the ones
+    // that are filtered out
+    int count;
+    if (sortFilterIndex)
+        count = rows.isValid() ? qMin(rows.value, sortFilterIndex->count()) : sortFilterIndex->count();
+    else if (rows.isValid())
+        count = rows.value;
+    else
+        count = accessors->rowCount(*this);
+
+    // The cells of a table are addressed by a flat index, row by row. Rows
+    // with cells past the last index an int can hold are left out, so that
+    // every row that is counted can be addressed in full.
+    const int columns = columnCount();
+    return columns > 1 ? qMin(count, INT_MAX / columns) : count;
+}
+
+int QQmlAdaptorModel::sourceRowCount() const
+{
+    // The rows of the model itself, including the ones sorting and filtering
+    // leave out. Rows are fetched and inserted in these.
+    return sortFilterIndex ? accessors->rowCount(*this) : rowCount();
 }
 
 int QQmlAdaptorModel::columnCount() const
@@ -1036,7 +1191,9 @@ int QQmlAdaptorModel::columnCount() const
 int QQmlAdaptorModel::rowAt(int index) const
 {
     int count = columnCount();
-    return count <= 0 ? -1 : index / count;
+    if (count <= 0)
+        return -1;
+    return sortFilterIndex ? sortFilterIndex->sourceRow(index / count) : index / count;
 }
 
 int QQmlAdaptorModel::columnAt(int index) const
@@ -1045,6 +1202,15 @@ int QQmlAdaptorModel::columnAt(int index) const
     return count <= 0 ? -1 : index % count;
 }
 
+int QQmlAdaptorModel::indexAt(int row, int column) const
+{
+    const int count = columnCount();
+    if (row < 0 || column < 0 || column >= count)
+        return -1;
+    const qint64 index = qint64(row) * count + column;
+    return index > INT_MAX ? -1 : int(index);
+}
+
 void QQmlAdaptorModel::objectDestroyed(QObject *)
 {
     setModel(QVariant(), 0, 0);
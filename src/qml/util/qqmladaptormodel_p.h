@@ -65,6 +65,7 @@ class QQmlEngine;
 class QQmlDelegateModel;
 class QQmlDelegateModelItem;
 class QQmlDelegateModelItemMetaType;
+class QQmlSortFilterIndex;
 
 class QQmlAdaptorModel : public QQmlGuard<QObject>
 {
@@ -103,6 +104,8 @@ public:
             return QVariant(); }
         virtual bool canFetchMore(const QQmlAdaptorModel &) const { return false; }
         virtual void fetchMore(QQmlAdaptorModel &) const {}
+        virtual bool canFetchRows(const QQmlAdaptorModel &, int row, int count) const;
+        virtual void fetchRows(QQmlAdaptorModel &, int row, int count) const;
     };
 
     QQmlNullableValue<int> rows;
@@ -110,6 +113,8 @@ public:
     const Accessors *accessors;
     QPersistentModelIndex rootIndex;
     QQmlListAccessor list;
+    // When set, rows are addressed in the order of the index, rather than the model
+    const QQmlSortFilterIndex *sortFilterIndex;
 
     QQmlAdaptorModel();
     ~QQmlAdaptorModel();
@@ -121,9 +126,11 @@ public:
     bool isValid() const;
     int count() const;
     int rowCount() const;
+    int sourceRowCount() const;
     int columnCount() const;
     int rowAt(int index) const;
     int columnAt(int index) const;
+    int indexAt(int row, int column) const;
 
     inline QAbstractItemModel *aim() { return static_cast<QAbstractItemModel *>(object()); }
     inline const QAbstractItemModel *aim() const { return static_cast<const QAbstractItemModel *>(object()); }
@@ -149,6 +156,8 @@ public:
     inline QVariant parentModelIndex() const { return accessors->parentModelIndex(*this); }
     inline bool canFetchMore() const { return accessors->canFetchMore(*this); }
     inline void fetchMore() { return accessors->fetchMore(*this); }
+    inline bool canFetchRows(int row, int count) const { return accessors->canFetchRows(*this, row, count); }
+    inline void fetchRows(int row, int count) { accessors->fetchRows(*this, row, count); }
 
 protected:
     void objectDestroyed(QObject *) override;
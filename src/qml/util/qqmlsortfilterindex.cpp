@@ -0,0 +1,405 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qqmlsortfilterindex_p.h"
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+struct QQmlSortFilterIndexLink
+{
+    QQmlSortFilterIndexNode *left;
+    QQmlSortFilterIndexNode *right;
+    QQmlSortFilterIndexNode *parent;
+    int size;
+};
+
+struct QQmlSortFilterIndexNode
+{
+    QQmlSortFilterIndexLink source;
+    QQmlSortFilterIndexLink sorted;
+    QVariant key;
+    quint32 priority;
+    bool accepted;
+};
+
+typedef QQmlSortFilterIndexNode Node;
+typedef QQmlSortFilterIndexLink Link;
+
+// The treap operations below work on either tree, given the link to follow
+
+template <Link Node::*L> static inline int treeSize(const Node *node)
+{
+    return node ? (node->*L).size : 0;
+}
+
+template <Link Node::*L> static void update(Node *node)
+{
+    Link &link = node->*L;
+    link.size = 1 + treeSize<L>(link.left) + treeSize<L>(link.right);
+    if (link.left)
+        (link.left->*L).parent = node;
+    if (link.right)
+        (link.right->*L).parent = node;
+}
+
+template <Link Node::*L> static inline Node *detach(Node *node)
+{
+    if (node)
+        (node->*L).parent = nullptr;
+    return node;
+}
+
+template <Link Node::*L> static Node *merge(Node *first, Node *second)
+{
+    if (!first)
+        return second;
+    if (!second)
+        return first;
+    if (first->priority > second->priority) {
+        (first->*L).right = merge<L>((first->*L).right, second);
+        update<L>(first);
+        return first;
+    }
+    (second->*L).left = merge<L>(first, (second->*L).left);
+    update<L>(second);
+    return second;
+}
+
+// Splits the first count nodes off into first, and the rest into second
+template <Link Node::*L> static void splitAt(Node *node, int count, Node **first, Node **second)
+{
+    if (!node) {
+        *first = *second = nullptr;
+        return;
+    }
+    Link &link = node->*L;
+    const int leftSize = treeSize<L>(link.left);
+    if (count <= leftSize) {
+        splitAt<L>(link.left, count, first, &link.left);
+        update<L>(node);
+        *second = node;
+    } else {
+        splitAt<L>(link.right, count - leftSize - 1, &link.right, second);
+        update<L>(node);
+        *first = node;
+    }
+}
+
+template <Link Node::*L> static Node *nodeAt(Node *node, int index)
+{
+    while (node) {
+        const int leftSize = treeSize<L>((node->*L).left);
+        if (index < leftSize) {
+            node = (node->*L).left;
+        } else if (index == leftSize) {
+            return node;
+        } else {
+            index -= leftSize + 1;
+            node = (node->*L).right;
+        }
+    }
+    return nullptr;
+}
+
+template <Link Node::*L> static int rankOf(const Node *node)
+{
+    int rank = treeSize<L>((node->*L).left);
+    for (const Node *parent = (node->*L).parent; parent; node = parent, parent = (node->*L).parent) {
+        if ((parent->*L).right == node)
+            rank += treeSize<L>((parent->*L).left) + 1;
+    }
+    return rank;
+}
+
+template <Link Node::*L> static void collect(Node *node, QVector<Node *> *nodes)
+{
+    if (!node)
+        return;
+    collect<L>((node->*L).left, nodes);
+    nodes->append(node);
+    collect<L>((node->*L).right, nodes);
+}
+
+static Node *buildTree(const QVector<Node *> &nodes)
+{
+    Node *root = nullptr;
+    for (Node *node : nodes)
+        root = merge<&Node::source>(root, node);
+    return detach<&Node::source>(root);
+}
+
+QQmlSortFilterIndex::QQmlSortFilterIndex()
+    : m_sourceRoot(nullptr)
+    , m_sortedRoot(nullptr)
+    , m_sortOrder(Qt::AscendingOrder)
+    , m_seed(0x9e3779b9)
+{
+}
+
+QQmlSortFilterIndex::~QQmlSortFilterIndex()
+{
+    clear();
+}
+
+void QQmlSortFilterIndex::setSortOrder(Qt::SortOrder order)
+{
+    if (m_sortOrder == order)
+        return;
+    m_sortOrder = order;
+    rebuildSorted();
+}
+
+int QQmlSortFilterIndex::count() const
+{
+    return treeSize<&Node::sorted>(m_sortedRoot);
+}
+
+int QQmlSortFilterIndex::sourceCount() const
+{
+    return treeSize<&Node::source>(m_sourceRoot);
+}
+
+int QQmlSortFilterIndex::sourceRow(int viewRow) const
+{
+    const Node *node = nodeAt<&Node::sorted>(m_sortedRoot, viewRow);
+    return node && viewRow >= 0 ? rankOf<&Node::source>(node) : -1;
+}
+
+int QQmlSortFilterIndex::viewRow(int sourceRow) const
+{
+    const Node *node = nodeAt<&Node::source>(m_sourceRoot, sourceRow);
+    return node && sourceRow >= 0 && node->accepted ? rankOf<&Node::sorted>(node) : -1;
+}
+
+void QQmlSortFilterIndex::reset(const QVector<QVariant> &keys, const QVector<bool> &accepted)
+{
+    Q_ASSERT(keys.count() == accepted.count());
+    clear();
+
+    QVector<Node *> nodes;
+    nodes.reserve(keys.count());
+    for (int i = 0; i < keys.count(); ++i)
+        nodes.append(createNode(keys.at(i), accepted.at(i)));
+    m_sourceRoot = buildTree(nodes);
+    rebuildSorted();
+}
+
+void QQmlSortFilterIndex::clear()
+{
+    QVector<Node *> nodes;
+    collect<&Node::source>(m_sourceRoot, &nodes);
+    qDeleteAll(nodes);
+    m_sourceRoot = nullptr;
+    m_sortedRoot = nullptr;
+}
+
+QVector<int> QQmlSortFilterIndex::insertSourceRows(int sourceRow, const QVector<QVariant> &keys, const QVector<bool> &accepted)
+{
+    Q_ASSERT(keys.count() == accepted.count());
+    Q_ASSERT(sourceRow >= 0 && sourceRow <= sourceCount());
+
+    QVector<Node *> nodes;
+    nodes.reserve(keys.count());
+    for (int i = 0; i < keys.count(); ++i)
+        nodes.append(createNode(keys.at(i), accepted.at(i)));
+
+    Node *first;
+    Node *second;
+    splitAt<&Node::source>(m_sourceRoot, sourceRow, &first, &second);
+    m_sourceRoot = merge<&Node::source>(merge<&Node::source>(first, buildTree(nodes)), second);
+    detach<&Node::source>(m_sourceRoot);
+
+    // The nodes need to be in the source tree first, since equal keys
+    // are ordered by source row
+    QVector<int> viewRows;
+    for (Node *node : qAsConst(nodes)) {
+        if (node->accepted)
+            insertSorted(node);
+    }
+    for (Node *node : qAsConst(nodes)) {
+        if (node->accepted)
+            viewRows.append(rankOf<&Node::sorted>(node));
+    }
+    std::sort(viewRows.begin(), viewRows.end());
+    return viewRows;
+}
+
+QVector<int> QQmlSortFilterIndex::removeSourceRows(int sourceRow, int count)
+{
+    Q_ASSERT(sourceRow >= 0 && count >= 0 && sourceRow + count <= sourceCount());
+
+    Node *first;
+    Node *rest;
+    Node *removed;
+    Node *second;
+    splitAt<&Node::source>(m_sourceRoot, sourceRow, &first, &rest);
+    splitAt<&Node::source>(rest, count, &removed, &second);
+    m_sourceRoot = detach<&Node::source>(merge<&Node::source>(first, second));
+
+    QVector<Node *> nodes;
+    collect<&Node::source>(removed, &nodes);
+
+    QVector<int> viewRows;
+    for (Node *node : qAsConst(nodes)) {
+        if (node->accepted)
+            viewRows.append(rankOf<&Node::sorted>(node));
+    }
+    for (Node *node : qAsConst(nodes)) {
+        if (node->accepted)
+            removeSorted(node);
+    }
+    qDeleteAll(nodes);
+
+    std::sort(viewRows.begin(), viewRows.end(), std::greater<int>());
+    return viewRows;
+}
+
+void QQmlSortFilterIndex::changeSourceRow(int sourceRow, const QVariant &key, bool accepted, int *fromViewRow, int *toViewRow)
+{
+    // Reports the view row of the source row before and after the change,
+    // where -1 means that the row is not accepted by the filter
+    Node *node = nodeAt<&Node::source>(m_sourceRoot, sourceRow);
+    if (!node || sourceRow < 0) {
+        *fromViewRow = *toViewRow = -1;
+        return;
+    }
+
+    *fromViewRow = node->accepted ? rankOf<&Node::sorted>(node) : -1;
+    if (node->accepted)
+        removeSorted(node);
+    node->key = key;
+    node->accepted = accepted;
+    if (node->accepted)
+        insertSorted(node);
+    *toViewRow = node->accepted ? rankOf<&Node::sorted>(node) : -1;
+}
+
+Node *QQmlSortFilterIndex::createNode(const QVariant &key, bool accepted)
+{
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node *node = new Node;
+    node->source = { nullptr, nullptr, nullptr, 1 };
+    node->sorted = { nullptr, nullptr, nullptr, 1 };
+    node->key = key;
+    node->priority = m_seed;
+    node->accepted = accepted;
+    return node;
+}
+
+bool QQmlSortFilterIndex::lessThan(const Node *a, const Node *b) const
+{
+    const QVariant &first = m_sortOrder == Qt::AscendingOrder ? a->key : b->key;
+    const QVariant &second = m_sortOrder == Qt::AscendingOrder ? b->key : a->key;
+    if (first < second)
+        return true;
+    if (second < first)
+        return false;
+    return rankOf<&Node::source>(a) < rankOf<&Node::source>(b);
+}
+
+// Splits the sorted tree into the nodes that go before the given one, and the rest
+void QQmlSortFilterIndex::splitBefore(Node *node, const Node *before, Node **first, Node **second) const
+{
+    if (!node) {
+        *first = *second = nullptr;
+        return;
+    }
+    if (lessThan(node, before)) {
+        splitBefore(node->sorted.right, before, &node->sorted.right, second);
+        update<&Node::sorted>(node);
+        *first = node;
+    } else {
+        splitBefore(node->sorted.left, before, first, &node->sorted.left);
+        update<&Node::sorted>(node);
+        *second = node;
+    }
+}
+
+void QQmlSortFilterIndex::insertSorted(Node *node)
+{
+    Node *first;
+    Node *second;
+    splitBefore(m_sortedRoot, node, &first, &second);
+    node->sorted = { nullptr, nullptr, nullptr, 1 };
+    m_sortedRoot = merge<&Node::sorted>(merge<&Node::sorted>(first, node), second);
+    detach<&Node::sorted>(m_sortedRoot);
+}
+
+void QQmlSortFilterIndex::removeSorted(Node *node)
+{
+    Node *first;
+    Node *rest;
+    Node *removed;
+    Node *second;
+    splitAt<&Node::sorted>(m_sortedRoot, rankOf<&Node::sorted>(node), &first, &rest);
+    splitAt<&Node::sorted>(rest, 1, &removed, &second);
+    Q_ASSERT(removed == node);
+    m_sortedRoot = detach<&Node::sorted>(merge<&Node::sorted>(first, second));
+}
+
+void QQmlSortFilterIndex::rebuildSorted()
+{
+    // A stable sort of the accepted rows, in source order, keeps
+    // rows with equal keys in source order as well
+    QVector<Node *> nodes;
+    collect<&Node::source>(m_sourceRoot, &nodes);
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const Node *node) {
+        return !node->accepted;
+    }), nodes.end());
+
+    const bool ascending = m_sortOrder == Qt::AscendingOrder;
+    std::stable_sort(nodes.begin(), nodes.end(), [ascending](const Node *a, const Node *b) {
+        return ascending ? a->key < b->key : b->key < a->key;
+    });
+
+    m_sortedRoot = nullptr;
+    for (Node *node : qAsConst(nodes)) {
+        node->sorted = { nullptr, nullptr, nullptr, 1 };
+        m_sortedRoot = merge<&Node::sorted>(m_sortedRoot, node);
+    }
+    detach<&Node::sorted>(m_sortedRoot);
+}
+
+QT_END_NAMESPACE
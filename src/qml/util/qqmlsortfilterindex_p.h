@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQMLSORTFILTERINDEX_P_H
+#define QQMLSORTFILTERINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+#include <QtQml/private/qtqmlglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QQmlSortFilterIndexNode;
+
+// Maps the rows of a source model to the rows of a sorted and filtered view
+// of it, and back. Each source row has a sort key, and is either accepted by
+// the filter or not. The accepted rows are ordered by their key, and rows
+// with equal keys keep their source order.
+//
+// The rows are kept in two treaps (randomized balanced search trees) that
+// share their nodes: one in source order, and one with the accepted rows in
+// view order. Both keep the size of each subtree, so that the node at a row,
+// and the row of a node, can be found in O(log n). This way, inserting,
+// removing or changing a source row is O(log n) as well (O(log^2 n) for
+// sorted inserts, since keys that compare equal fall back to the source row),
+// rather than O(n) for keeping a sorted vector of rows up to date.
+//
+// The functions that change the index report which view rows changed, so that
+// they can be turned into change sets for the view. Inserted rows are reported
+// with their final view rows in ascending order, so that they can be inserted
+// one after the other. Removed rows are reported with their view rows before
+// the removal, in descending order, for the same reason.
+class Q_QML_PRIVATE_EXPORT QQmlSortFilterIndex
+{
+public:
+    QQmlSortFilterIndex();
+    ~QQmlSortFilterIndex();
+
+    Qt::SortOrder sortOrder() const { return m_sortOrder; }
+    void setSortOrder(Qt::SortOrder order);
+
+    int count() const;
+    int sourceCount() const;
+
+    int sourceRow(int viewRow) const;
+    int viewRow(int sourceRow) const;
+
+    void reset(const QVector<QVariant> &keys, const QVector<bool> &accepted);
+    void clear();
+
+    QVector<int> insertSourceRows(int sourceRow, const QVector<QVariant> &keys, const QVector<bool> &accepted);
+    QVector<int> removeSourceRows(int sourceRow, int count);
+    void changeSourceRow(int sourceRow, const QVariant &key, bool accepted, int *fromViewRow, int *toViewRow);
+
+private:
+    typedef QQmlSortFilterIndexNode Node;
+
+    Node *createNode(const QVariant &key, bool accepted);
+    bool lessThan(const Node *a, const Node *b) const;
+    void splitBefore(Node *node, const Node *before, Node **first, Node **second) const;
+    void insertSorted(Node *node);
+    void removeSorted(Node *node);
+    void rebuildSorted();
+
+    Node *m_sourceRoot;
+    Node *m_sortedRoot;
+    Qt::SortOrder m_sortOrder;
+    quint32 m_seed;
+
+    Q_DISABLE_COPY(QQmlSortFilterIndex)
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLSORTFILTERINDEX_P_H
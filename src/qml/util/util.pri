@@ -3,6 +3,7 @@ SOURCES += \
     $$PWD/qqmllistaccessor.cpp \
     $$PWD/qqmllistcompositor.cpp \
     $$PWD/qqmladaptormodel.cpp \
+    $$PWD/qqmlsortfilterindex.cpp \
     $$PWD/qqmlpropertymap.cpp
 
 HEADERS += \
@@ -10,4 +11,5 @@ HEADERS += \
     $$PWD/qqmllistaccessor_p.h \
     $$PWD/qqmllistcompositor_p.h \
     $$PWD/qqmladaptormodel_p.h \
+    $$PWD/qqmlsortfilterindex_p.h \
     $$PWD/qqmlpropertymap.h
@@ -74,6 +74,17 @@ void QQmlProfilerClient::sendRecordingStatus(bool record, int engineId, quint32
     sendMessage(stream.data());
 }
 
+// The service collects the garbage, and sends the objects left on the heap with the next data.
+// This doesn't change whether it's recording.
+void QQmlProfilerClient::sendHeapSnapshotRequest(int engineId)
+{
+    Q_D(const QQmlProfilerClient);
+
+    QPacket stream(d->connection->currentDataStreamVersion());
+    stream << true << engineId << d->features << quint32(0) << true << true;
+    sendMessage(stream.data());
+}
+
 void QQmlProfilerClient::traceStarted(qint64 time, int engineId)
 {
     Q_UNUSED(time);
@@ -137,6 +148,35 @@ void QQmlProfilerClient::sceneGraphEvent(QQmlProfilerDefinitions::SceneGraphFram
     Q_UNUSED(numericData5);
 }
 
+void QQmlProfilerClient::itemViewEvent(QQmlProfilerDefinitions::ItemViewFrameType type,
+                                       qint64 time, qint64 numericData1, qint64 numericData2,
+                                       qint64 numericData3, qint64 numericData4,
+                                       qint64 numericData5)
+{
+    Q_UNUSED(type);
+    Q_UNUSED(time);
+    Q_UNUSED(numericData1);
+    Q_UNUSED(numericData2);
+    Q_UNUSED(numericData3);
+    Q_UNUSED(numericData4);
+    Q_UNUSED(numericData5);
+}
+
+void QQmlProfilerClient::garbageCollectionEvent(
+        QQmlProfilerDefinitions::GarbageCollectionType type, qint64 time,
+        const QString &objectType, qint64 numericData1, qint64 numericData2,
+        qint64 numericData3, qint64 numericData4, qint64 numericData5)
+{
+    Q_UNUSED(type);
+    Q_UNUSED(time);
+    Q_UNUSED(objectType);
+    Q_UNUSED(numericData1);
+    Q_UNUSED(numericData2);
+    Q_UNUSED(numericData3);
+    Q_UNUSED(numericData4);
+    Q_UNUSED(numericData5);
+}
+
 void QQmlProfilerClient::pixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type,
                                           qint64 time, const QString &url, int numericData1,
                                           int numericData2)
@@ -296,6 +336,44 @@ void QQmlProfilerClient::messageReceived(const QByteArray &data)
 
         sceneGraphEvent(static_cast<QQmlProfilerDefinitions::SceneGraphFrameType>(type), time,
                         params[0], params[1], params[2], params[3], params[4]);
+    } else if (messageType == QQmlProfilerDefinitions::ItemViewFrame) {
+        if (!(d->features & one << QQmlProfilerDefinitions::ProfileItemViews))
+            return;
+
+        int type;
+        int count = 0;
+        qint64 params[5];
+
+        stream >> type;
+        while (!stream.atEnd() && count < 5)
+            stream >> params[count++];
+
+        while (count < 5)
+            params[count++] = 0;
+
+        itemViewEvent(static_cast<QQmlProfilerDefinitions::ItemViewFrameType>(type), time,
+                      params[0], params[1], params[2], params[3], params[4]);
+    } else if (messageType == QQmlProfilerDefinitions::GarbageCollection) {
+        if (!(d->features & one << QQmlProfilerDefinitions::ProfileGarbageCollection))
+            return;
+
+        int type;
+        int count = 0;
+        qint64 params[5];
+        QString objectType;
+
+        stream >> type;
+        if (type == QV4::Profiling::HeapSnapshotObjects)
+            stream >> objectType;
+        while (!stream.atEnd() && count < 5)
+            stream >> params[count++];
+
+        while (count < 5)
+            params[count++] = 0;
+
+        garbageCollectionEvent(static_cast<QQmlProfilerDefinitions::GarbageCollectionType>(type),
+                               time, objectType, params[0], params[1], params[2], params[3],
+                               params[4]);
     } else if (messageType == QQmlProfilerDefinitions::PixmapCacheEvent) {
         if (!(d->features & one << QQmlProfilerDefinitions::ProfilePixmapCache))
             return;
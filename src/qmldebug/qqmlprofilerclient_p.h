@@ -68,6 +68,7 @@ public:
     QQmlProfilerClient(QQmlDebugConnection *connection);
     void setFeatures(quint64 features);
     void sendRecordingStatus(bool record, int engineId = -1, quint32 flushInterval = 0);
+    void sendHeapSnapshotRequest(int engineId = -1);
 
 protected:
     QQmlProfilerClient(QQmlProfilerClientPrivate &dd);
@@ -91,6 +92,16 @@ private:
                                  qint64 numericData1, qint64 numericData2, qint64 numericData3,
                                  qint64 numericData4, qint64 numericData5);
 
+    virtual void itemViewEvent(QQmlProfilerDefinitions::ItemViewFrameType type, qint64 time,
+                               qint64 numericData1, qint64 numericData2, qint64 numericData3,
+                               qint64 numericData4, qint64 numericData5);
+
+    virtual void garbageCollectionEvent(QQmlProfilerDefinitions::GarbageCollectionType type,
+                                        qint64 time, const QString &objectType,
+                                        qint64 numericData1, qint64 numericData2,
+                                        qint64 numericData3, qint64 numericData4,
+                                        qint64 numericData5);
+
     virtual void pixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type, qint64 time,
                                   const QString &url, int numericData1, int numericData2);
 
@@ -966,7 +966,7 @@ static QV4::ReturnedValue qt_create_image_data(qreal w, qreal h, QV4::ExecutionE
     }
 
     QV4::Scoped<QQuickJSContext2DImageData> imageData(scope, scope.engine->memoryManager->allocObject<QQuickJSContext2DImageData>());
-    imageData->d()->pixelData = pixelData.asReturnedValue();
+    QV4::WriteBarrier::write(v4, imageData->d(), &imageData->d()->pixelData, pixelData->d());
     return imageData.asReturnedValue();
 }
 
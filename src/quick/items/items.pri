@@ -220,8 +220,14 @@ qtConfig(quick-sprite) {
 
 qtConfig(quick-tableview) {
     HEADERS += \
+        $$PWD/qquicktablecellgrid_p.h \
+        $$PWD/qquicktablesectionsizes_p.h \
+        $$PWD/qquicktablespans_p.h \
         $$PWD/qquicktableview_p.h
     SOURCES += \
+        $$PWD/qquicktablecellgrid.cpp \
+        $$PWD/qquicktablesectionsizes.cpp \
+        $$PWD/qquicktablespans.cpp \
         $$PWD/qquicktableview.cpp
 }
 
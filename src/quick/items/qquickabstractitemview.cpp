@@ -41,10 +41,12 @@
 #include "qquickabstractitemview_p_p.h"
 
 #include <QtCore/private/qdebug_p.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtQml/private/qqmlglobal_p.h>
 #include <QtQml/qqmlcontext.h>
 #include <QtQml/private/qqmldelegatemodel_p.h>
 #include <QtQml/qqmlinfo.h>
+#include <QtQuick/private/qquickprofiler_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,6 +55,40 @@ QT_BEGIN_NAMESPACE
 #define QML_VIEW_DEFAULTCACHEBUFFER 320
 #endif
 
+// Number of refills a released delegate item is kept in the
+// model's reuse pool before it is destroyed (see reuseItems).
+#ifndef QML_VIEW_MAXPOOLTIME
+#define QML_VIEW_MAXPOOLTIME 2
+#endif
+
+// Adds the time spent in its scope to \a total while the item views are being profiled
+class QQuickItemViewProfilingTimer
+{
+public:
+    QQuickItemViewProfilingTimer(qint64 *total)
+        : m_total(0)
+    {
+#ifndef QT_NO_QML_DEBUGGER
+        if (QQuickProfiler::featuresEnabled & (quint64(1) << QQuickProfiler::ProfileItemViews)) {
+            m_total = total;
+            m_timer.start();
+        }
+#else
+        Q_UNUSED(total);
+#endif
+    }
+
+    ~QQuickItemViewProfilingTimer()
+    {
+        if (m_total)
+            *m_total += m_timer.nsecsElapsed();
+    }
+
+private:
+    qint64 *m_total;
+    QElapsedTimer m_timer;
+};
+
 FxViewItem::FxViewItem(QQuickItem *i, QQuickAbstractItemView *v, bool own, QQuickItemViewAttached *attached)
     : item(i)
     , view(v)
@@ -303,7 +339,8 @@ QQuickAbstractItemViewPrivate::QQuickAbstractItemViewPrivate()
       fillCacheBuffer(false),
       inRequest(false),
       runDelayedRemoveTransition(false),
-      delegateValidated(false)
+      delegateValidated(false),
+      reuseItems(false)
 {
     bufferPause.addAnimationChangeListener(this, QAbstractAnimationJob::Completion);
     bufferPause.setLoopCount(1);
@@ -527,6 +564,12 @@ void QQuickAbstractItemViewPrivate::refill()
         updateViewport();
     }
 
+    // Items that were released during this refill, and not picked up again
+    // by the items that were created, are left in the pool for a little
+    // while in case the view moves back. Destroy the ones that have expired.
+    if (reuseItems && model)
+        model->drainReusableItemsPool(QML_VIEW_MAXPOOLTIME);
+
     if (prevCount != itemCount)
         emit q->countChanged();
 }
@@ -576,6 +619,7 @@ void QQuickAbstractItemViewPrivate::mirrorChange()
 FxViewItem *QQuickAbstractItemViewPrivate::createItem(int modelIndex, bool asynchronous)
 {
     Q_Q(QQuickAbstractItemView);
+    QQuickItemViewProfilingTimer profilingTimer(&delegateCounters.createTime);
 
     if (requestedIndex == modelIndex && asynchronous)
         return 0;
@@ -615,7 +659,16 @@ FxViewItem *QQuickAbstractItemViewPrivate::createItem(int modelIndex, bool async
             // do other set up for the new item that should not happen
             // until after bindings are evaluated
             initializeViewItem(viewItem);
-            unrequestedItems.remove(item);
+            const bool wasUnrequested = unrequestedItems.remove(item);
+            if (pooledItems.remove(item)) {
+                // The model handed us a previously pooled item rebound to the new index
+                QQuickItemPrivate::get(item)->setCulled(false);
+                if (viewItem->attached)
+                    viewItem->attached->emitReused();
+                ++delegateCounters.reused;
+            } else if (!wasUnrequested) {
+                ++delegateCounters.created;
+            }
         }
         inRequest = false;
         return viewItem;
@@ -630,13 +683,24 @@ bool QQuickAbstractItemViewPrivate::releaseItem(FxViewItem *item)
     if (trackedItem == item)
         trackedItem = 0;
     item->trackGeometry(false);
+    QQuickItemViewProfilingTimer profilingTimer(&delegateCounters.releaseTime);
+    ++delegateCounters.released;
 
-    QQmlInstanceModel::ReleaseFlags flags = model->release(item->item);
+    const QQmlInstanceModel::ReusableFlag reusableFlag = reuseItems
+            ? QQmlInstanceModel::Reusable : QQmlInstanceModel::NotReusable;
+    QQmlInstanceModel::ReleaseFlags flags = model->release(item->item, reusableFlag);
     if (item->item) {
         if (flags == 0) {
             // item was not destroyed, and we no longer reference it.
             QQuickItemPrivate::get(item->item)->setCulled(true);
             unrequestedItems.insert(item->item, model->indexOf(item->item, q));
+        } else if (flags & QQmlInstanceModel::Pooled) {
+            // item was moved to the model's reuse pool. Keep it parented to
+            // the view, but hidden, until it is either reused or destroyed.
+            QQuickItemPrivate::get(item->item)->setCulled(true);
+            pooledItems.insert(item->item);
+            if (item->attached)
+                item->attached->emitPooled();
         } else if (flags & QQmlInstanceModel::Destroyed) {
             item->item->setParentItem(0);
         }
@@ -645,6 +709,18 @@ bool QQuickAbstractItemViewPrivate::releaseItem(FxViewItem *item)
     return flags != QQmlInstanceModel::Referenced;
 }
 
+void QQuickAbstractItemViewPrivate::reportDelegateCounters()
+{
+    if (delegateCounters.isEmpty())
+        return;
+
+    Q_QUICK_PROFILE(QQuickProfiler::ProfileItemViews, itemViewFrame(
+            delegateCounters.created, delegateCounters.incubated, delegateCounters.released,
+            delegateCounters.destroyed, delegateCounters.reused,
+            delegateCounters.createTime, delegateCounters.releaseTime));
+    delegateCounters.reset();
+}
+
 QQuickItem *QQuickAbstractItemViewPrivate::createHighlightItem() const
 {
     return createComponentItem(highlightComponent, 0.0, true);
@@ -1131,6 +1207,24 @@ void QQuickAbstractItemView::setCacheBuffer(int b)
     }
 }
 
+bool QQuickAbstractItemView::reuseItems() const
+{
+    Q_D(const QQuickAbstractItemView);
+    return d->reuseItems;
+}
+
+void QQuickAbstractItemView::setReuseItems(bool reuse)
+{
+    Q_D(QQuickAbstractItemView);
+    if (d->reuseItems == reuse)
+        return;
+
+    d->reuseItems = reuse;
+    if (!reuse && d->model)
+        d->model->drainReusableItemsPool(0);
+    emit reuseItemsChanged();
+}
+
 bool QQuickAbstractItemView::isWrapEnabled() const
 {
     Q_D(const QQuickAbstractItemView);
@@ -1516,9 +1610,9 @@ void QQuickAbstractItemView::positionViewAtEnd()
     d->positionViewAtIndex(d->model->count(), End);
 }
 
-static FxViewItem *fxViewItemAtPosition(const QList<FxViewItem *> &items, qreal x, qreal y)
+FxViewItem *QQuickAbstractItemViewPrivate::visibleItemAtPosition(qreal x, qreal y) const
 {
-    for (FxViewItem *item : items) {
+    for (FxViewItem *item : visibleItems) {
         if (item->contains(x, y))
             return item;
     }
@@ -1528,20 +1622,21 @@ static FxViewItem *fxViewItemAtPosition(const QList<FxViewItem *> &items, qreal
 int QQuickAbstractItemView::indexAt(qreal x, qreal y) const
 {
     Q_D(const QQuickAbstractItemView);
-    const FxViewItem *item = fxViewItemAtPosition(d->visibleItems, x, y);
+    const FxViewItem *item = d->visibleItemAtPosition(x, y);
     return item ? item->index : -1;
 }
 
 QQuickItem *QQuickAbstractItemView::itemAt(qreal x, qreal y) const
 {
     Q_D(const QQuickAbstractItemView);
-    const FxViewItem *item = fxViewItemAtPosition(d->visibleItems, x, y);
+    const FxViewItem *item = d->visibleItemAtPosition(x, y);
     return item ? item->item : nullptr;
 }
 
 void QQuickAbstractItemView::forceLayout()
 {
     Q_D(QQuickAbstractItemView);
+    d->invalidateLayout();
     if (isComponentComplete() && (d->currentChanges.hasPendingChanges() || d->forceLayout))
         d->layout();
 }
@@ -1567,6 +1662,7 @@ void QQuickAbstractItemView::updatePolish()
     Q_D(QQuickAbstractItemView);
     QQuickFlickable::updatePolish();
     d->layout();
+    d->reportDelegateCounters();
 }
 
 void QQuickAbstractItemView::componentComplete()
@@ -1643,6 +1739,8 @@ void QQuickAbstractItemView::createdItem(int index, QObject* object)
 
     QQuickItem* item = qmlobject_cast<QQuickItem*>(object);
     if (!d->inRequest) {
+        // The item finished incubating asynchronously
+        ++d->delegateCounters.incubated;
         d->unrequestedItems.insert(item, index);
         d->requestedIndex = -1;
         if (d->hasPendingChanges())
@@ -1707,6 +1805,8 @@ void QQuickAbstractItemView::destroyingItem(QObject *object)
     if (item) {
         item->setParentItem(0);
         d->unrequestedItems.remove(item);
+        d->pooledItems.remove(item);
+        ++d->delegateCounters.destroyed;
     }
 }
 
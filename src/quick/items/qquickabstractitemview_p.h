@@ -82,6 +82,7 @@ class Q_QUICK_PRIVATE_EXPORT QQuickAbstractItemView : public QQuickFlickable
     Q_PROPERTY(bool keyNavigationWraps READ isWrapEnabled WRITE setWrapEnabled NOTIFY keyNavigationWrapsChanged)
     Q_PROPERTY(bool keyNavigationEnabled READ isKeyNavigationEnabled WRITE setKeyNavigationEnabled NOTIFY keyNavigationEnabledChanged REVISION 7)
     Q_PROPERTY(int cacheBuffer READ cacheBuffer WRITE setCacheBuffer NOTIFY cacheBufferChanged)
+    Q_PROPERTY(bool reuseItems READ reuseItems WRITE setReuseItems NOTIFY reuseItemsChanged REVISION 10)
 
     Q_PROPERTY(Qt::LayoutDirection layoutDirection READ layoutDirection WRITE setLayoutDirection NOTIFY layoutDirectionChanged)
     Q_PROPERTY(Qt::LayoutDirection effectiveLayoutDirection READ effectiveLayoutDirection NOTIFY effectiveLayoutDirectionChanged)
@@ -148,6 +149,9 @@ public:
     int cacheBuffer() const;
     void setCacheBuffer(int);
 
+    bool reuseItems() const;
+    void setReuseItems(bool reuse);
+
     Qt::LayoutDirection layoutDirection() const;
     void setLayoutDirection(Qt::LayoutDirection);
     Qt::LayoutDirection effectiveLayoutDirection() const;
@@ -228,6 +232,7 @@ Q_SIGNALS:
     void keyNavigationWrapsChanged();
     Q_REVISION(7) void keyNavigationEnabledChanged();
     void cacheBufferChanged();
+    Q_REVISION(10) void reuseItemsChanged();
 
     void layoutDirectionChanged();
     void effectiveLayoutDirectionChanged();
@@ -352,6 +357,8 @@ public:
 
     void emitAdd() { Q_EMIT add(); }
     void emitRemove() { Q_EMIT remove(); }
+    void emitPooled() { Q_EMIT pooled(); }
+    void emitReused() { Q_EMIT reused(); }
 
 Q_SIGNALS:
     void viewChanged();
@@ -360,6 +367,8 @@ Q_SIGNALS:
 
     void add();
     void remove();
+    void pooled();
+    void reused();
 
     void sectionChanged();
     void prevSectionChanged();
@@ -62,6 +62,8 @@ QT_REQUIRE_CONFIG(quick_itemview);
 #include <QtQml/private/qqmlchangeset_p.h>
 #include <QtQml/private/qqmlobjectmodel_p.h>
 
+#include <QtCore/qset.h>
+
 QT_BEGIN_NAMESPACE
 
 class Q_AUTOTEST_EXPORT FxViewItem
@@ -143,7 +145,8 @@ public:
     bool isValid() const;
     int findFirstVisibleIndex(int defaultValue = -1) const;
     int findLastVisibleIndex(int defaultValue = -1) const;
-    FxViewItem *visibleItem(int modelIndex) const;
+    virtual FxViewItem *visibleItem(int modelIndex) const;
+    virtual FxViewItem *visibleItemAtPosition(qreal x, qreal y) const;
 
     virtual void init();
     virtual void clear();
@@ -162,6 +165,7 @@ public:
 
     FxViewItem *createItem(int modelIndex, bool asynchronous = false);
     virtual bool releaseItem(FxViewItem *item);
+    void reportDelegateCounters();
 
     QQuickItem *createHighlightItem() const;
     QQuickItem *createComponentItem(QQmlComponent *component, qreal zValue, bool createDefault = false) const;
@@ -241,6 +245,25 @@ public:
     FxViewItem *currentItem;
     FxViewItem *trackedItem;
     QHash<QQuickItem*,int> unrequestedItems;
+    QSet<QQuickItem *> pooledItems;
+
+    // What happened to the delegate items since the last polish. Reported to the profiler.
+    struct DelegateCounters {
+        DelegateCounters() { reset(); }
+        void reset() {
+            created = incubated = released = destroyed = reused = 0;
+            createTime = releaseTime = 0;
+        }
+        bool isEmpty() const { return !(created | incubated | released | destroyed | reused); }
+
+        int created;
+        int incubated;
+        int released;
+        int destroyed;
+        int reused;
+        qint64 createTime;
+        qint64 releaseTime;
+    } delegateCounters;
     int requestedIndex;
     QQuickItemViewChangeSet currentChanges;
     QQuickItemViewChangeSet bufferedChanges;
@@ -272,6 +295,7 @@ public:
     bool inRequest : 1;
     bool runDelayedRemoveTransition : 1;
     bool delegateValidated : 1;
+    bool reuseItems : 1;
 
 protected:
     virtual Qt::Orientation layoutOrientation() const = 0;
@@ -292,6 +316,10 @@ protected:
     virtual void layoutVisibleItems(int fromModelIndex = 0) = 0;
     virtual void changedVisibleIndex(int newIndex) = 0;
 
+    // Called from forceLayout(), before the layout is done. Views that cache
+    // geometry that the application might have changed can drop it here.
+    virtual void invalidateLayout() {}
+
     virtual bool needsRefillForAddedOrRemovedIndex(int) const { return false; }
     virtual void translateAndTransitionFilledItems() = 0;
 
@@ -400,6 +400,7 @@ static void qt_quickitems_defineModule(const char *uri, int major, int minor)
 
     qmlRegisterType<QQuickFlickable, 10>(uri, 2, 10, "Flickable");
 #if QT_CONFIG(quick_itemview)
+    qmlRegisterRevision<QQuickAbstractItemView, 10>(uri, 2, 10);
     qmlRegisterUncreatableType<QQuickItemView, 10>(uri, 2, 10, "ItemView", QQuickItemView::tr("ItemView is an abstract base class"));
 #endif
 #if QT_CONFIG(quick_tableview)
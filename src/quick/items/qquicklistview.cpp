@@ -1948,6 +1948,34 @@ QQuickListView::~QQuickListView()
     The corresponding handler is \c onRemove.
 */
 
+/*!
+    \qmlattachedsignal QtQuick::ListView::pooled()
+    \since 5.10
+    This attached signal is emitted after an item has been released from the
+    view and moved to the reuse pool, when \l reuseItems is \c true.
+
+    Use it to stop timers and animations, or to reset other state that should
+    not carry over to the next time the item is shown.
+
+    The corresponding handler is \c onPooled.
+
+    \sa reused(), reuseItems
+*/
+
+/*!
+    \qmlattachedsignal QtQuick::ListView::reused()
+    \since 5.10
+    This attached signal is emitted after an item has been taken out of the
+    reuse pool and rebound to a new index, when \l reuseItems is \c true.
+
+    By the time this signal is emitted, \c index and the model roles seen by
+    the delegate already refer to the new model item.
+
+    The corresponding handler is \c onReused.
+
+    \sa pooled(), reuseItems
+*/
+
 /*!
     \qmlproperty model QtQuick::ListView::model
     This property holds the model providing data for the list.
@@ -2282,6 +2310,29 @@ void QQuickListView::setOrientation(QQuickListView::Orientation orientation)
     displayMarginBeginning or displayMarginEnd.
 */
 
+/*!
+    \qmlproperty bool QtQuick::ListView::reuseItems
+    \since 5.10
+
+    This property holds whether delegate items that move out of the view are
+    reused for new items rather than destroyed.
+
+    When \c true, an item that is released by the view is kept in a pool,
+    and the next item that needs the same delegate takes it from there and
+    is rebound to its new index, instead of a new item being created. This
+    saves the cost of creating objects and setting up bindings while
+    scrolling. Items that are not reused within a short while are destroyed.
+
+    Since a reused item keeps the state it had before it was pooled, the
+    delegate should reset any state that is not derived from the model in
+    the \l pooled() or \l reused() attached signals.
+
+    Items are only reused when they are not referenced from elsewhere, and
+    when the model is not a list of QObjects.
+
+    The default value is \c false.
+*/
+
 /*!
     \qmlproperty int QtQuick::ListView::displayMarginBeginning
     \qmlproperty int QtQuick::ListView::displayMarginEnd
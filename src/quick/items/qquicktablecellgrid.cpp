@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquicktablecellgrid_p.h"
+
+QT_BEGIN_NAMESPACE
+
+static const int initialCapacity = 8;
+
+QQuickTableCellGrid::QQuickTableCellGrid()
+    : m_rowMask(0)
+    , m_columnMask(0)
+    , m_columnShift(0)
+    , m_count(0)
+{
+}
+
+void QQuickTableCellGrid::insert(int row, int column, FxViewItem *item)
+{
+    Q_ASSERT(row >= 0 && column >= 0);
+    Q_ASSERT(item);
+
+    if (m_cells.isEmpty())
+        resize(initialCapacity, initialCapacity);
+
+    for (;;) {
+        Cell &cell = m_cells[slot(row, column)];
+        if (!cell.item || (cell.row == row && cell.column == column)) {
+            if (!cell.item)
+                ++m_count;
+            cell.row = row;
+            cell.column = column;
+            cell.item = item;
+            return;
+        }
+
+        // The slot is taken by another cell, which means that the loaded
+        // block has outgrown the capacity in the dimension(s) they differ in.
+        const int rowCapacity = m_rowMask + 1;
+        const int columnCapacity = m_columnMask + 1;
+        resize(cell.row != row ? rowCapacity * 2 : rowCapacity,
+               cell.column != column ? columnCapacity * 2 : columnCapacity);
+    }
+}
+
+FxViewItem *QQuickTableCellGrid::take(int row, int column)
+{
+    if (m_cells.isEmpty() || row < 0 || column < 0)
+        return nullptr;
+
+    Cell &cell = m_cells[slot(row, column)];
+    if (!cell.item || cell.row != row || cell.column != column)
+        return nullptr;
+
+    FxViewItem *item = cell.item;
+    cell = Cell();
+    --m_count;
+    return item;
+}
+
+void QQuickTableCellGrid::clear()
+{
+    // Keep the capacity, since the table will most likely be loaded
+    // again with a block of the same size.
+    if (m_count == 0)
+        return;
+    m_cells.fill(Cell());
+    m_count = 0;
+}
+
+void QQuickTableCellGrid::resize(int rowCapacity, int columnCapacity)
+{
+    Q_ASSERT(rowCapacity > 0 && (rowCapacity & (rowCapacity - 1)) == 0);
+    Q_ASSERT(columnCapacity > 0 && (columnCapacity & (columnCapacity - 1)) == 0);
+
+    const QVector<Cell> oldCells = m_cells;
+
+    m_rowMask = rowCapacity - 1;
+    m_columnMask = columnCapacity - 1;
+    m_columnShift = 0;
+    while ((1 << m_columnShift) < columnCapacity)
+        ++m_columnShift;
+
+    m_cells = QVector<Cell>(rowCapacity * columnCapacity);
+    m_count = 0;
+
+    for (const Cell &cell : oldCells) {
+        if (cell.item)
+            insert(cell.row, cell.column, cell.item);
+    }
+}
+
+QT_END_NAMESPACE
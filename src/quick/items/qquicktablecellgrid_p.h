@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKTABLECELLGRID_P_H
+#define QQUICKTABLECELLGRID_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/private/qtquickglobal_p.h>
+
+QT_REQUIRE_CONFIG(quick_tableview);
+
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class FxViewItem;
+
+// Holds the loaded items of a table, keyed by row and column.
+//
+// The loaded cells always form a (nearly) rectangular block that is grown
+// and shrunk one row or column at a time at its edges. The items are stored
+// in a ring buffer that wraps around in both dimensions: a cell is stored
+// at (row % rowCapacity, column % columnCapacity). As long as the block is
+// no larger than the capacity, no two loaded cells share a slot, so lookups,
+// insertions and removals are O(1), and nothing needs to be moved when
+// the block slides over the table. The capacities are powers of two, and
+// are doubled whenever two cells would end up in the same slot.
+class Q_AUTOTEST_EXPORT QQuickTableCellGrid
+{
+public:
+    QQuickTableCellGrid();
+
+    int count() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    FxViewItem *at(int row, int column) const
+    {
+        if (m_cells.isEmpty() || row < 0 || column < 0)
+            return nullptr;
+        const Cell &cell = m_cells.at(slot(row, column));
+        return cell.row == row && cell.column == column ? cell.item : nullptr;
+    }
+
+    void insert(int row, int column, FxViewItem *item);
+    FxViewItem *take(int row, int column);
+    void clear();
+
+private:
+    struct Cell {
+        int row = -1;
+        int column = -1;
+        FxViewItem *item = nullptr;
+    };
+
+    int slot(int row, int column) const
+    {
+        return ((row & m_rowMask) << m_columnShift) | (column & m_columnMask);
+    }
+
+    void resize(int rowCapacity, int columnCapacity);
+
+    QVector<Cell> m_cells;
+    int m_rowMask;
+    int m_columnMask;
+    int m_columnShift;
+    int m_count;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKTABLECELLGRID_P_H
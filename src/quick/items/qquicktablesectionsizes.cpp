@@ -0,0 +1,490 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquicktablesectionsizes_p.h"
+
+#include <QtCore/qmath.h>
+#include <QtCore/qpair.h>
+
+QT_BEGIN_NAMESPACE
+
+QQuickTableSectionSizes::QQuickTableSectionSizes(qreal defaultSize)
+    : m_count(0)
+    , m_defaultSize(defaultSize)
+    , m_estimatedSize(defaultSize)
+    , m_spacing(0)
+    , m_measuredSum(0)
+    , m_measuredCount(0)
+    , m_root(-1)
+    , m_freeNode(-1)
+    , m_seed(0x9e3779b9)
+{
+}
+
+void QQuickTableSectionSizes::setCount(int count)
+{
+    count = qMax(0, count);
+    if (count == m_count)
+        return;
+
+    if (count < m_count) {
+        int removed = -1;
+        split(m_root, count, &m_root, &removed);
+        destroySubtree(removed);
+        if (m_root == -1)
+            resetAllSizes();
+    }
+
+    m_count = count;
+}
+
+void QQuickTableSectionSizes::insertSections(int section, int count)
+{
+    // Inserts count sections with the default size before section, and
+    // moves the sizes of the sections that follow along with them.
+    section = qBound(0, section, m_count);
+    if (count <= 0)
+        return;
+
+    m_count += count;
+    if (m_root == -1)
+        return;
+
+    int left = -1;
+    int right = -1;
+    split(m_root, section, &left, &right);
+    shiftSubtree(right, count);
+    m_root = merge(left, right);
+}
+
+void QQuickTableSectionSizes::removeSections(int section, int count)
+{
+    // Removes count sections starting at section, together with their sizes
+    if (section < 0 || section >= m_count || count <= 0)
+        return;
+    count = qMin(count, m_count - section);
+
+    m_count -= count;
+    if (m_root == -1)
+        return;
+
+    int left = -1;
+    int removed = -1;
+    int right = -1;
+    split(m_root, section, &left, &right);
+    split(right, section + count, &removed, &right);
+    destroySubtree(removed);
+    shiftSubtree(right, -count);
+    m_root = merge(left, right);
+    if (m_root == -1)
+        resetAllSizes();
+}
+
+qreal QQuickTableSectionSizes::size(int section) const
+{
+    const int node = findNode(section);
+    return node == -1 ? m_estimatedSize : m_nodes.at(node).size;
+}
+
+bool QQuickTableSectionSizes::isMeasured(int section) const
+{
+    const int node = findNode(section);
+    return node != -1 && m_nodes.at(node).measured;
+}
+
+bool QQuickTableSectionSizes::updateEstimatedSize(qreal tolerance)
+{
+    // Moves the estimated size to the average measured size, unless it is
+    // already within tolerance (a fraction) of it. Returns true if it moved.
+    const qreal average = m_measuredCount == 0
+            ? m_defaultSize : m_measuredSum / m_measuredCount;
+    if (qAbs(average - m_estimatedSize) <= tolerance * qMax(average, m_estimatedSize))
+        return false;
+    m_estimatedSize = average;
+    return true;
+}
+
+void QQuickTableSectionSizes::resetMeasuredSizes()
+{
+    m_estimatedSize = m_defaultSize;
+    if (m_measuredCount == 0)
+        return;
+
+    if (m_measuredCount == explicitSizeCount()) {
+        resetAllSizes();
+        return;
+    }
+
+    // Collect the fixed sizes in order, and build the tree again from those
+    QVector<QPair<int, qreal>> fixedSizes;
+    fixedSizes.reserve(explicitSizeCount() - m_measuredCount);
+    QVector<int> stack;
+    int node = m_root;
+    while (node != -1 || !stack.isEmpty()) {
+        while (node != -1) {
+            pushShift(node);
+            stack.append(node);
+            node = m_nodes.at(node).left;
+        }
+        node = stack.takeLast();
+        const Node &n = m_nodes.at(node);
+        if (!n.measured)
+            fixedSizes.append(qMakePair(n.section, n.size));
+        node = n.right;
+    }
+
+    resetAllSizes();
+    for (const auto &fixedSize : qAsConst(fixedSizes))
+        m_root = merge(m_root, createNode(fixedSize.first, fixedSize.second, false));
+}
+
+void QQuickTableSectionSizes::storeSize(int section, qreal size, bool measured)
+{
+    Q_ASSERT(section >= 0 && section < m_count);
+    size = qMax<qreal>(0, size);
+
+    // Split the node for the section out of the tree, so that
+    // the sums are updated when it is merged back in.
+    int left = -1;
+    int node = -1;
+    int right = -1;
+    split(m_root, section, &left, &right);
+    split(right, section + 1, &node, &right);
+
+    if (node == -1) {
+        node = createNode(section, size, measured);
+    } else {
+        Node &n = m_nodes[node];
+        if (n.measured) {
+            m_measuredSum -= n.size;
+            --m_measuredCount;
+        }
+        n.size = size;
+        n.measured = measured;
+        updateNode(node);
+    }
+
+    if (measured) {
+        m_measuredSum += size;
+        ++m_measuredCount;
+    }
+
+    m_root = merge(merge(left, node), right);
+}
+
+void QQuickTableSectionSizes::resetSize(int section)
+{
+    if (m_root == -1)
+        return;
+
+    int left = -1;
+    int node = -1;
+    int right = -1;
+    split(m_root, section, &left, &right);
+    split(right, section + 1, &node, &right);
+    destroySubtree(node);
+    m_root = merge(left, right);
+    if (m_root == -1)
+        resetAllSizes();
+}
+
+void QQuickTableSectionSizes::resetAllSizes()
+{
+    m_nodes.clear();
+    m_root = -1;
+    m_freeNode = -1;
+    m_measuredSum = 0;
+    m_measuredCount = 0;
+}
+
+qreal QQuickTableSectionSizes::position(int section) const
+{
+    // Returns the start of the given section. Passing count() gives the end of
+    // the last section, including spacing.
+    section = qBound(0, section, m_count);
+
+    qreal explicitSum = 0;
+    int explicitCount = 0;
+    int shift = 0;
+    for (int node = m_root; node != -1; ) {
+        const Node &n = m_nodes.at(node);
+        if (n.section + shift < section) {
+            if (n.left != -1) {
+                explicitSum += m_nodes.at(n.left).sum;
+                explicitCount += m_nodes.at(n.left).count;
+            }
+            explicitSum += n.size;
+            ++explicitCount;
+            shift += n.shift;
+            node = n.right;
+        } else {
+            shift += n.shift;
+            node = n.left;
+        }
+    }
+
+    return explicitSum + (section - explicitCount) * m_estimatedSize + section * m_spacing;
+}
+
+qreal QQuickTableSectionSizes::totalSize() const
+{
+    if (m_count == 0)
+        return 0;
+    return position(m_count) - m_spacing;
+}
+
+int QQuickTableSectionSizes::sectionAt(qreal pos) const
+{
+    // Returns the section that contains pos, where the spacing after a section
+    // counts as part of that section. The result is bound to [0, count() - 1],
+    // or -1 if there are no sections.
+    if (m_count == 0)
+        return -1;
+    if (pos <= 0)
+        return 0;
+
+    // Find the last section with an explicit size that starts at or before pos
+    int lastSection = -1;
+    int nextSection = m_count;
+    qreal lastEnd = 0;
+    qreal explicitSum = 0;
+    int explicitCount = 0;
+    int shift = 0;
+    for (int node = m_root; node != -1; ) {
+        const Node &n = m_nodes.at(node);
+        const int section = n.section + shift;
+        qreal sumBefore = explicitSum;
+        int countBefore = explicitCount;
+        if (n.left != -1) {
+            sumBefore += m_nodes.at(n.left).sum;
+            countBefore += m_nodes.at(n.left).count;
+        }
+
+        const qreal start = sumBefore + (section - countBefore) * m_estimatedSize + section * m_spacing;
+        shift += n.shift;
+        if (start <= pos) {
+            lastSection = section;
+            lastEnd = start + n.size + m_spacing;
+            explicitSum = sumBefore + n.size;
+            explicitCount = countBefore + 1;
+            node = n.right;
+        } else {
+            nextSection = section;
+            node = n.left;
+        }
+    }
+
+    if (lastSection != -1 && pos < lastEnd)
+        return lastSection;
+
+    // pos is in the estimated sections that follow lastSection (or
+    // that start the table), and before nextSection.
+    const int first = lastSection + 1;
+    const int last = nextSection - 1;
+    if (first >= last)
+        return qMax(0, last);
+    const qreal step = m_estimatedSize + m_spacing;
+    if (step <= 0)
+        return last;
+
+    // Correct the estimate by one if rounding put it on the wrong side of a
+    // section boundary, so that the result agrees with position().
+    const auto startOf = [&](int estimated) {
+        return explicitSum + (estimated - explicitCount) * m_estimatedSize + estimated * m_spacing;
+    };
+    int section = qBound(first, first + qFloor((pos - startOf(first)) / step), last);
+    if (section < last && startOf(section + 1) <= pos)
+        ++section;
+    else if (section > first && startOf(section) > pos)
+        --section;
+    return section;
+}
+
+int QQuickTableSectionSizes::findNode(int section) const
+{
+    int shift = 0;
+    for (int node = m_root; node != -1; ) {
+        const Node &n = m_nodes.at(node);
+        const int nodeSection = n.section + shift;
+        if (nodeSection == section)
+            return node;
+        shift += n.shift;
+        node = section < nodeSection ? n.left : n.right;
+    }
+    return -1;
+}
+
+int QQuickTableSectionSizes::createNode(int section, qreal size, bool measured)
+{
+    // xorshift, which is random enough to keep the treap balanced
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    int node = m_freeNode;
+    if (node == -1) {
+        node = m_nodes.size();
+        m_nodes.resize(node + 1);
+    } else {
+        m_freeNode = m_nodes.at(node).left;
+    }
+
+    Node &n = m_nodes[node];
+    n.section = section;
+    n.shift = 0;
+    n.left = -1;
+    n.right = -1;
+    n.priority = m_seed;
+    n.measured = measured;
+    n.size = size;
+    n.sum = size;
+    n.count = 1;
+    return node;
+}
+
+void QQuickTableSectionSizes::destroySubtree(int node)
+{
+    if (node == -1)
+        return;
+
+    QVector<int> stack;
+    stack.append(node);
+    while (!stack.isEmpty()) {
+        node = stack.takeLast();
+        Node &n = m_nodes[node];
+        if (n.left != -1)
+            stack.append(n.left);
+        if (n.right != -1)
+            stack.append(n.right);
+        if (n.measured) {
+            m_measuredSum -= n.size;
+            --m_measuredCount;
+        }
+        n.left = m_freeNode;
+        m_freeNode = node;
+    }
+
+    if (m_measuredCount == 0)
+        m_measuredSum = 0;
+}
+
+void QQuickTableSectionSizes::pushShift(int node)
+{
+    Node &n = m_nodes[node];
+    if (n.shift == 0)
+        return;
+    shiftSubtree(n.left, n.shift);
+    shiftSubtree(n.right, n.shift);
+    n.shift = 0;
+}
+
+void QQuickTableSectionSizes::shiftSubtree(int node, int delta)
+{
+    if (node == -1)
+        return;
+    Node &n = m_nodes[node];
+    n.section += delta;
+    n.shift += delta;
+}
+
+void QQuickTableSectionSizes::updateNode(int node)
+{
+    Node &n = m_nodes[node];
+    n.sum = n.size;
+    n.count = 1;
+    if (n.left != -1) {
+        n.sum += m_nodes.at(n.left).sum;
+        n.count += m_nodes.at(n.left).count;
+    }
+    if (n.right != -1) {
+        n.sum += m_nodes.at(n.right).sum;
+        n.count += m_nodes.at(n.right).count;
+    }
+}
+
+void QQuickTableSectionSizes::split(int node, int section, int *left, int *right)
+{
+    // Splits the subtree into the sections before section, and the rest
+    if (node == -1) {
+        *left = -1;
+        *right = -1;
+        return;
+    }
+
+    pushShift(node);
+    if (m_nodes.at(node).section < section) {
+        int rightOfRight = -1;
+        split(m_nodes.at(node).right, section, &m_nodes[node].right, &rightOfRight);
+        updateNode(node);
+        *left = node;
+        *right = rightOfRight;
+    } else {
+        int leftOfLeft = -1;
+        split(m_nodes.at(node).left, section, &leftOfLeft, &m_nodes[node].left);
+        updateNode(node);
+        *left = leftOfLeft;
+        *right = node;
+    }
+}
+
+int QQuickTableSectionSizes::merge(int left, int right)
+{
+    // Merges two subtrees, where all sections in left come before those in right
+    if (left == -1)
+        return right;
+    if (right == -1)
+        return left;
+
+    if (m_nodes.at(left).priority > m_nodes.at(right).priority) {
+        pushShift(left);
+        const int merged = merge(m_nodes.at(left).right, right);
+        m_nodes[left].right = merged;
+        updateNode(left);
+        return left;
+    }
+
+    pushShift(right);
+    const int merged = merge(left, m_nodes.at(right).left);
+    m_nodes[right].left = merged;
+    updateNode(right);
+    return right;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QQUICKTABLESECTIONSIZES_P_H
+#define QQUICKTABLESECTIONSIZES_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/private/qtquickglobal_p.h>
+
+QT_REQUIRE_CONFIG(quick_tableview);
+
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// Keeps track of the sizes of the rows (or columns) in a table, so that
+// the position of a section, and the section at a position, can be looked
+// up in O(log n) even for tables with millions of rows.
+//
+// Sections that have not been given an explicit size use estimatedSize().
+// As long as no section has an explicit size, all lookups are simple
+// arithmetic, and nothing is allocated. The explicit sizes are kept in a
+// treap ordered by section, where each node also holds the sum of the sizes
+// and the number of nodes in its subtree. The position of a section k is:
+//
+//     explicitSum(k) + (k - explicitCount(k)) * estimatedSize + k * spacing
+//
+// where explicitSum(k) and explicitCount(k) are the sum and the number of
+// the explicit sizes of the sections before k, found along one path down
+// the tree. So changing the estimated size or the spacing is O(1), and
+// changing the size of one section is O(log m), where m is the number of
+// explicit sizes. Memory use depends on m only, not on count().
+//
+// Inserting or removing sections moves the sections that follow. Rather
+// than renumbering them one by one, the tree is split at the first section
+// that moves, and the section of the root of that part is shifted, to be
+// passed on to the children when they are next visited. That makes
+// insertSections() O(log m), and removeSections() O(log m) plus the number
+// of explicit sizes removed.
+//
+// An explicit size is either fixed (set with setSize()), or measured (set
+// with setMeasuredSize(), e.g from a size provider). Measured sizes are
+// only a cache, and can be thrown away with resetMeasuredSizes().
+//
+// The estimated size starts out as defaultSize(). Since the sections that
+// are measured are likely to be representative for the ones that are not,
+// updateEstimatedSize() moves it to the average measured size. That is left
+// to the caller, since it moves every section after the first unmeasured one.
+class Q_AUTOTEST_EXPORT QQuickTableSectionSizes
+{
+public:
+    QQuickTableSectionSizes(qreal defaultSize = 0);
+
+    int count() const { return m_count; }
+    void setCount(int count);
+    void insertSections(int section, int count);
+    void removeSections(int section, int count);
+
+    qreal defaultSize() const { return m_defaultSize; }
+    void setDefaultSize(qreal size) { m_defaultSize = size; m_estimatedSize = size; }
+
+    qreal estimatedSize() const { return m_estimatedSize; }
+    bool updateEstimatedSize(qreal tolerance);
+
+    qreal spacing() const { return m_spacing; }
+    void setSpacing(qreal spacing) { m_spacing = spacing; }
+
+    bool hasSize(int section) const { return findNode(section) != -1; }
+    qreal size(int section) const;
+    void setSize(int section, qreal size) { storeSize(section, size, false); }
+    void resetSize(int section);
+    void resetAllSizes();
+
+    bool isMeasured(int section) const;
+    void setMeasuredSize(int section, qreal size) { storeSize(section, size, true); }
+    void resetMeasuredSizes();
+
+    qreal position(int section) const;
+    qreal endPosition(int section) const { return position(section) + size(section); }
+    qreal totalSize() const;
+    int sectionAt(qreal pos) const;
+
+    int explicitSizeCount() const { return m_root == -1 ? 0 : m_nodes.at(m_root).count; }
+
+private:
+    struct Node {
+        int section;
+        int shift;      // still to be added to the sections of the children
+        int left;
+        int right;
+        uint priority;
+        bool measured;
+        qreal size;
+        qreal sum;      // of the sizes in the subtree
+        int count;      // of the nodes in the subtree
+    };
+
+    void storeSize(int section, qreal size, bool measured);
+    int findNode(int section) const;
+
+    int createNode(int section, qreal size, bool measured);
+    void destroySubtree(int node);
+    void pushShift(int node);
+    void shiftSubtree(int node, int delta);
+    void updateNode(int node);
+    void split(int node, int section, int *left, int *right);
+    int merge(int left, int right);
+
+    int m_count;
+    qreal m_defaultSize;
+    qreal m_estimatedSize;
+    qreal m_spacing;
+    qreal m_measuredSum;
+    int m_measuredCount;
+
+    // The nodes of the treap. Free nodes are chained through left.
+    QVector<Node> m_nodes;
+    int m_root;
+    int m_freeNode;
+    uint m_seed;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKTABLESECTIONSIZES_P_H
@@ -0,0 +1,290 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquicktablespans_p.h"
+
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+#include <numeric>
+
+QT_BEGIN_NAMESPACE
+
+QQuickTableSpans::QQuickTableSpans()
+    : m_indexedCount(0)
+{
+}
+
+template <typename Visitor>
+void QQuickTableSpans::visitRows(int top, int bottom, Visitor visitor) const
+{
+    // Calls visitor for each span that shares rows with [top, bottom],
+    // until it returns true.
+    if (m_indexedCount != m_spans.count())
+        indexSpans();
+
+    QVarLengthArray<int, 32> stack;
+    for (const Tree &tree : qAsConst(m_trees))
+        stack.append(tree.root);
+
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.last());
+        stack.removeLast();
+
+        const int end = node.first + node.count;
+        if (bottom < node.center) {
+            // All the spans of the node end at or below the center, so
+            // they share rows with the range if they begin early enough
+            for (int i = node.first; i < end && m_spans.at(m_byTop.at(i)).top() <= bottom; ++i) {
+                if (visitor(m_spans.at(m_byTop.at(i))))
+                    return;
+            }
+            if (node.before != -1)
+                stack.append(node.before);
+        } else if (top > node.center) {
+            for (int i = node.first; i < end && m_spans.at(m_byBottom.at(i)).bottom() >= top; ++i) {
+                if (visitor(m_spans.at(m_byBottom.at(i))))
+                    return;
+            }
+            if (node.after != -1)
+                stack.append(node.after);
+        } else {
+            for (int i = node.first; i < end; ++i) {
+                if (visitor(m_spans.at(m_byTop.at(i))))
+                    return;
+            }
+            if (node.before != -1)
+                stack.append(node.before);
+            if (node.after != -1)
+                stack.append(node.after);
+        }
+    }
+}
+
+bool QQuickTableSpans::insert(const QRect &span)
+{
+    // Returns false, and leaves the spans untouched, if the span overlaps another one
+    if (span.isEmpty() || span.left() < 0 || span.top() < 0 || intersects(span))
+        return false;
+    m_spans.append(span);
+    return true;
+}
+
+bool QQuickTableSpans::remove(int row, int column)
+{
+    // Removes the span with its top-left cell at row and column
+    const QPoint topLeft(column, row);
+    const auto it = std::find_if(m_spans.begin(), m_spans.end(), [&](const QRect &span) {
+        return span.topLeft() == topLeft;
+    });
+    if (it == m_spans.end())
+        return false;
+
+    // The indexes in the trees are no longer valid, so build them again when needed
+    m_spans.erase(it);
+    resetIndex();
+    return true;
+}
+
+void QQuickTableSpans::clear()
+{
+    m_spans.clear();
+    resetIndex();
+}
+
+void QQuickTableSpans::insertRows(int row, int count)
+{
+    // Spans below the inserted rows move down, and spans
+    // that the rows are inserted into grow.
+    if (count <= 0 || m_spans.isEmpty())
+        return;
+
+    for (QRect &span : m_spans) {
+        if (span.top() >= row)
+            span.translate(0, count);
+        else if (span.bottom() >= row)
+            span.setBottom(span.bottom() + count);
+    }
+    resetIndex();
+}
+
+void QQuickTableSpans::removeRows(int row, int count)
+{
+    // Spans below the removed rows move up, and spans that lose rows shrink.
+    // A span that is left with a single cell, or none, is removed.
+    if (count <= 0 || m_spans.isEmpty())
+        return;
+
+    const int end = row + count;
+    int kept = 0;
+    for (int i = 0; i < m_spans.count(); ++i) {
+        QRect span = m_spans.at(i);
+        if (span.top() >= end) {
+            span.translate(0, -count);
+        } else if (span.bottom() >= row) {
+            const int removed = qMin(span.bottom() + 1, end) - qMax(span.top(), row);
+            span = QRect(span.left(), qMin(span.top(), row), span.width(), span.height() - removed);
+            if (span.height() <= 0 || (span.height() == 1 && span.width() == 1))
+                continue;
+        }
+        m_spans[kept++] = span;
+    }
+    m_spans.resize(kept);
+    resetIndex();
+}
+
+QRect QQuickTableSpans::spanAt(int row, int column) const
+{
+    // Returns the span that covers the cell, or a null QRect
+    if (m_spans.isEmpty())
+        return QRect();
+
+    QRect result;
+    visitRows(row, row, [&](const QRect &span) {
+        if (column < span.left() || column > span.right())
+            return false;
+        result = span;
+        return true;
+    });
+    return result;
+}
+
+bool QQuickTableSpans::intersects(const QRect &rect) const
+{
+    bool result = false;
+    visitRows(rect.top(), rect.bottom(), [&](const QRect &span) {
+        result = span.intersects(rect);
+        return result;
+    });
+    return result;
+}
+
+void QQuickTableSpans::indexSpans() const
+{
+    // Give the spans added since the last lookup a tree of their own, and
+    // merge it with the trees before it that are less than twice as large.
+    // The trees at the end are the last ones built, so their nodes are at
+    // the end of m_nodes, and can be dropped before building them again.
+    Tree tree;
+    tree.firstSpan = m_indexedCount;
+    tree.spanCount = m_spans.count() - m_indexedCount;
+    tree.firstNode = m_nodes.count();
+    tree.firstEntry = m_byTop.count();
+    while (!m_trees.isEmpty() && m_trees.last().spanCount < 2 * tree.spanCount) {
+        const Tree &last = m_trees.last();
+        tree.firstSpan = last.firstSpan;
+        tree.spanCount += last.spanCount;
+        tree.firstNode = last.firstNode;
+        tree.firstEntry = last.firstEntry;
+        m_trees.removeLast();
+    }
+
+    m_nodes.resize(tree.firstNode);
+    m_byTop.resize(tree.firstEntry);
+    m_byBottom.resize(tree.firstEntry);
+
+    QVector<int> spans(tree.spanCount);
+    std::iota(spans.begin(), spans.end(), tree.firstSpan);
+    tree.root = buildTree(spans);
+    m_trees.append(tree);
+    m_indexedCount = m_spans.count();
+}
+
+void QQuickTableSpans::resetIndex()
+{
+    m_trees.clear();
+    m_nodes.clear();
+    m_byTop.clear();
+    m_byBottom.clear();
+    m_indexedCount = 0;
+}
+
+int QQuickTableSpans::buildTree(QVector<int> spans) const
+{
+    if (spans.isEmpty())
+        return -1;
+
+    // Center the node on the middle row of the median span. That span, at
+    // least, ends up in the node, and the rest are split about evenly
+    // between the children, which keeps the tree balanced.
+    const auto middleRow = [this](int span) {
+        return m_spans.at(span).top() + (m_spans.at(span).height() - 1) / 2;
+    };
+    const auto median = spans.begin() + spans.count() / 2;
+    std::nth_element(spans.begin(), median, spans.end(), [&](int a, int b) {
+        return middleRow(a) < middleRow(b);
+    });
+
+    Node node;
+    node.center = middleRow(*median);
+
+    QVector<int> before;
+    QVector<int> after;
+    QVector<int> crossing;
+    for (int span : qAsConst(spans)) {
+        if (m_spans.at(span).bottom() < node.center)
+            before.append(span);
+        else if (m_spans.at(span).top() > node.center)
+            after.append(span);
+        else
+            crossing.append(span);
+    }
+
+    node.first = m_byTop.count();
+    node.count = crossing.count();
+    std::sort(crossing.begin(), crossing.end(), [this](int a, int b) {
+        return m_spans.at(a).top() < m_spans.at(b).top();
+    });
+    m_byTop += crossing;
+    std::sort(crossing.begin(), crossing.end(), [this](int a, int b) {
+        return m_spans.at(a).bottom() > m_spans.at(b).bottom();
+    });
+    m_byBottom += crossing;
+
+    const int index = m_nodes.count();
+    m_nodes.append(node);
+    const int beforeNode = buildTree(before);
+    const int afterNode = buildTree(after);
+    m_nodes[index].before = beforeNode;
+    m_nodes[index].after = afterNode;
+    return index;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QQUICKTABLESPANS_P_H
+#define QQUICKTABLESPANS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/private/qtquickglobal_p.h>
+
+QT_REQUIRE_CONFIG(quick_tableview);
+
+#include <QtCore/qrect.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// Holds the spans (merged cells) of a table. A span is a block of cells,
+// stored as a QRect where x and y are the left column and the top row.
+// Spans never overlap.
+//
+// Finding the span that covers a cell is O(log^2 n + k), where k is the number
+// of spans that share rows with the cell. The spans are kept in centered
+// interval trees over their rows: each node holds the spans that cross its
+// center row, sorted both by their top and their bottom row, so that the
+// ones that cross a given row can be found without looking at the rest.
+//
+// The trees are built lazily, on the first lookup after spans have been
+// added. Each tree covers a range of consecutive spans, and is at least
+// twice as large as the tree after it. Spans that are added get a tree of
+// their own, which is merged with the trees before it that are not much
+// larger. That way, a span takes part in O(log n) builds, and adding n spans
+// one by one, each checked for overlaps, costs O(n log^2 n) rather than O(n^2).
+// Removing spans, or moving them along with inserted or removed rows,
+// builds the trees again from scratch.
+class Q_AUTOTEST_EXPORT QQuickTableSpans
+{
+public:
+    QQuickTableSpans();
+
+    int count() const { return m_spans.count(); }
+    bool isEmpty() const { return m_spans.isEmpty(); }
+
+    bool insert(const QRect &span);
+    bool remove(int row, int column);
+    void clear();
+
+    void insertRows(int row, int count);
+    void removeRows(int row, int count);
+
+    QRect spanAt(int row, int column) const;
+    bool intersects(const QRect &rect) const;
+
+private:
+    struct Node {
+        int center;
+        int first; // The spans of the node are at [first, first + count)
+        int count; // in m_byTop and m_byBottom
+        int before; // Child nodes with spans that end before, or
+        int after; // begin after, the center row. -1 if none.
+    };
+
+    struct Tree {
+        int root;
+        int firstSpan; // The tree holds the spans at [firstSpan, firstSpan + spanCount)
+        int spanCount; // in m_spans. Its nodes, and their entries in m_byTop and
+        int firstNode; // m_byBottom, come after the ones of the trees before it.
+        int firstEntry;
+    };
+
+    template <typename Visitor>
+    void visitRows(int top, int bottom, Visitor visitor) const;
+    void indexSpans() const;
+    void resetIndex();
+    int buildTree(QVector<int> spans) const;
+
+    QVector<QRect> m_spans;
+
+    mutable QVector<Tree> m_trees;
+    mutable QVector<Node> m_nodes;
+    mutable QVector<int> m_byTop;
+    mutable QVector<int> m_byBottom;
+    mutable int m_indexedCount;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKTABLESPANS_P_H
@@ -39,15 +39,40 @@
 
 #include "qquicktableview_p.h"
 #include "qquickabstractitemview_p_p.h"
-
+#include "qquicktablecellgrid_p.h"
+#include "qquicktablesectionsizes_p.h"
+#include "qquicktablespans_p.h"
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qthreadpool.h>
+#include <QtGui/qfontdatabase.h>
+#include <QtGui/qtextlayout.h>
+#include <QtQml/qqmlinfo.h>
 #include <QtQml/private/qqmldelegatemodel_p.h>
 
+#include <algorithm>
+#include <cfloat>
+
 QT_BEGIN_NAMESPACE
 
+// Milliseconds spent creating delegates for resizeColumnToContents()
+// per polish. The rest of the sampled rows are measured in later ones.
+#ifndef QML_TABLEVIEW_AUTOFITTIME
+#define QML_TABLEVIEW_AUTOFITTIME 4
+#endif
+
 class FxTableItemSG : public FxViewItem
 {
 public:
     FxTableItemSG(QQuickItem *i, QQuickTableView *v, bool own) : FxViewItem(i, v, own, static_cast<QQuickItemViewAttached*>(qmlAttachedPropertiesObject<QQuickTableView>(i)))
+        , row(-1)
+        , column(-1)
+        , rowSpan(1)
+        , columnSpan(1)
     {
     }
 
@@ -61,6 +86,29 @@ public:
     {
         moveTo(pos, immediate); // ###
     }
+
+    // The top-left cell of the item. If the item belongs to a span, it
+    // covers rowSpan rows and columnSpan columns from there.
+    int row;
+    int column;
+    int rowSpan;
+    int columnSpan;
+};
+
+// Lets a text measurement that runs in a worker thread find its way back
+// to the view, unless the view has been destroyed in the meantime.
+struct QQuickTableViewAutoFitGuard
+{
+    QMutex mutex;
+    QQuickTableView *view;
+};
+
+// The rows of a column that are still to be measured by creating their
+// delegates, and the widest cell so far.
+struct QQuickTableViewAutoFitColumn
+{
+    QVector<int> rows;
+    qreal width;
 };
 
 class QQuickTableViewPrivate : public QQuickAbstractItemViewPrivate
@@ -70,90 +118,261 @@ class QQuickTableViewPrivate : public QQuickAbstractItemViewPrivate
 public:
     QQuickTableViewPrivate();
 
-    bool isRightToLeft() const;
-    bool isBottomToTop() const;
-
     int rowAtIndex(int index) const;
     int rowAtPos(qreal y) const;
     int columnAtIndex(int index) const;
     int columnAtPos(qreal x) const;
     int indexAt(int row, int column) const;
-    FxViewItem *visibleItemAt(int row, int column) const;
+    FxTableItemSG *visibleItemAt(int row, int column) const;
+    bool isLoadedCell(int row, int column) const;
+    bool isLoadedItem(const FxTableItemSG *item) const;
+    QRect cellSpan(int row, int column) const;
+    FxViewItem *visibleItem(int modelIndex) const override;
+    FxViewItem *visibleItemAtPosition(qreal x, qreal y) const override;
 
     qreal rowPos(int row) const;
     qreal rowHeight(int row) const;
     qreal columnPos(int column) const;
     qreal columnWidth(int column) const;
-    void updateAverageSize();
+    void syncSectionCounts();
+    bool updateEstimatedSizes();
+    bool measureRow(int row);
+    bool measureColumn(int column);
+    qreal provideSize(const QJSValue &provider, const std::function<qreal(int)> &callback, int section);
 
-    QSizeF size() const;
-    QPointF position() const;
-    QPointF startPosition() const;
-    QPointF originPosition() const;
-    QPointF endPosition() const;
-    QPointF lastPosition() const;
+    QRectF viewportRect() const;
+    QRectF bufferRect(const QRectF &fillRect) const;
+    QRectF loadedTableRect() const;
 
     QPointF itemPosition(int row, int column) const;
     QPointF itemPosition(FxViewItem *item) const;
     QPointF itemEndPosition(FxViewItem *item) const;
     QSizeF itemSize(FxViewItem *item) const;
 
+    void clear() override;
     void updateViewport() override;
     bool addRemoveVisibleItems() override;
-    void positionViewAtIndex(int index, int mode) override { Q_UNUSED(index); Q_UNUSED(mode); }
-    bool applyModelChanges() override { return false; }
+    void recreateVisibleItems() override;
+    void positionViewAtIndex(int index, int mode) override;
+    void positionViewAtCell(int row, int column, int mode);
+    void setViewportPosition(const QPointF &pos);
+    void resizeColumnToContents(int column);
+    void measureAutoFitColumns();
+    void applyAutoFitWidth(int column, int requestId, qreal width);
+    bool applyModelChanges() override;
     Qt::Orientation layoutOrientation() const override;
     bool isContentFlowReversed() const override;
     void createHighlight() override { }
     void updateHighlight() override { }
     void resetHighlightPosition() override { }
     void fixupPosition() override { }
-    void visibleItemsChanged() override;
     FxViewItem *newViewItem(int index, QQuickItem *item) override;
     void repositionItemAt(FxViewItem *item, int index, qreal sizeBuffer) override { Q_UNUSED(item); Q_UNUSED(index); Q_UNUSED(sizeBuffer); }
     void repositionPackageItemAt(QQuickItem *item, int index) override { Q_UNUSED(item); Q_UNUSED(index); }
-    void layoutVisibleItems(int fromModelIndex = 0) override { Q_UNUSED(fromModelIndex); }
+    void layoutVisibleItems(int fromModelIndex = 0) override;
+    void invalidateLayout() override;
     void changedVisibleIndex(int newIndex) override { Q_UNUSED(newIndex); }
     void translateAndTransitionFilledItems() override { }
 
     int rows;
     int columns;
-    int visibleRows;
-    int visibleColumns;
     QQuickTableView::Orientation orientation;
-    qreal rowSpacing;
-    qreal columnSpacing;
-    QPointF visiblePos;
-    QSizeF averageSize;
+
+    // Heights of the rows and widths of the columns, including spacing
+    QQuickTableSectionSizes rowHeights;
+    QQuickTableSectionSizes columnWidths;
+
+    // Optional providers of row heights and column widths. They are only asked
+    // about a row or column once it is about to be loaded, and the answer is
+    // cached in rowHeights/columnWidths until invalidated.
+    QJSValue rowHeightProvider;
+    QJSValue columnWidthProvider;
+    std::function<qreal(int)> rowHeightCallback;
+    std::function<qreal(int)> columnWidthCallback;
+
+    // The rows and columns that currently have delegate items loaded. x and y
+    // hold the left column and the top row, width and height the number of
+    // loaded columns and rows. The table is only ever grown or shrunk one edge
+    // (a whole row or column) at a time.
+    QRect loadedTable;
+
+    // The items in visibleItems, keyed by their row and column
+    QQuickTableCellGrid loadedItems;
+
+    // Frozen rows and columns are pinned to the top and left side of the view.
+    // Their cells are loaded for the same columns and rows as loadedTable,
+    // which never includes them. They are children of containers that follow
+    // contentX/contentY, so that scrolling only moves the containers. The cells
+    // are kept apart from loadedItems, since they don't border the other cells.
+    int frozenRows;
+    int frozenColumns;
+    int loadedFrozenRows;
+    int loadedFrozenColumns;
+    QQuickTableCellGrid frozenRowItems;
+    QQuickTableCellGrid frozenColumnItems;
+    QQuickTableCellGrid frozenCornerItems;
+    QQuickItem *frozenRowsContainer;
+    QQuickItem *frozenColumnsContainer;
+    QQuickItem *frozenCornerContainer;
+
+    // Cells merged into one item. The item is created for the top-left cell of
+    // the span, and stored in the cell grids for every loaded cell it covers.
+    // It stays loaded as long as any of those cells are. Changing the spans
+    // loads the table again, once for all the changes made before the next
+    // refill.
+    QQuickTableSpans cellSpans;
+    bool spansChanged;
+
+    // An edge that is being loaded into the cache buffer with asynchronously
+    // incubated items. Its cells are created one at a time, in order, as their
+    // incubation completes. The edge only becomes part of loadedTable once all
+    // of them exist (or have failed to be created, which leaves the cell
+    // empty), and no other edge is loaded until then.
+    Qt::Edges pendingTableEdge;
+    int pendingEdgeCellCount;
+
+    // The loaded cells that intersect the viewport. The rest of the loaded
+    // cells are in the cache buffer, and are culled.
+    QRect visibleTable;
+
+    // The first and last loaded rows the last time rows were fetched ahead.
+    // Nothing new can be asked for until they change.
+    int fetchedAheadTop;
+    int fetchedAheadBottom;
+
+    // Fitting columns to their contents. Only autoFitSampleSize rows, spread
+    // evenly over the table, are looked at. With autoFitTextRole set, the text
+    // of that role is measured, in a worker thread if the platform can use
+    // fonts outside the GUI thread, instead of instantiating a delegate for
+    // each row. autoFitRequests holds the latest such measurement for each
+    // column, so that an older one that finishes later is ignored. Without
+    // autoFitTextRole, the delegates are created a few at a time, over as
+    // many polishes as it takes, and autoFitColumns holds the rows left.
+    int autoFitSampleSize;
+    QString autoFitTextRole;
+    QFont autoFitFont;
+    QHash<int, int> autoFitRequests;
+    int autoFitRequestId;
+    QSharedPointer<QQuickTableViewAutoFitGuard> autoFitGuard;
+    QHash<int, QQuickTableViewAutoFitColumn> autoFitColumns;
 
 protected:
-    bool addVisibleItems(const QPointF &fillFrom, const QPointF &fillTo,
-                         const QPointF &bufferFrom, const QPointF &bufferTo, bool doBuffer);
-    bool removeNonVisibleItems(const QPointF &fillFrom, const QPointF &fillTo,
-                               const QPointF &bufferFrom, const QPointF &bufferTo);
-    void createAndPositionItem(int row, int col, bool doBuffer);
+    bool addVisibleItems(const QRectF &fillRect, bool doBuffer);
+    bool removeNonVisibleItems(const QRectF &fillRect);
+    bool canLoadTableEdge(Qt::Edge tableEdge, const QRectF &fillRect) const;
+    bool canUnloadTableEdge(Qt::Edge tableEdge, const QRectF &fillRect) const;
+    bool loadTableEdge(Qt::Edge tableEdge, bool doBuffer);
+    void unloadTableEdge(Qt::Edge tableEdge);
+    void cancelPendingTableEdge();
+    void releaseLoadedItems();
+    void releaseTableItems(const QVector<FxViewItem *> &items);
+    QPoint edgeCell(Qt::Edge tableEdge, int cellIndex) const;
+    void releaseLoadedRows(int fromRow, int toRow);
+    void moveLoadedRows(int fromRow, int delta);
+    bool insertRows(int row, int count, qreal *contentYAdjustment);
+    bool removeRows(int row, int count, qreal *contentYAdjustment);
+    bool spansLoadedRows(int row) const;
+    void invalidateChangedSections(const QQmlChangeSet::Change &change, int columns);
+    void updateCulling(const QRectF &fillRect, bool force);
+    FxTableItemSG *createAndPositionItem(int row, int col, bool doBuffer);
+    bool loadCell(int row, int column, bool doBuffer);
+    FxTableItemSG *loadedSpanItem(const QRect &span, int row, int column) const;
+    void resizeSpanningItem(FxTableItemSG *item);
+
+    QQuickTableCellGrid &cellGrid(int row, int column);
+    const QQuickTableCellGrid &cellGrid(int row, int column) const;
+    void clearCellGrids();
+    qreal implicitCellWidth(int row, int column);
+    QQuickItem *frozenContainer(int row, int column) const;
+    void updateFrozenContainers();
+    bool loadFirstCell(int row, int column);
+    void fetchRowsAhead();
+    QRectF bodyRect(const QRectF &viewport) const;
+};
+
+class QQuickTableViewTextMeasurer : public QRunnable
+{
+public:
+    QQuickTableViewTextMeasurer(const QSharedPointer<QQuickTableViewAutoFitGuard> &guard, int column, int requestId,
+                                const QFont &font, const QStringList &texts, qreal padding, qreal minimumWidth)
+        : guard(guard)
+        , column(column)
+        , requestId(requestId)
+        , font(font)
+        , texts(texts)
+        , padding(padding)
+        , minimumWidth(minimumWidth)
+    {
+    }
+
+    static qreal textWidth(const QFont &font, QString text)
+    {
+        // Lays out the text the same way as a Text item that doesn't wrap. Unlike
+        // QFontMetrics, QTextLayout may be used outside the GUI thread.
+        text.replace(QLatin1Char('\n'), QChar::LineSeparator);
+        QTextLayout layout(text, font);
+        layout.beginLayout();
+        for (QTextLine line = layout.createLine(); line.isValid(); line = layout.createLine())
+            line.setLineWidth(FLT_MAX);
+        layout.endLayout();
+        return layout.maximumWidth();
+    }
+
+    void run() override
+    {
+        qreal width = 0;
+        for (const QString &text : qAsConst(texts))
+            width = qMax(width, textWidth(font, text));
+        width = qMax(width + padding, minimumWidth);
+
+        // Hold the lock until the call is posted, so that the view cannot be
+        // destroyed in between. Once it is, Qt drops the posted call.
+        QMutexLocker locker(&guard->mutex);
+        if (QQuickTableView *view = guard->view) {
+            const int column = this->column;
+            const int requestId = this->requestId;
+            QMetaObject::invokeMethod(view, [view, column, requestId, width] {
+                QQuickTableViewPrivate *d = static_cast<QQuickTableViewPrivate *>(QObjectPrivate::get(view));
+                d->applyAutoFitWidth(column, requestId, width);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+private:
+    QSharedPointer<QQuickTableViewAutoFitGuard> guard;
+    int column;
+    int requestId;
+    QFont font;
+    QStringList texts;
+    qreal padding;
+    qreal minimumWidth;
 };
 
+// Not the global pool, which the application might keep busy
+Q_GLOBAL_STATIC(QThreadPool, textMeasurerPool)
+
+static const Qt::Edge allTableEdges[] = { Qt::LeftEdge, Qt::RightEdge, Qt::TopEdge, Qt::BottomEdge };
+
 QQuickTableViewPrivate::QQuickTableViewPrivate()
     : rows(-1),
       columns(-1),
-      visibleRows(0),
-      visibleColumns(0),
       orientation(QQuickTableView::Vertical),
-      rowSpacing(0),
-      columnSpacing(0)
-{
-}
-
-bool QQuickTableViewPrivate::isRightToLeft() const
-{
-    Q_Q(const QQuickTableView);
-    return orientation == QQuickTableView::Horizontal && q->effectiveLayoutDirection() == Qt::RightToLeft;
-}
-
-bool QQuickTableViewPrivate::isBottomToTop() const
+      rowHeights(60),
+      columnWidths(120),
+      frozenRows(0),
+      frozenColumns(0),
+      loadedFrozenRows(0),
+      loadedFrozenColumns(0),
+      frozenRowsContainer(nullptr),
+      frozenColumnsContainer(nullptr),
+      frozenCornerContainer(nullptr),
+      spansChanged(false),
+      pendingEdgeCellCount(0),
+      fetchedAheadTop(-1),
+      fetchedAheadBottom(-1),
+      autoFitSampleSize(100),
+      autoFitRequestId(0)
 {
-    return orientation == QQuickTableView::Vertical && verticalLayoutDirection == QQuickAbstractItemView::BottomToTop;
 }
 
 int QQuickTableViewPrivate::rowAtIndex(int index) const
@@ -178,10 +397,7 @@ int QQuickTableViewPrivate::rowAtIndex(int index) const
 
 int QQuickTableViewPrivate::rowAtPos(qreal y) const
 {
-    // ### TODO: for now we assume all rows has the same height. This will not be the case in the end.
-    // The strategy should either be to keep all the row heights in a separate array, or
-    // inspect the current visible items to make a guess.
-    return y / rowHeight(0);
+    return rowHeights.sectionAt(y);
 }
 
 int QQuickTableViewPrivate::columnAtIndex(int index) const
@@ -195,10 +411,7 @@ int QQuickTableViewPrivate::columnAtIndex(int index) const
 
 int QQuickTableViewPrivate::columnAtPos(qreal x) const
 {
-    // ### TODO: for now we assume all columns has the same width. This will not be the case in the end.
-    // The strategy should either be to keep all the column widths in a separate array, or
-    // inspect the current visible items to make a guess.
-    return x / columnWidth(0);
+    return columnWidths.sectionAt(x);
 }
 
 int QQuickTableViewPrivate::indexAt(int row, int column) const
@@ -208,183 +421,277 @@ int QQuickTableViewPrivate::indexAt(int row, int column) const
     int columns = q->columns();
     if (row < 0 || row >= rows || column < 0 || column >= columns)
         return -1;
-    return column + row * columns;
+    return row * columns + column;
 }
 
-FxViewItem *QQuickTableViewPrivate::visibleItemAt(int row, int column) const
+FxTableItemSG *QQuickTableViewPrivate::visibleItemAt(int row, int column) const
 {
-    int visibleRow = rowAtIndex(visibleIndex);
-    int visibleColumn = columnAtIndex(visibleIndex);
-    if (row < visibleRow || row >= visibleRow + visibleRows
-            || column < visibleColumn || column >= visibleRow + visibleRows)
-        return nullptr;
+    return static_cast<FxTableItemSG *>(cellGrid(row, column).at(row, column));
+}
 
-    int r = row - visibleRow;
-    int c = column - visibleColumn;
-    return visibleItems.value(r + c * visibleRows);
+bool QQuickTableViewPrivate::isLoadedCell(int row, int column) const
+{
+    // Returns true if the cell belongs to loadedTable, or to the frozen
+    // rows and columns loaded along with it
+    if (loadedTable.isEmpty())
+        return false;
+    const bool loadedRow = row < loadedFrozenRows || (row >= loadedTable.top() && row <= loadedTable.bottom());
+    const bool loadedColumn = column < loadedFrozenColumns || (column >= loadedTable.left() && column <= loadedTable.right());
+    return row >= 0 && column >= 0 && loadedRow && loadedColumn;
 }
 
-qreal QQuickTableViewPrivate::rowPos(int row) const
+bool QQuickTableViewPrivate::isLoadedItem(const FxTableItemSG *item) const
 {
-    // ### TODO: Support rows having different heights. Should this be stored in a separate list as well?
-    return row * (rowHeight(row) + rowSpacing);
-
-//    // ### TODO: bottom-to-top
-//    int visibleColumn = columnAt(visibleIndex);
-//    FxViewItem *item = visibleItemAt(row, visibleColumn);
-//    if (item)
-//        return item->itemY();
-
-//    // estimate
-//    int visibleRow = rowAt(visibleIndex);
-//    if (row < visibleRow) {
-//        int count = visibleRow - row;
-//        FxViewItem *topLeft = visibleItemAt(visibleRow, visibleColumn);
-//        return topLeft->itemY() - count * averageSize.height(); // ### spacing
-//    } else if (row > visibleRow + visibleRows) {
-//        int count = row - visibleRow - visibleRows;
-//        FxViewItem *bottomLeft = visibleItemAt(visibleRow + visibleRows, visibleColumn);
-//        return bottomLeft->itemY() + bottomLeft->itemHeight() + count * averageSize.height(); // ### spacing
-//    }
-//    return 0;
+    // Returns true if any of the cells covered by the item are loaded
+    if (loadedTable.isEmpty())
+        return false;
+    const int bottom = item->row + item->rowSpan - 1;
+    const int right = item->column + item->columnSpan - 1;
+    const bool loadedRow = item->row < loadedFrozenRows || (item->row <= loadedTable.bottom() && bottom >= loadedTable.top());
+    const bool loadedColumn = item->column < loadedFrozenColumns || (item->column <= loadedTable.right() && right >= loadedTable.left());
+    return loadedRow && loadedColumn;
 }
 
-qreal QQuickTableViewPrivate::rowHeight(int row) const
+QRect QQuickTableViewPrivate::cellSpan(int row, int column) const
 {
-    // ### TODO: Rather than search through visible items, I think this information should be
-    // specified more explixit, e.g in an separate list. Use a constant for now.
-    Q_UNUSED(row);
-    return 60;
+    // Returns the cells covered by the span that the cell belongs to, or just the
+    // cell itself. A span that crosses the edge of the frozen rows or columns
+    // cannot be shown as one item, so such spans are ignored.
+    const QRect cell(column, row, 1, 1);
+    if (cellSpans.isEmpty())
+        return cell;
+
+    QRect span = cellSpans.spanAt(row, column);
+    if (span.isNull())
+        return cell;
+
+    span &= QRect(0, 0, columnWidths.count(), rowHeights.count());
+    if ((span.top() < loadedFrozenRows) != (span.bottom() < loadedFrozenRows))
+        return cell;
+    if ((span.left() < loadedFrozenColumns) != (span.right() < loadedFrozenColumns))
+        return cell;
+    return span;
+}
 
-//    int column = columnAt(visibleIndex);
-//    FxViewItem *item = visibleItemAt(row, column);
-//    return item ? item->itemHeight() : averageSize.height();
+QQuickTableCellGrid &QQuickTableViewPrivate::cellGrid(int row, int column)
+{
+    const bool frozenRow = row < loadedFrozenRows;
+    const bool frozenColumn = column < loadedFrozenColumns;
+    if (frozenRow && frozenColumn)
+        return frozenCornerItems;
+    if (frozenRow)
+        return frozenRowItems;
+    if (frozenColumn)
+        return frozenColumnItems;
+    return loadedItems;
 }
 
-qreal QQuickTableViewPrivate::columnPos(int column) const
+const QQuickTableCellGrid &QQuickTableViewPrivate::cellGrid(int row, int column) const
 {
-    // ### TODO: Support columns having different widths. Should this be stored in a separate list as well?
-    return column * (columnWidth(column) + columnSpacing);
-
-//    // ### TODO: right-to-left
-//    int visibleRow = rowAt(visibleIndex);
-//    FxViewItem *item = visibleItemAt(visibleRow, column);
-//    if (item)
-//        return item->itemX();
-
-//    // estimate
-//    int visibleColumn = columnAt(visibleIndex);
-//    if (column < visibleColumn) {
-//        int count = visibleColumn - column;
-//        FxViewItem *topLeft = visibleItemAt(visibleRow, visibleColumn);
-//        return topLeft->itemX() - count * averageSize.width(); // ### TODO: spacing
-//    } else if (column > visibleColumn + visibleColumns) {
-//        int count = column - visibleColumn - visibleColumns;
-//        FxViewItem *topRight = visibleItemAt(visibleRow, visibleColumn + visibleColumns);
-//        return topRight->itemX() + topRight->itemWidth() + count * averageSize.width(); // ### TODO: spacing
-//    }
-//    return 0;
+    return const_cast<QQuickTableViewPrivate *>(this)->cellGrid(row, column);
 }
 
-qreal QQuickTableViewPrivate::columnWidth(int column) const
+void QQuickTableViewPrivate::clearCellGrids()
 {
-    // ### TODO: Rather than search through visible items, I think this information should be
-    // specified more explixit, e.g in an separate list. Use a constant for now.
-    Q_UNUSED(column);
-    return 120;
+    loadedItems.clear();
+    frozenRowItems.clear();
+    frozenColumnItems.clear();
+    frozenCornerItems.clear();
+}
 
-//    int row = rowAt(visibleIndex);
-//    FxViewItem *item = visibleItemAt(row, column);
-//    return item ? item->itemWidth() : averageSize.width();
+QQuickItem *QQuickTableViewPrivate::frozenContainer(int row, int column) const
+{
+    const bool frozenRow = row < loadedFrozenRows;
+    const bool frozenColumn = column < loadedFrozenColumns;
+    if (frozenRow && frozenColumn)
+        return frozenCornerContainer;
+    if (frozenRow)
+        return frozenRowsContainer;
+    if (frozenColumn)
+        return frozenColumnsContainer;
+    return nullptr;
 }
 
-void QQuickTableViewPrivate::updateAverageSize()
+void QQuickTableViewPrivate::updateFrozenContainers()
 {
-    if (visibleItems.isEmpty())
+    Q_Q(QQuickTableView);
+
+    if ((loadedFrozenRows > 0 || loadedFrozenColumns > 0) && !frozenRowsContainer) {
+        // Stack the frozen cells on top of the others, and the corner on top of both
+        frozenRowsContainer = new QQuickItem(q->contentItem());
+        frozenRowsContainer->setZ(2);
+        frozenColumnsContainer = new QQuickItem(q->contentItem());
+        frozenColumnsContainer->setZ(2);
+        frozenCornerContainer = new QQuickItem(q->contentItem());
+        frozenCornerContainer->setZ(3);
+    }
+
+    if (!frozenRowsContainer)
         return;
 
-    QSizeF sum;
-    for (FxViewItem *item : qAsConst(visibleItems))
-        sum += QSizeF(item->itemWidth(), item->itemHeight());
+    // Don't pin the cells while the view is overshooting the start of the content
+    const qreal x = qMax(qreal(0), q->contentX());
+    const qreal y = qMax(qreal(0), q->contentY());
+    frozenRowsContainer->setY(y);
+    frozenColumnsContainer->setX(x);
+    frozenCornerContainer->setPosition(QPointF(x, y));
+}
 
-    averageSize.setWidth(qRound(sum.width() / visibleItems.count()));
-    averageSize.setHeight(qRound(sum.height() / visibleItems.count()));
+QRectF QQuickTableViewPrivate::bodyRect(const QRectF &viewport) const
+{
+    // The part of the viewport that is not covered by frozen rows and columns
+    const qreal frozenWidth = columnWidths.position(loadedFrozenColumns);
+    const qreal frozenHeight = rowHeights.position(loadedFrozenRows);
+    return viewport.adjusted(frozenWidth, frozenHeight, 0, 0);
 }
 
-QSizeF QQuickTableViewPrivate::size() const
+FxViewItem *QQuickTableViewPrivate::visibleItem(int modelIndex) const
 {
-    Q_Q(const QQuickTableView);
-    return orientation == QQuickTableView::Vertical ? QSizeF(q->width(), q->height()) : QSizeF(q->height(), q->width());
+    const int row = rowAtIndex(modelIndex);
+    const int column = columnAtIndex(modelIndex);
+    if (cellSpans.isEmpty())
+        return visibleItemAt(row, column);
+
+    // Cells covered by a span have no item of their own. The top-left
+    // cell of a span might be unloaded while the rest of it is not.
+    const QRect span = cellSpan(row, column);
+    if (span.topLeft() != QPoint(column, row))
+        return nullptr;
+    const int loadedRow = row < loadedFrozenRows ? row : qMax(row, loadedTable.top());
+    const int loadedColumn = column < loadedFrozenColumns ? column : qMax(column, loadedTable.left());
+    return span.contains(loadedColumn, loadedRow) ? visibleItemAt(loadedRow, loadedColumn) : nullptr;
 }
 
-QPointF QQuickTableViewPrivate::position() const
+FxViewItem *QQuickTableViewPrivate::visibleItemAtPosition(qreal x, qreal y) const
 {
     Q_Q(const QQuickTableView);
-    return  orientation == QQuickTableView::Vertical ? QPointF(q->contentX(), q->contentY()) : QPointF(q->contentY(), q->contentX());
+
+    // Positions over the frozen rows and columns hit the cells pinned there,
+    // rather than the ones scrolled underneath. Those are positioned relative
+    // to their container, which follows the content position.
+    qreal cellX = x;
+    qreal cellY = y;
+    const qreal pinnedX = x - qMax(qreal(0), q->contentX());
+    const qreal pinnedY = y - qMax(qreal(0), q->contentY());
+    if (loadedFrozenColumns > 0 && pinnedX < columnWidths.position(loadedFrozenColumns))
+        cellX = pinnedX;
+    if (loadedFrozenRows > 0 && pinnedY < rowHeights.position(loadedFrozenRows))
+        cellY = pinnedY;
+
+    // Find the cell under the position, rather than asking every item. Since
+    // an item might not fill its cell, check that it actually contains the position.
+    FxTableItemSG *item = visibleItemAt(rowAtPos(cellY), columnAtPos(cellX));
+    return item && item->contains(cellX, cellY) ? item : nullptr;
 }
 
-QPointF QQuickTableViewPrivate::startPosition() const
+qreal QQuickTableViewPrivate::rowPos(int row) const
 {
-    return isContentFlowReversed() ? -lastPosition() : originPosition();
+    return rowHeights.position(row);
 }
 
-QPointF QQuickTableViewPrivate::originPosition() const
+qreal QQuickTableViewPrivate::rowHeight(int row) const
 {
-    QPointF pos;
-    if (!visibleItems.isEmpty()) {
-        FxViewItem *item = visibleItems.first();
-        pos = QPointF(item->itemX(), item->itemY());
-        if (visibleIndex > 0) {
-            pos.rx() -= columnAtIndex(visibleIndex) * (averageSize.width() + rowSpacing);
-            pos.ry() -= rowAtIndex(visibleIndex) * (averageSize.height() + columnSpacing);
-        }
+    return rowHeights.size(row);
+}
+
+qreal QQuickTableViewPrivate::columnPos(int column) const
+{
+    return columnWidths.position(column);
+}
+
+qreal QQuickTableViewPrivate::columnWidth(int column) const
+{
+    return columnWidths.size(column);
+}
+
+qreal QQuickTableViewPrivate::provideSize(const QJSValue &provider, const std::function<qreal(int)> &callback, int section)
+{
+    Q_Q(QQuickTableView);
+
+    if (callback)
+        return callback(section);
+
+    QJSValue result = QJSValue(provider).call(QJSValueList() << section);
+    if (result.isError()) {
+        qmlWarning(q) << "size provider failed:" << result.toString();
+        return -1;
+    }
+    if (!result.isNumber())
+        return -1;
+    return result.toNumber();
+}
+
+bool QQuickTableViewPrivate::measureRow(int row)
+{
+    // Returns true if the height of the row changed
+    if (rowHeights.hasSize(row) || row < 0 || row >= rowHeights.count())
+        return false;
+    if (!rowHeightCallback && !rowHeightProvider.isCallable())
+        return false;
+
+    const qreal height = provideSize(rowHeightProvider, rowHeightCallback, row);
+    if (height < 0) {
+        // Remember that the provider had no answer, and use the default height
+        rowHeights.setMeasuredSize(row, rowHeights.defaultSize());
+        return false;
+    }
+
+    const bool changed = height != rowHeights.size(row);
+    rowHeights.setMeasuredSize(row, height);
+    return changed;
+}
+
+bool QQuickTableViewPrivate::measureColumn(int column)
+{
+    // Returns true if the width of the column changed
+    if (columnWidths.hasSize(column) || column < 0 || column >= columnWidths.count())
+        return false;
+    if (!columnWidthCallback && !columnWidthProvider.isCallable())
+        return false;
+
+    const qreal width = provideSize(columnWidthProvider, columnWidthCallback, column);
+    if (width < 0) {
+        columnWidths.setMeasuredSize(column, columnWidths.defaultSize());
+        return false;
     }
-    return pos;
+
+    const bool changed = width != columnWidths.size(column);
+    columnWidths.setMeasuredSize(column, width);
+    return changed;
 }
 
-QPointF QQuickTableViewPrivate::endPosition() const
+void QQuickTableViewPrivate::syncSectionCounts()
 {
-    return isContentFlowReversed() ? -originPosition() : lastPosition();
+    Q_Q(QQuickTableView);
+    // Sizes set for rows or columns that are removed from the end are forgotten
+    rowHeights.setCount(q->rows());
+    columnWidths.setCount(q->columns());
 }
 
-QPointF QQuickTableViewPrivate::lastPosition() const
+QRectF QQuickTableViewPrivate::viewportRect() const
 {
     Q_Q(const QQuickTableView);
-    QPointF pos;
-    if (!visibleItems.isEmpty()) {
-        int invisibleCount = INT_MIN;
-        int delayRemovedCount = 0;
-        for (int i = visibleItems.count()-1; i >= 0; --i) {
-            FxViewItem *item = visibleItems.at(i);
-            if (item->index != -1) {
-                // Find the invisible count after the last visible item with known index
-                invisibleCount = model->count() - (item->index + 1 + delayRemovedCount);
-                break;
-            } else if (item->attached->delayRemove()) {
-                ++delayRemovedCount;
-            }
-        }
-        if (invisibleCount == INT_MIN) {
-            // All visible items are in delayRemove state
-            invisibleCount = model->count();
-        }
-        FxViewItem *item = *(--visibleItems.constEnd());
-        pos = QPointF(item->itemX() + item->itemWidth(), item->itemY() + item->itemHeight());
-        int columns = columnAtIndex(invisibleCount);
-        if (columns > 0)
-            pos.rx() += columnAtIndex(invisibleCount) * (averageSize.width() + columnSpacing);
-        int rows = rowAtIndex(invisibleCount);
-        if (rows > 0)
-            pos.ry() += invisibleCount * (averageSize.height() + rowSpacing);
-    } else if (model) {
-        int columns = q->columns();
-        if (columns > 0)
-            pos.setX(columns * averageSize.width() + (columns - 1) * columnSpacing);
-        int rows = q->rows();
-        if (rows > 0)
-            pos.setY(rows * averageSize.height() + (rows - 1) * rowSpacing);
-    }
-    return pos;
+    return QRectF(q->contentX(), q->contentY(), q->width(), q->height());
+}
+
+QRectF QQuickTableViewPrivate::bufferRect(const QRectF &fillRect) const
+{
+    // Unlike ListView and GridView, the buffer extends the viewport along both
+    // axes, since the table can be flicked in any direction.
+    const qreal before = bufferMode & BufferBefore ? buffer : 0;
+    const qreal after = bufferMode & BufferAfter ? buffer : 0;
+    return fillRect.adjusted(-before, -before, after, after);
+}
+
+QRectF QQuickTableViewPrivate::loadedTableRect() const
+{
+    if (loadedTable.isEmpty())
+        return QRectF();
+
+    const QPointF topLeft = itemPosition(loadedTable.top(), loadedTable.left());
+    const QPointF bottomRight(columnPos(loadedTable.right()) + columnWidth(loadedTable.right()),
+                              rowPos(loadedTable.bottom()) + rowHeight(loadedTable.bottom()));
+    return QRectF(topLeft, bottomRight);
 }
 
 QPointF QQuickTableViewPrivate::itemPosition(int row, int column) const
@@ -417,24 +724,54 @@ void QQuickTableViewPrivate::updateViewport()
 {
     Q_Q(QQuickTableView);
     QSizeF size;
-    if (isValid() || !visibleItems.isEmpty()) {
-        QPointF start = startPosition();
-        QPointF end = endPosition();
-        size.setWidth(end.x() - start.x());
-        size.setHeight(end.y() - start.y());
+    if (isValid()) {
+        syncSectionCounts();
+        size = QSizeF(columnWidths.totalSize(), rowHeights.totalSize());
     }
-    q->setContentWidth(size.width());
-    q->setContentHeight(size.height());
-}
 
-static QPointF operator+(const QPointF &pos, const QSizeF &size)
-{
-    return QPointF(pos.x() + size.width(), pos.y() + size.height());
+    // Each row and column that is measured while flicking changes the total size
+    // a little, compared to the estimate it replaces. Only follow those changes once
+    // they add up to more than a section, or the end of the table comes into view,
+    // so that Flickable doesn't need to update its extents on every frame.
+    const QRectF viewport = viewportRect();
+    if (qAbs(size.width() - q->contentWidth()) > columnWidths.estimatedSize()
+            || viewport.right() + viewport.width() >= qMin(size.width(), q->contentWidth()))
+        q->setContentWidth(size.width());
+    if (qAbs(size.height() - q->contentHeight()) > rowHeights.estimatedSize()
+            || viewport.bottom() + viewport.height() >= qMin(size.height(), q->contentHeight()))
+        q->setContentHeight(size.height());
 }
 
-static QPointF operator-(const QPointF &pos, const QSizeF &size)
+bool QQuickTableViewPrivate::updateEstimatedSizes()
 {
-    return QPointF(pos.x() + size.width(), pos.y() + size.height());
+    // Rows and columns that have not been measured yet are estimated to be as large
+    // as the average of those that have. Since that moves the rows and columns after
+    // them, the estimate is only updated while the view is at rest, and once it is
+    // off by more than a tenth. The content is moved along, so that the loaded
+    // cells stay where they are on screen.
+    Q_Q(QQuickTableView);
+    if (q->isMoving())
+        return false;
+
+    const QPointF oldPos = loadedTable.isEmpty()
+            ? QPointF() : itemPosition(loadedTable.top(), loadedTable.left());
+    const bool rowsChanged = rowHeights.updateEstimatedSize(0.1);
+    const bool columnsChanged = columnWidths.updateEstimatedSize(0.1);
+    if (!rowsChanged && !columnsChanged)
+        return false;
+    if (loadedTable.isEmpty())
+        return true;
+
+    const QPointF delta = itemPosition(loadedTable.top(), loadedTable.left()) - oldPos;
+    if (!delta.isNull()) {
+        const bool wasInViewportMoved = inViewportMoved;
+        inViewportMoved = true;
+        q->setContentX(q->contentX() + delta.x());
+        q->setContentY(q->contentY() + delta.y());
+        inViewportMoved = wasInViewportMoved;
+    }
+    layoutVisibleItems();
+    return true;
 }
 
 bool QQuickTableViewPrivate::addRemoveVisibleItems()
@@ -442,212 +779,1305 @@ bool QQuickTableViewPrivate::addRemoveVisibleItems()
     bufferPause.stop(); // ###
     currentChanges.reset(); // ###
 
-    QPointF from, to;
-    QSizeF tableViewSize = size();
-    tableViewSize.setWidth(qMax<qreal>(tableViewSize.width(), 0.0));
-    tableViewSize.setHeight(qMax<qreal>(tableViewSize.height(), 0.0));
+    // XXX: why do we update itemCount here? What is it used for? It contains the
+    // number of items in the model, which can be thousands...
+    itemCount = model->count();
+    syncSectionCounts();
+
+    bool changed = false;
+
+    // Keep at least one row and column that is not frozen. Which cells are frozen
+    // decides where they are kept, so if that changes, load all of them again.
+    const int frozenRowCount = qMax(0, qMin(frozenRows, rowHeights.count() - 1));
+    const int frozenColumnCount = qMax(0, qMin(frozenColumns, columnWidths.count() - 1));
+    if (frozenRowCount != loadedFrozenRows || frozenColumnCount != loadedFrozenColumns) {
+        releaseLoadedItems();
+        loadedFrozenRows = frozenRowCount;
+        loadedFrozenColumns = frozenColumnCount;
+        changed = true;
+    }
+    // Likewise, the spans might merge or split loaded items
+    if (spansChanged) {
+        releaseLoadedItems();
+        spansChanged = false;
+        changed = true;
+    }
+    for (int row = 0; row < loadedFrozenRows; ++row)
+        measureRow(row);
+    for (int column = 0; column < loadedFrozenColumns; ++column)
+        measureColumn(column);
+    updateFrozenContainers();
+
+    // Only the part of the viewport that is not covered by
+    // frozen rows and columns needs to be filled
+    const QRectF fillRect = bodyRect(viewportRect());
+    if (fillRect.isEmpty())
+        return changed;
+
+    const QRectF cacheRect = bufferRect(fillRect);
+
+    if (!loadedTable.isEmpty() && !loadedTableRect().intersects(fillRect)) {
+        // The viewport has moved so far that none of the loaded items are visible
+        // anymore (e.g as a result of setting contentY directly). Rather than
+        // walking the table edge by edge towards the new position, start over.
+        releaseLoadedItems();
+        changed = true;
+    } else if (pendingTableEdge && !canLoadTableEdge(Qt::Edge(int(pendingTableEdge)), cacheRect)) {
+        // The edge we were buffering has moved out of the buffer again
+        cancelPendingTableEdge();
+        changed = true;
+    }
+
+    // Unload first, so that we never create items for a strip that is about to leave the buffer
+    changed |= removeNonVisibleItems(cacheRect);
+    bool added = addVisibleItems(fillRect, false);
+
+    if (requestedIndex == -1 && buffer && bufferMode != NoBuffer) {
+        if (added) {
+            // We've already created new delegates this frame.
+            // Just schedule a buffer refill.
+            bufferPause.start();
+        } else {
+            // Fill the buffer with asynchronously incubated items. Only one item
+            // is incubated at a time, and createdItem() will refill again once it
+            // is ready, so that the buffer is filled across several frames.
+            added |= addVisibleItems(cacheRect, true);
+        }
+    }
+    changed |= added;
 
-    QPointF contentPos = position();
+    if (!loadedTable.isEmpty())
+        visibleIndex = indexAt(loadedTable.top(), loadedTable.left());
 
-    if (isContentFlowReversed()) {
-        from = -contentPos /*- displayMarginBeginning*/ - tableViewSize;
-        to = -contentPos /*+ displayMarginEnd*/;
-    } else {
-        from = contentPos /*- displayMarginBeginning*/;
-        to = contentPos /*+ displayMarginEnd*/ + tableViewSize;
+    fetchRowsAhead();
+
+    if (updateEstimatedSizes()) {
+        changed = true;
+        updateCulling(bodyRect(viewportRect()), true);
+        return changed;
     }
 
-    // XXX: why do we update itemCount here? What is it used for? It contains the
-    // number of items in the model, which can be thousands...
-    itemCount = model->count();
+    updateCulling(fillRect, changed);
 
-    // XXX: what does buffer hold? Is it the same as cacheBuffer?
-    QPointF bufferFrom = from - QPointF(buffer, buffer);
-    QPointF bufferTo = to + QPointF(buffer, buffer);
-    QPointF fillFrom = from;
-    QPointF fillTo = to;
-
-    bool added = addVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo, false);
-    bool removed = removeNonVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo);
-
-//    if (requestedIndex == -1 && buffer && bufferMode != NoBuffer) {
-//        if (added) {
-//            // We've already created a new delegate this frame.
-//            // Just schedule a buffer refill.
-//            bufferPause.start();
-//        } else {
-//            if (bufferMode & BufferAfter)
-//                fillTo = bufferTo;
-//            if (bufferMode & BufferBefore)
-//                fillFrom = bufferFrom;
-//            added |= addVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo, true);
-//        }
-//    }
-    return added || removed;
+    return changed;
 }
 
-Qt::Orientation QQuickTableViewPrivate::layoutOrientation() const
+static qreal positionViewAtSection(qreal viewPos, qreal viewSize, qreal start, qreal end, int mode)
 {
-    return static_cast<Qt::Orientation>(orientation);
+    // Returns where the view should start to show the section from start to end, like
+    // QQuickItemViewPrivate::positionViewAtIndex() does for the items of a ListView
+    switch (mode) {
+    case QQuickAbstractItemView::Center:
+        return start - (viewSize - (end - start)) / 2;
+    case QQuickAbstractItemView::End:
+        return end - viewSize;
+    case QQuickAbstractItemView::Visible:
+        if (start > viewPos + viewSize)
+            return end - viewSize;
+        if (end <= viewPos)
+            return start;
+        return viewPos;
+    case QQuickAbstractItemView::Contain:
+        if (end >= viewPos + viewSize)
+            viewPos = end - viewSize;
+        if (start < viewPos)
+            viewPos = start;
+        return viewPos;
+    default: // Beginning and SnapPosition
+        return start;
+    }
 }
 
-bool QQuickTableViewPrivate::isContentFlowReversed() const
+void QQuickTableViewPrivate::positionViewAtIndex(int index, int mode)
 {
-    return isRightToLeft() || isBottomToTop();
+    Q_Q(QQuickTableView);
+    if (mode < QQuickAbstractItemView::Beginning || mode > QQuickAbstractItemView::SnapPosition)
+        return;
+
+    // positionViewAtBeginning() and positionViewAtEnd() ask for the indices just outside the model
+    if (index < 0)
+        setViewportPosition(QPointF(q->originX() - q->leftMargin(), q->originY() - q->topMargin()));
+    else if (index >= model->count())
+        setViewportPosition(QPointF(columnWidths.totalSize(), rowHeights.totalSize()));
+    else if (q->columns() > 0)
+        positionViewAtCell(index / q->columns(), index % q->columns(), mode);
 }
 
-void QQuickTableViewPrivate::visibleItemsChanged()
+void QQuickTableViewPrivate::positionViewAtCell(int row, int column, int mode)
 {
-//    if (!visibleItems.isEmpty())
-//        visiblePos = itemPosition(*visibleItems.constBegin());
-    updateAverageSize();
+    Q_Q(QQuickTableView);
+    if (mode < QQuickAbstractItemView::Beginning || mode > QQuickAbstractItemView::SnapPosition)
+        return;
+
+    applyPendingChanges();
+    syncSectionCounts();
+    if (row < 0 || row >= rowHeights.count() || column < 0 || column >= columnWidths.count())
+        return;
+
+    // The geometry of the target comes straight from the section sizes, so it
+    // doesn't matter how far away it is from the cells that are loaded now.
+    const QRect span = cellSpan(row, column);
+    for (int r = span.top(); r <= span.bottom(); ++r)
+        measureRow(r);
+    for (int c = span.left(); c <= span.right(); ++c)
+        measureColumn(c);
+
+    // Frozen rows and columns are always in view, and cover the start of the viewport
+    const QRectF viewport = viewportRect();
+    const QRectF body = bodyRect(viewport);
+    QPointF pos = viewport.topLeft();
+    if (span.left() >= loadedFrozenColumns) {
+        const qreal bodyX = positionViewAtSection(body.x(), body.width(),
+                columnWidths.position(span.left()), columnWidths.endPosition(span.right()), mode);
+        pos.setX(bodyX - (body.x() - viewport.x()));
+    }
+    if (span.top() >= loadedFrozenRows) {
+        const qreal bodyY = positionViewAtSection(body.y(), body.height(),
+                rowHeights.position(span.top()), rowHeights.endPosition(span.bottom()), mode);
+        pos.setY(bodyY - (body.y() - viewport.y()));
+    }
+
+    q->cancelFlick();
+    setViewportPosition(pos);
 }
 
-FxViewItem *QQuickTableViewPrivate::newViewItem(int index, QQuickItem *item)
+void QQuickTableViewPrivate::setViewportPosition(const QPointF &pos)
 {
+    // Moves the viewport in one go. Rather than refilling the table for each
+    // of the two axes, or walking it edge by edge towards the new position,
+    // the table is loaded for the new viewport only, in the next polish.
+    // The position is bound to the extents Flickable allows, which include the margins.
     Q_Q(QQuickTableView);
-    Q_UNUSED(index);
-    return new FxTableItemSG(item, q, false);
+    syncSectionCounts();
+    const QPointF minPos(q->originX() - q->leftMargin(), q->originY() - q->topMargin());
+    const QPointF maxPos(qMax(minPos.x(), q->originX() + columnWidths.totalSize() + q->rightMargin() - q->width()),
+                         qMax(minPos.y(), q->originY() + rowHeights.totalSize() + q->bottomMargin() - q->height()));
+    const QPointF newPos(qBound(minPos.x(), pos.x(), maxPos.x()),
+                         qBound(minPos.y(), pos.y(), maxPos.y()));
+    const QRectF newViewport(newPos, q->size());
+    if (newViewport.topLeft() == viewportRect().topLeft())
+        return;
+
+    if (!loadedTable.isEmpty() && !loadedTableRect().intersects(bufferRect(bodyRect(newViewport))))
+        releaseLoadedItems();
+
+    const bool wasInViewportMoved = inViewportMoved;
+    inViewportMoved = true;
+    q->setContentX(newPos.x());
+    q->setContentY(newPos.y());
+    inViewportMoved = wasInViewportMoved;
+    forceLayoutPolish();
 }
 
-void QQuickTableViewPrivate::createAndPositionItem(int row, int col, bool doBuffer)
+qreal QQuickTableViewPrivate::implicitCellWidth(int row, int column)
 {
-    int modelIndex = indexAt(row, col);
-    FxTableItemSG *item = static_cast<FxTableItemSG *>(createItem(modelIndex, doBuffer));
+    // Cells that are not loaded get an item just for asking. It is released
+    // right away, and ends up in the reuse pool if reuseItems is set.
+    const int modelIndex = indexAt(row, column);
+    if (modelIndex == -1 || modelIndex == requestedIndex)
+        return 0;
+
+    if (isLoadedCell(row, column)) {
+        FxTableItemSG *item = visibleItemAt(row, column);
+        return item && item->item ? item->item->implicitWidth() : 0;
+    }
+
+    FxViewItem *item = createItem(modelIndex, false);
     if (!item)
+        return 0;
+    const qreal width = item->item->implicitWidth();
+    releaseItem(item);
+    return width;
+}
+
+void QQuickTableViewPrivate::resizeColumnToContents(int column)
+{
+    Q_Q(QQuickTableView);
+    applyPendingChanges();
+    syncSectionCounts();
+    if (column < 0 || column >= columnWidths.count()) {
+        qmlWarning(q) << "resizeColumnToContents: column out of range:" << column;
         return;
+    }
 
-    QPointF itemPos = itemPosition(row, col);
-    if (!transitioner || !transitioner->canTransition(QQuickItemViewTransitioner::PopulateTransition, true))
-        item->setPosition(itemPos, true);
+    // A cell that spans several columns doesn't tell how wide this one should be
+    const auto isSpanned = [this, column](int row) { return cellSpan(row, column).width() > 1; };
+    const bool measureText = !autoFitTextRole.isEmpty() && model;
+
+    // The loaded cells are always looked at, since their items exist already. When
+    // measuring text, they also tell how much wider the delegate is than its text.
+    qreal loadedWidth = 0;
+    qreal padding = 0;
+    if (isLoadedCell(loadedTable.top(), column)) {
+        QVector<int> loadedRows;
+        for (int row = 0; row < loadedFrozenRows; ++row)
+            loadedRows.append(row);
+        for (int row = loadedTable.top(); row <= loadedTable.bottom(); ++row)
+            loadedRows.append(row);
+        for (int row : qAsConst(loadedRows)) {
+            if (isSpanned(row))
+                continue;
+            const qreal width = implicitCellWidth(row, column);
+            loadedWidth = qMax(loadedWidth, width);
+            if (measureText) {
+                const QString text = model->stringValue(indexAt(row, column), autoFitTextRole);
+                padding = qMax(padding, width - QQuickTableViewTextMeasurer::textWidth(autoFitFont, text));
+            }
+        }
+    }
 
-    if (item->item)
-        QQuickItemPrivate::get(item->item)->setCulled(doBuffer);
+    // The other rows are sampled evenly over the whole table
+    const int rowCount = rowHeights.count();
+    const int sampleCount = qMin(autoFitSampleSize, rowCount);
+    QVector<int> sampleRows;
+    sampleRows.reserve(sampleCount);
+    for (int i = 0; i < sampleCount; ++i) {
+        const int row = int(qint64(i) * rowCount / sampleCount);
+        if (!isLoadedCell(row, column) && !isSpanned(row))
+            sampleRows.append(row);
+    }
 
-    visibleItems.append(item);
+    if (measureText) {
+        QStringList texts;
+        texts.reserve(sampleRows.count());
+        for (int row : qAsConst(sampleRows))
+            texts.append(model->stringValue(indexAt(row, column), autoFitTextRole));
 
-    qCDebug(lcItemViewDelegateLifecycle) << "index:" << modelIndex
-                                         << "row:" << row
-                                         << "col:" << col
-                                         << "pos:" << itemPos
-                                         << "buffer:" << doBuffer
-                                         << "item:" << (QObject *)(item->item)
-                                            ;
+        if (!autoFitGuard) {
+            autoFitGuard.reset(new QQuickTableViewAutoFitGuard);
+            autoFitGuard->view = q;
+        }
+        const int requestId = ++autoFitRequestId;
+        autoFitRequests.insert(column, requestId);
+        autoFitColumns.remove(column);
+        QQuickTableViewTextMeasurer *measurer = new QQuickTableViewTextMeasurer(
+                autoFitGuard, column, requestId, autoFitFont, texts, padding, loadedWidth);
+        if (QFontDatabase::supportsThreadedFontRendering()) {
+            textMeasurerPool()->start(measurer);
+        } else {
+            // The result is still applied from the event loop, the same as
+            // when it's measured in a worker thread
+            measurer->run();
+            delete measurer;
+        }
+        return;
+    }
+
+    // Any text measurement still running for the column is outdated now
+    autoFitRequests.remove(column);
+    QQuickTableViewAutoFitColumn &autoFitColumn = autoFitColumns[column];
+    autoFitColumn.rows = sampleRows;
+    autoFitColumn.width = loadedWidth;
+    forceLayoutPolish();
+}
+
+void QQuickTableViewPrivate::measureAutoFitColumns()
+{
+    // Creating a delegate for each sampled row could take long enough to
+    // drop frames, so only do it for as long as QML_TABLEVIEW_AUTOFITTIME,
+    // and leave the rest to the next polish. The widths found are applied
+    // by the layout that follows.
+    Q_Q(QQuickTableView);
+    if (autoFitColumns.isEmpty())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (auto it = autoFitColumns.begin(); it != autoFitColumns.end();) {
+        const int column = it.key();
+        QQuickTableViewAutoFitColumn &autoFitColumn = it.value();
+        while (!autoFitColumn.rows.isEmpty() && timer.elapsed() < QML_TABLEVIEW_AUTOFITTIME)
+            autoFitColumn.width = qMax(autoFitColumn.width, implicitCellWidth(autoFitColumn.rows.takeLast(), column));
+        if (!autoFitColumn.rows.isEmpty()) {
+            // Polishing again right away would measure the rest in the same frame
+            QMetaObject::invokeMethod(q, [this] { forceLayoutPolish(); }, Qt::QueuedConnection);
+            return;
+        }
+
+        if (autoFitColumn.width > 0 && column < columnWidths.count())
+            columnWidths.setSize(column, autoFitColumn.width);
+        it = autoFitColumns.erase(it);
+    }
 }
 
-bool QQuickTableViewPrivate::addVisibleItems(const QPointF &fillFrom, const QPointF &fillTo,
-                                             const QPointF &bufferFrom, const QPointF &bufferTo, bool doBuffer)
+void QQuickTableViewPrivate::applyAutoFitWidth(int column, int requestId, qreal width)
 {
-    Q_UNUSED(bufferFrom);
-    Q_UNUSED(bufferTo);
+    if (autoFitRequests.value(column, -1) != requestId)
+        return;
+
+    autoFitRequests.remove(column);
+    syncSectionCounts();
+    if (column >= columnWidths.count() || width <= 0)
+        return;
+
+    columnWidths.setSize(column, width);
+    forceLayoutPolish();
+}
 
-    if ((fillFrom - fillTo).isNull())
+bool QQuickTableViewPrivate::applyModelChanges()
+{
+    Q_Q(QQuickTableView);
+    if (!q->isComponentComplete() || !hasPendingChanges())
         return false;
 
-    if (true) {
-        // Remove all items each time for now
-        for (FxViewItem *item : visibleItems)
-            releaseItem(item);
+    if (bufferedChanges.hasPendingChanges()) {
+        currentChanges.applyBufferedChanges(bufferedChanges);
+        bufferedChanges.reset();
+    }
 
-        releaseItem(currentItem);
-        currentItem = 0;
-        visibleItems.clear();
+    updateUnrequestedIndexes();
+    moveReason = QQuickAbstractItemViewPrivate::Other;
+
+    // An edge in the middle of being loaded would end up with cells
+    // from different rows, so just load it again later.
+    cancelPendingTableEdge();
+
+    const int prevItemCount = itemCount;
+    const int columns = q->columns();
+    const QVector<QQmlChangeSet::Change> &removals = currentChanges.pendingChanges.removes();
+    const QVector<QQmlChangeSet::Change> &insertions = currentChanges.pendingChanges.inserts();
+    bool visibleAffected = false;
+    qreal contentYAdjustment = 0;
+
+    // QQmlDelegateModel inserts and removes whole rows as one range of cells. Anything
+    // else, like a change in the number of columns, changes the index of every cell.
+    // Changes to the frozen rows are rare enough to not deal with them separately.
+    bool rowChangesOnly = columns > 0 && columns == columnWidths.count();
+    for (const QQmlChangeSet::Change &removal : removals)
+        rowChangesOnly &= columns > 0 && removal.index % columns == 0 && removal.count % columns == 0
+                && removal.index / columns >= loadedFrozenRows;
+    for (const QQmlChangeSet::Change &insertion : insertions)
+        rowChangesOnly &= columns > 0 && insertion.index % columns == 0 && insertion.count % columns == 0
+                && insertion.index / columns >= loadedFrozenRows;
+
+    if (rowChangesOnly) {
+        // The spans move along with the rows. Items that span rows cannot be
+        // moved or cut row by row though, so if the rows of any of them change,
+        // the table is loaded again.
+        for (const QQmlChangeSet::Change &removal : removals) {
+            const int row = removal.index / columns;
+            itemCount -= removal.count;
+            if (!cellSpans.isEmpty() && spansLoadedRows(row)) {
+                releaseLoadedItems();
+                visibleAffected = true;
+            }
+            cellSpans.removeRows(row, removal.count / columns);
+            if (removeRows(row, removal.count / columns, &contentYAdjustment))
+                visibleAffected = true;
+        }
+        for (const QQmlChangeSet::Change &insertion : insertions) {
+            const int row = insertion.index / columns;
+            itemCount += insertion.count;
+            if (!cellSpans.isEmpty() && spansLoadedRows(row)) {
+                releaseLoadedItems();
+                visibleAffected = true;
+            }
+            cellSpans.insertRows(row, insertion.count / columns);
+            if (insertRows(row, insertion.count / columns, &contentYAdjustment))
+                visibleAffected = true;
+        }
+    } else if (!removals.isEmpty() || !insertions.isEmpty()) {
+        qCDebug(lcItemViewDelegateLifecycle) << "reload all cells";
+        itemCount = model->count();
+        releaseLoadedItems();
+        visibleAffected = true;
     }
 
-//    Q_Q(QQuickTableView);
+    if (columns > 0) {
+        for (const QQmlChangeSet::Change &change : currentChanges.pendingChanges.changes())
+            invalidateChangedSections(change, columns);
+    }
 
-    // For simplicity, we assume that we always specify the number of rows and columns directly
-    // in TableView. But we should also allow those properties to be unspecified, and if so, get
-    // the counts from the model instead. In addition, the counts might change inbetween two calls
-    // to this function, which might cause previousBottomRow and previousRightColumn to end up wrong!
-    // So we should probably store the last values used to be certain.
-    int rowCount = rows;
-    int columnCount = columns;
-
-    QPointF previousVisiblePos = visiblePos;
-    int previousBottomRow = qMin(rowAtPos(previousVisiblePos.y() + height), rowCount - 1);
-    int previousRightColumn = qMin(columnAtPos(previousVisiblePos.x() + width), columnCount - 1);
-
-    visiblePos = fillFrom;
-    int currentTopRow = rowAtPos(visiblePos.y());
-    int currentBottomRow = qMin(rowAtPos(visiblePos.y() + height), rowCount - 1);
-    int currentLeftColumn = columnAtPos(visiblePos.x());
-    int currentRightColumn = qMin(columnAtPos(visiblePos.x() + width), columnCount - 1);
-
-    if (visibleItems.isEmpty()) {
-        // Fill the whole table
-        previousBottomRow = currentTopRow - 1;
-        previousRightColumn = currentLeftColumn - 1;
-    }
-
-    qCDebug(lcItemViewDelegateLifecycle) << "\n\tfrom:" << fillFrom
-                                         << "to:" << fillTo
-                                         << "\n\tbufferFrom:" << bufferFrom
-                                         << "bufferTo:" << bufferFrom
-                                         << "\n\tpreviousBottomRow:" << previousBottomRow
-                                         << "currentBottomRow:" << currentBottomRow
-                                         << "\n\tpreviousRightColumn:" << previousRightColumn
-                                         << "currentRightColumn:" << currentRightColumn;
-
-    // Fill in missing columns for already existsing rows
-    for (int row = currentTopRow; row <= previousBottomRow; ++row) {
-        for (int col = previousRightColumn + 1; col <= currentRightColumn; ++col) {
-            createAndPositionItem(row, col, doBuffer);
+    if (currentChanges.currentChanged) {
+        if (currentChanges.currentRemoved && currentItem) {
+            if (currentItem->item && currentItem->attached)
+                currentItem->attached->setIsCurrentItem(false);
+            releaseItem(currentItem);
+            currentItem = 0;
         }
+        if (!currentIndexCleared)
+            updateCurrent(currentChanges.newCurrentIndex);
     }
 
-    // Fill in missing rows at the bottom
-    for (int row = previousBottomRow + 1; row <= currentBottomRow; ++row) {
-        for (int col = currentLeftColumn; col <= currentRightColumn; ++col) {
-            createAndPositionItem(row, col, doBuffer);
-        }
+    if (!visibleAffected)
+        visibleAffected = !currentChanges.pendingChanges.changes().isEmpty();
+    currentChanges.reset();
+
+    if (prevItemCount != itemCount)
+        emit q->countChanged();
+
+    updateViewport();
+
+    // Rows inserted or removed above the loaded ones should not move the
+    // rows the user is looking at. Unless the user is moving the view, since
+    // setting the content position would stop the movement.
+    if (!qFuzzyIsNull(contentYAdjustment) && !q->isMoving())
+        q->setContentY(q->contentY() + contentYAdjustment);
+
+    return visibleAffected;
+}
+
+bool QQuickTableViewPrivate::insertRows(int row, int count, qreal *contentYAdjustment)
+{
+    // Returns true if the inserted rows affect the loaded ones
+    if (count <= 0)
+        return false;
+
+    if (loadedTable.isEmpty()) {
+        rowHeights.insertSections(row, count);
+        return false;
+    }
+
+    if (row > loadedTable.bottom() + 1) {
+        // Below the loaded rows. They will be loaded when flicked into view.
+        rowHeights.insertSections(row, count);
+        return false;
+    }
+
+    // Rows inserted at the top of the table while the top row is loaded are
+    // shown, rows inserted anywhere else above the loaded rows are not.
+    if (row < loadedTable.top() || (row == loadedTable.top() && row > loadedFrozenRows)) {
+        moveLoadedRows(loadedTable.top(), count);
+        loadedTable.translate(0, count);
+        rowHeights.insertSections(row, count);
+        *contentYAdjustment += rowHeights.position(row + count) - rowHeights.position(row);
+        return false;
     }
 
-    // Next:
-    // - fill top and left.
-    // - don't refill a cell if the item for that cell has already been created
+    qCDebug(lcItemViewDelegateLifecycle) << "insert rows:" << row << "count:" << count << "loaded table:" << loadedTable;
+
+    // The inserted rows push the loaded rows below them further down. If those
+    // are still inside the buffer, keep them, and fill the gap with new cells.
+    // Otherwise there is no point in keeping them, so release them instead,
+    // and let the refill load as many of the new rows as fit.
+    rowHeights.insertSections(row, count);
+    const QRectF cacheRect = bufferRect(viewportRect());
+    if (row <= loadedTable.bottom() && rowHeights.position(row + count) < cacheRect.bottom()) {
+        moveLoadedRows(row, count);
+        loadedTable.setBottom(loadedTable.bottom() + count);
+        for (int r = row; r < row + count; ++r) {
+            measureRow(r);
+            bool created = true;
+            for (int column = 0; created && column < loadedFrozenColumns; ++column)
+                created = loadCell(r, column, false);
+            for (int column = loadedTable.left(); created && column <= loadedTable.right(); ++column)
+                created = loadCell(r, column, false);
+            if (!created) {
+                // A cell is still being incubated, which cannot be waited
+                // for in the middle of the table, so start over
+                releaseLoadedItems();
+                return true;
+            }
+        }
+    } else if (row <= loadedTable.bottom()) {
+        if (row == loadedTable.top()) {
+            // Nothing would be left, so start over from the inserted rows
+            releaseLoadedItems();
+            return true;
+        }
+        releaseLoadedRows(row, loadedTable.bottom());
+        loadedTable.setBottom(row - 1);
+    }
 
-    // ### TODO: Handle items that should be prepended
-    // ### TODO: Don't always return true
     return true;
 }
 
-bool QQuickTableViewPrivate::removeNonVisibleItems(const QPointF &fillFrom, const QPointF &fillTo,
-                                                   const QPointF &bufferFrom, const QPointF &bufferTo)
+bool QQuickTableViewPrivate::removeRows(int row, int count, qreal *contentYAdjustment)
 {
-    Q_UNUSED(bufferFrom);
-    Q_UNUSED(bufferTo);
-    return false;
+    // Returns true if the removed rows affect the loaded ones
+    if (count <= 0)
+        return false;
+
+    const int end = row + count;
+    bool affected = false;
+
+    if (loadedTable.isEmpty() || row > loadedTable.bottom()) {
+        // Nothing loaded, or below the loaded rows
+    } else if (end <= loadedTable.top()) {
+        // Above the loaded rows, so move them up without moving them on screen
+        *contentYAdjustment -= rowHeights.position(end) - rowHeights.position(row);
+        moveLoadedRows(loadedTable.top(), -count);
+        loadedTable.translate(0, -count);
+    } else {
+        qCDebug(lcItemViewDelegateLifecycle) << "remove rows:" << row << "count:" << count << "loaded table:" << loadedTable;
+        affected = true;
+        // The part of the removed rows that is above the loaded rows does not
+        // move them on screen either
+        if (row < loadedTable.top())
+            *contentYAdjustment -= rowHeights.position(loadedTable.top()) - rowHeights.position(row);
+        const int top = qMin(loadedTable.top(), row);
+        const int bottom = loadedTable.bottom() >= end ? loadedTable.bottom() - count : row - 1;
+        if (top > bottom) {
+            releaseLoadedItems();
+        } else {
+            releaseLoadedRows(qMax(row, loadedTable.top()), qMin(end - 1, loadedTable.bottom()));
+            moveLoadedRows(end, -count);
+            loadedTable.setTop(top);
+            loadedTable.setBottom(bottom);
+        }
+    }
+
+    rowHeights.removeSections(row, count);
+    return affected;
 }
 
-QQuickTableView::QQuickTableView(QQuickItem *parent)
-    : QQuickAbstractItemView(*(new QQuickTableViewPrivate), parent)
+bool QQuickTableViewPrivate::spansLoadedRows(int row) const
 {
+    // Returns true if inserting or removing rows at row would move or resize
+    // a loaded item that spans rows. Only called for tables with spans.
+    if (loadedTable.isEmpty())
+        return false;
+    if (row <= loadedTable.bottom())
+        return true;
+
+    // Below the loaded rows, only spans that reach down from them are affected
+    const auto reachesRow = [&](int column) {
+        const FxTableItemSG *item = visibleItemAt(loadedTable.bottom(), column);
+        return item && item->row + item->rowSpan > row;
+    };
+    for (int column = 0; column < loadedFrozenColumns; ++column) {
+        if (reachesRow(column))
+            return true;
+    }
+    for (int column = loadedTable.left(); column <= loadedTable.right(); ++column) {
+        if (reachesRow(column))
+            return true;
+    }
+    return false;
 }
 
-int QQuickTableView::rows() const
+void QQuickTableViewPrivate::releaseLoadedRows(int fromRow, int toRow)
 {
-    Q_D(const QQuickTableView);
-    if (QQmlDelegateModel *delegateModel = qobject_cast<QQmlDelegateModel *>(d->model.data()))
-        return delegateModel->rows();
-    return qMax(0, d->rows);
+    QVector<FxViewItem *> releasedItems;
+    for (int row = fromRow; row <= toRow; ++row) {
+        for (int column = 0; column < loadedFrozenColumns; ++column) {
+            if (FxViewItem *item = frozenColumnItems.take(row, column))
+                releasedItems.append(item);
+        }
+        for (int column = loadedTable.left(); column <= loadedTable.right(); ++column) {
+            if (FxViewItem *item = loadedItems.take(row, column))
+                releasedItems.append(item);
+        }
+    }
+
+    // Not called while the table has spans (see applyModelChanges()), so every
+    // item is only taken once
+    releaseTableItems(releasedItems);
 }
 
-void QQuickTableView::setRows(int rows)
+void QQuickTableViewPrivate::moveLoadedRows(int fromRow, int delta)
 {
-    Q_D(QQuickTableView);
-    if (d->rows == rows)
-        return;
+    // Moves the loaded items on fromRow and below delta rows down (or up).
+    // Their model indexes have already been updated by the model.
+    const int columns = columnWidths.count();
+    QVector<FxTableItemSG *> movedItems;
+    for (FxViewItem *item : qAsConst(visibleItems)) {
+        FxTableItemSG *tableItem = static_cast<FxTableItemSG *>(item);
+        if (tableItem->row < fromRow)
+            continue;
+        cellGrid(tableItem->row, tableItem->column).take(tableItem->row, tableItem->column);
+        movedItems.append(tableItem);
+    }
 
-    d->rows = rows;
-    if (d->componentComplete && d->model && d->ownModel)
-        static_cast<QQmlDelegateModel *>(d->model.data())->setRows(rows);
-    emit rowsChanged();
+    for (FxTableItemSG *item : qAsConst(movedItems)) {
+        item->row += delta;
+        item->index += delta * columns;
+        cellGrid(item->row, item->column).insert(item->row, item->column, item);
+    }
 }
 
-void QQuickTableView::resetRows()
+void QQuickTableViewPrivate::invalidateChangedSections(const QQmlChangeSet::Change &change, int columns)
 {
-    Q_D(QQuickTableView);
+    // A size provider might give a different answer for a row or column
+    // once its data has changed, so ask it again for the loaded ones.
+    if (loadedTable.isEmpty() || change.count <= 0)
+        return;
+
+    const int changeFirstRow = change.index / columns;
+    const int changeLastRow = (change.index + change.count - 1) / columns;
+    int changeFirstColumn = 0;
+    int changeLastColumn = columns - 1;
+    if (changeFirstRow == changeLastRow) {
+        changeFirstColumn = change.index % columns;
+        changeLastColumn = (change.index + change.count - 1) % columns;
+    }
+
+    // The frozen rows and columns are loaded in addition to loadedTable
+    const auto changedRows = [&](int first, int last) {
+        return qMax(changeFirstRow, first) <= qMin(changeLastRow, last);
+    };
+    if (!changedRows(0, loadedFrozenRows - 1) && !changedRows(loadedTable.top(), loadedTable.bottom()))
+        return;
+
+    for (int row = changeFirstRow; row <= changeLastRow; ++row) {
+        if (isLoadedCell(row, loadedTable.left()) && rowHeights.isMeasured(row))
+            rowHeights.resetSize(row);
+    }
+    for (int column = changeFirstColumn; column <= changeLastColumn; ++column) {
+        if (isLoadedCell(loadedTable.top(), column) && columnWidths.isMeasured(column))
+            columnWidths.resetSize(column);
+    }
+}
+
+void QQuickTableViewPrivate::recreateVisibleItems()
+{
+    clearCellGrids();
+    loadedTable = QRect();
+    visibleTable = QRect();
+    pendingTableEdge = Qt::Edges();
+    pendingEdgeCellCount = 0;
+    QQuickAbstractItemViewPrivate::recreateVisibleItems();
+}
+
+Qt::Orientation QQuickTableViewPrivate::layoutOrientation() const
+{
+    return static_cast<Qt::Orientation>(orientation);
+}
+
+bool QQuickTableViewPrivate::isContentFlowReversed() const
+{
+    // The table is always laid out left to right and top to bottom
+    return false;
+}
+
+void QQuickTableViewPrivate::clear()
+{
+    clearCellGrids();
+    QQuickAbstractItemViewPrivate::clear();
+    loadedTable = QRect();
+    visibleTable = QRect();
+    pendingTableEdge = Qt::Edges();
+    pendingEdgeCellCount = 0;
+}
+
+void QQuickTableViewPrivate::layoutVisibleItems(int fromModelIndex)
+{
+    Q_UNUSED(fromModelIndex);
+    measureAutoFitColumns();
+
+    if (!loadedTable.isEmpty()) {
+        syncSectionCounts();
+        for (int row = loadedTable.top(); row <= loadedTable.bottom(); ++row)
+            measureRow(row);
+        for (int column = loadedTable.left(); column <= loadedTable.right(); ++column)
+            measureColumn(column);
+        for (int row = 0; row < loadedFrozenRows; ++row)
+            measureRow(row);
+        for (int column = 0; column < loadedFrozenColumns; ++column)
+            measureColumn(column);
+    }
+
+    // Sizes or spacing might have changed, so move the loaded items to their
+    // new positions. Any edges that enter or leave the viewport as a result
+    // will be loaded or unloaded by the refill that follows.
+    for (FxViewItem *item : qAsConst(visibleItems)) {
+        FxTableItemSG *tableItem = static_cast<FxTableItemSG *>(item);
+        tableItem->setPosition(itemPosition(tableItem->row, tableItem->column), true);
+        resizeSpanningItem(tableItem);
+    }
+}
+
+FxViewItem *QQuickTableViewPrivate::newViewItem(int index, QQuickItem *item)
+{
+    Q_Q(QQuickTableView);
+    Q_UNUSED(index);
+    return new FxTableItemSG(item, q, false);
+}
+
+void QQuickTableViewPrivate::invalidateLayout()
+{
+    // The providers might give different answers now, so forget what they
+    // said before. Loaded rows and columns are asked again by the layout
+    // that follows, the rest once they are loaded.
+    rowHeights.resetMeasuredSizes();
+    columnWidths.resetMeasuredSizes();
+    forceLayout = true;
+}
+
+FxTableItemSG *QQuickTableViewPrivate::createAndPositionItem(int row, int col, bool doBuffer)
+{
+    // A cell covered by a span shows the item of the span, which
+    // is created for its top-left cell, unless it's already loaded.
+    const QRect span = cellSpan(row, col);
+    if (span.width() > 1 || span.height() > 1) {
+        if (FxTableItemSG *item = loadedSpanItem(span, row, col)) {
+            cellGrid(row, col).insert(row, col, item);
+            return item;
+        }
+    }
+
+    const int modelIndex = indexAt(span.top(), span.left());
+    if (modelIndex == -1)
+        return nullptr;
+    FxTableItemSG *item = static_cast<FxTableItemSG *>(createItem(modelIndex, doBuffer));
+    if (!item)
+        return nullptr;
+
+    item->row = span.top();
+    item->column = span.left();
+    item->rowSpan = span.height();
+    item->columnSpan = span.width();
+    cellGrid(row, col).insert(row, col, item);
+    if (QQuickItem *container = frozenContainer(row, col)) {
+        if (item->item)
+            item->item->setParentItem(container);
+    }
+
+    QPointF itemPos = itemPosition(item->row, item->column);
+    if (!transitioner || !transitioner->canTransition(QQuickItemViewTransitioner::PopulateTransition, true))
+        item->setPosition(itemPos, true);
+    resizeSpanningItem(item);
+
+    if (item->item)
+        QQuickItemPrivate::get(item->item)->setCulled(doBuffer);
+
+    visibleItems.append(item);
+
+    qCDebug(lcItemViewDelegateLifecycle) << "index:" << modelIndex
+                                         << "row:" << row
+                                         << "col:" << col
+                                         << "pos:" << itemPos
+                                         << "buffer:" << doBuffer
+                                         << "item:" << (QObject *)(item->item)
+                                            ;
+    return item;
+}
+
+bool QQuickTableViewPrivate::loadCell(int row, int column, bool doBuffer)
+{
+    // Returns false if the item of the cell is still being incubated, in which
+    // case createdItem() refills once it is ready. An item that could not be
+    // created at all (e.g because the delegate is not an Item) leaves the cell
+    // empty, rather than holding up the rest of the table for good.
+    if (createAndPositionItem(row, column, doBuffer))
+        return true;
+
+    const QRect span = cellSpan(row, column);
+    const int modelIndex = indexAt(span.top(), span.left());
+    if (modelIndex != -1 && model->incubationStatus(modelIndex) == QQmlIncubator::Loading)
+        return false;
+
+    // createItem() expects a requested index to be delivered through createdItem()
+    if (modelIndex != -1 && requestedIndex == modelIndex)
+        requestedIndex = -1;
+    qCDebug(lcItemViewDelegateLifecycle) << "failed to create cell:" << row << column;
+    return true;
+}
+
+FxTableItemSG *QQuickTableViewPrivate::loadedSpanItem(const QRect &span, int row, int column) const
+{
+    // The loaded cells of a span always form a block, and a cell is only loaded
+    // next to other loaded cells. So if the item of the span is loaded, one of
+    // the neighbours of the cell inside the span is loaded as well.
+    static const QPoint neighbours[] = { QPoint(0, -1), QPoint(0, 1), QPoint(-1, 0), QPoint(1, 0) };
+    for (const QPoint &offset : neighbours) {
+        const QPoint cell = QPoint(column, row) + offset;
+        if (!span.contains(cell))
+            continue;
+        if (FxTableItemSG *item = visibleItemAt(cell.y(), cell.x()))
+            return item;
+    }
+    return nullptr;
+}
+
+void QQuickTableViewPrivate::resizeSpanningItem(FxTableItemSG *item)
+{
+    // Items of single cells keep the size given by the delegate, but a
+    // spanning item is made to cover its cells and the spacing between them
+    if (!item->item || (item->rowSpan == 1 && item->columnSpan == 1))
+        return;
+
+    const int lastRow = item->row + item->rowSpan - 1;
+    const int lastColumn = item->column + item->columnSpan - 1;
+    item->item->setSize(QSizeF(columnWidths.endPosition(lastColumn) - columnPos(item->column),
+                               rowHeights.endPosition(lastRow) - rowPos(item->row)));
+}
+
+bool QQuickTableViewPrivate::canLoadTableEdge(Qt::Edge tableEdge, const QRectF &fillRect) const
+{
+    Q_Q(const QQuickTableView);
+
+    switch (tableEdge) {
+    case Qt::LeftEdge:
+        if (loadedTable.left() <= loadedFrozenColumns)
+            return false;
+        return columnPos(loadedTable.left() - 1) + columnWidth(loadedTable.left() - 1) > fillRect.left();
+    case Qt::RightEdge:
+        if (loadedTable.right() >= q->columns() - 1)
+            return false;
+        return columnPos(loadedTable.right() + 1) < fillRect.right();
+    case Qt::TopEdge:
+        if (loadedTable.top() <= loadedFrozenRows)
+            return false;
+        return rowPos(loadedTable.top() - 1) + rowHeight(loadedTable.top() - 1) > fillRect.top();
+    case Qt::BottomEdge:
+        if (loadedTable.bottom() >= q->rows() - 1)
+            return false;
+        return rowPos(loadedTable.bottom() + 1) < fillRect.bottom();
+    }
+
+    return false;
+}
+
+bool QQuickTableViewPrivate::canUnloadTableEdge(Qt::Edge tableEdge, const QRectF &fillRect) const
+{
+    // Note: we always keep at least one row and one column loaded. Jumping
+    // to a position outside the loaded table is handled by addRemoveVisibleItems().
+
+    if (pendingTableEdge) {
+        // The cells of a pending edge are counted from the top or left side of the
+        // table, so leave the edges across it alone until it has been loaded.
+        const bool pendingColumn = pendingTableEdge & (Qt::LeftEdge | Qt::RightEdge);
+        const bool column = tableEdge == Qt::LeftEdge || tableEdge == Qt::RightEdge;
+        if (pendingColumn != column)
+            return false;
+    }
+
+    switch (tableEdge) {
+    case Qt::LeftEdge:
+        if (loadedTable.width() <= 1)
+            return false;
+        return columnPos(loadedTable.left()) + columnWidth(loadedTable.left()) <= fillRect.left();
+    case Qt::RightEdge:
+        if (loadedTable.width() <= 1)
+            return false;
+        return columnPos(loadedTable.right()) >= fillRect.right();
+    case Qt::TopEdge:
+        if (loadedTable.height() <= 1)
+            return false;
+        return rowPos(loadedTable.top()) + rowHeight(loadedTable.top()) <= fillRect.top();
+    case Qt::BottomEdge:
+        if (loadedTable.height() <= 1)
+            return false;
+        return rowPos(loadedTable.bottom()) >= fillRect.bottom();
+    }
+
+    return false;
+}
+
+bool QQuickTableViewPrivate::loadTableEdge(Qt::Edge tableEdge, bool doBuffer)
+{
+    // Returns true if the edge was loaded, and false if we're
+    // still waiting for some of its items to be incubated.
+
+    if (pendingTableEdge != tableEdge) {
+        Q_ASSERT(!pendingTableEdge);
+        qCDebug(lcItemViewDelegateLifecycle) << "load edge:" << tableEdge << "loaded table:" << loadedTable;
+
+        // Ask the providers about the new row or column before we create any items for it.
+        // A new row or column on the top or left side will move the ones already loaded
+        // if its size differs from what we estimated, so lay those out again.
+        bool relayout = false;
+        switch (tableEdge) {
+        case Qt::LeftEdge:
+            relayout = measureColumn(loadedTable.left() - 1);
+            break;
+        case Qt::RightEdge:
+            measureColumn(loadedTable.right() + 1);
+            break;
+        case Qt::TopEdge:
+            relayout = measureRow(loadedTable.top() - 1);
+            break;
+        case Qt::BottomEdge:
+            measureRow(loadedTable.bottom() + 1);
+            break;
+        }
+        if (relayout)
+            layoutVisibleItems();
+
+        pendingTableEdge = tableEdge;
+        pendingEdgeCellCount = 0;
+    }
+
+    const bool columnEdge = tableEdge == Qt::LeftEdge || tableEdge == Qt::RightEdge;
+    const int cellCount = columnEdge
+            ? loadedFrozenRows + loadedTable.height()
+            : loadedFrozenColumns + loadedTable.width();
+
+    for (; pendingEdgeCellCount < cellCount; ++pendingEdgeCellCount) {
+        const QPoint cell = edgeCell(tableEdge, pendingEdgeCellCount);
+        // If the item is being incubated, createdItem() will
+        // refill once it's ready, and we continue from here.
+        if (!loadCell(cell.y(), cell.x(), doBuffer))
+            return false;
+    }
+
+    switch (tableEdge) {
+    case Qt::LeftEdge:
+        loadedTable.setLeft(loadedTable.left() - 1);
+        break;
+    case Qt::RightEdge:
+        loadedTable.setRight(loadedTable.right() + 1);
+        break;
+    case Qt::TopEdge:
+        loadedTable.setTop(loadedTable.top() - 1);
+        break;
+    case Qt::BottomEdge:
+        loadedTable.setBottom(loadedTable.bottom() + 1);
+        break;
+    }
+
+    pendingTableEdge = Qt::Edges();
+    pendingEdgeCellCount = 0;
+    return true;
+}
+
+QPoint QQuickTableViewPrivate::edgeCell(Qt::Edge tableEdge, int cellIndex) const
+{
+    // Returns the cell (as column and row) at cellIndex in the row or column
+    // outside the given edge of loadedTable. The frozen cells come first.
+    const bool columnEdge = tableEdge == Qt::LeftEdge || tableEdge == Qt::RightEdge;
+    const int frozenCount = columnEdge ? loadedFrozenRows : loadedFrozenColumns;
+    const int firstSection = columnEdge ? loadedTable.top() : loadedTable.left();
+    const int section = cellIndex < frozenCount ? cellIndex : firstSection + cellIndex - frozenCount;
+
+    switch (tableEdge) {
+    case Qt::LeftEdge:
+        return QPoint(loadedTable.left() - 1, section);
+    case Qt::RightEdge:
+        return QPoint(loadedTable.right() + 1, section);
+    case Qt::TopEdge:
+        return QPoint(section, loadedTable.top() - 1);
+    case Qt::BottomEdge:
+        return QPoint(section, loadedTable.bottom() + 1);
+    }
+
+    return QPoint();
+}
+
+void QQuickTableViewPrivate::unloadTableEdge(Qt::Edge tableEdge)
+{
+    qCDebug(lcItemViewDelegateLifecycle) << "unload edge:" << tableEdge << "loaded table:" << loadedTable;
+
+    QVector<FxViewItem *> unloadedItems;
+
+    switch (tableEdge) {
+    case Qt::LeftEdge:
+    case Qt::RightEdge: {
+        const int column = tableEdge == Qt::LeftEdge ? loadedTable.left() : loadedTable.right();
+        for (int row = 0; row < loadedFrozenRows; ++row) {
+            if (FxViewItem *item = frozenRowItems.take(row, column))
+                unloadedItems.append(item);
+        }
+        for (int row = loadedTable.top(); row <= loadedTable.bottom(); ++row) {
+            if (FxViewItem *item = loadedItems.take(row, column))
+                unloadedItems.append(item);
+        }
+        if (tableEdge == Qt::LeftEdge)
+            loadedTable.setLeft(column + 1);
+        else
+            loadedTable.setRight(column - 1);
+        break; }
+    case Qt::TopEdge:
+    case Qt::BottomEdge: {
+        const int row = tableEdge == Qt::TopEdge ? loadedTable.top() : loadedTable.bottom();
+        for (int column = 0; column < loadedFrozenColumns; ++column) {
+            if (FxViewItem *item = frozenColumnItems.take(row, column))
+                unloadedItems.append(item);
+        }
+        for (int column = loadedTable.left(); column <= loadedTable.right(); ++column) {
+            if (FxViewItem *item = loadedItems.take(row, column))
+                unloadedItems.append(item);
+        }
+        if (tableEdge == Qt::TopEdge)
+            loadedTable.setTop(row + 1);
+        else
+            loadedTable.setBottom(row - 1);
+        break; }
+    }
+
+    // Spanning items stay as long as they cover other loaded cells
+    if (!cellSpans.isEmpty()) {
+        QVector<FxViewItem *> releasedItems;
+        for (FxViewItem *item : qAsConst(unloadedItems)) {
+            if (!isLoadedItem(static_cast<FxTableItemSG *>(item)) && !releasedItems.contains(item))
+                releasedItems.append(item);
+        }
+        unloadedItems = releasedItems;
+    }
+
+    releaseTableItems(unloadedItems);
+}
+
+void QQuickTableViewPrivate::releaseTableItems(const QVector<FxViewItem *> &items)
+{
+    if (items.isEmpty())
+        return;
+
+    // Take the items out of visibleItems before releasing them, since releasing
+    // an item might cause visibleItems to be accessed (QTBUG-61294). Do it in
+    // one pass, so that the list is only compacted once per edge.
+    QSet<FxViewItem *> releasedItems;
+    releasedItems.reserve(items.count());
+    for (FxViewItem *item : items)
+        releasedItems.insert(item);
+    visibleItems.erase(std::remove_if(visibleItems.begin(), visibleItems.end(), [&](FxViewItem *item) {
+        return releasedItems.contains(item);
+    }), visibleItems.end());
+
+    for (FxViewItem *item : items)
+        releaseItem(item);
+}
+
+void QQuickTableViewPrivate::cancelPendingTableEdge()
+{
+    if (!pendingTableEdge)
+        return;
+
+    qCDebug(lcItemViewDelegateLifecycle) << "cancel edge:" << pendingTableEdge << "loaded table:" << loadedTable;
+
+    if (requestedIndex >= 0) {
+        model->cancel(requestedIndex);
+        requestedIndex = -1;
+    }
+
+    // Take the cells created for the edge so far out of the grids. Their items are
+    // released, unless they belong to a span that also covers loaded cells.
+    const Qt::Edge tableEdge = Qt::Edge(int(pendingTableEdge));
+    QVector<FxViewItem *> cancelledItems;
+    for (int i = 0; i < pendingEdgeCellCount; ++i) {
+        const QPoint cell = edgeCell(tableEdge, i);
+        FxViewItem *item = cellGrid(cell.y(), cell.x()).take(cell.y(), cell.x());
+        if (item && !isLoadedItem(static_cast<FxTableItemSG *>(item)) && !cancelledItems.contains(item))
+            cancelledItems.append(item);
+    }
+
+    pendingTableEdge = Qt::Edges();
+    pendingEdgeCellCount = 0;
+
+    releaseTableItems(cancelledItems);
+}
+
+void QQuickTableViewPrivate::releaseLoadedItems()
+{
+    cancelPendingTableEdge();
+    clearCellGrids();
+    releaseVisibleItems();
+    loadedTable = QRect();
+    visibleTable = QRect();
+}
+
+void QQuickTableViewPrivate::updateCulling(const QRectF &fillRect, bool force)
+{
+    // Cull the items in the cache buffer, so that they cost nothing to render
+    // until they are flicked into the viewport.
+    QRect newVisibleTable;
+    if (!loadedTable.isEmpty()) {
+        const QPoint topLeft(columnAtPos(fillRect.left()), rowAtPos(fillRect.top()));
+        const QPoint bottomRight(columnAtPos(fillRect.right()), rowAtPos(fillRect.bottom()));
+        newVisibleTable = QRect(topLeft, bottomRight);
+    }
+
+    if (newVisibleTable == visibleTable && !force)
+        return;
+    visibleTable = newVisibleTable;
+
+    for (FxViewItem *item : qAsConst(visibleItems)) {
+        FxTableItemSG *tableItem = static_cast<FxTableItemSG *>(item);
+        if (!tableItem->item)
+            continue;
+        // Frozen cells are visible as long as the row or column they belong to is
+        const int bottom = tableItem->row + tableItem->rowSpan - 1;
+        const int right = tableItem->column + tableItem->columnSpan - 1;
+        const bool rowVisible = tableItem->row < loadedFrozenRows
+                || (tableItem->row <= visibleTable.bottom() && bottom >= visibleTable.top());
+        const bool columnVisible = tableItem->column < loadedFrozenColumns
+                || (tableItem->column <= visibleTable.right() && right >= visibleTable.left());
+        QQuickItemPrivate::get(tableItem->item)->setCulled(!(rowVisible && columnVisible));
+    }
+}
+
+bool QQuickTableViewPrivate::addVisibleItems(const QRectF &fillRect, bool doBuffer)
+{
+    Q_Q(QQuickTableView);
+
+    // For simplicity, we assume that we always specify the number of rows and columns directly
+    // in TableView. But we should also allow those properties to be unspecified, and if so, get
+    // the counts from the model instead.
+    const int rowCount = q->rows();
+    const int columnCount = q->columns();
+    if (rowCount <= 0 || columnCount <= 0)
+        return false;
+
+    bool added = false;
+
+    if (loadedTable.isEmpty()) {
+        // Start by loading the top-left cell inside the viewport,
+        // and grow the table from there edge by edge.
+        const int row = qBound(loadedFrozenRows, rowAtPos(fillRect.top()), rowCount - 1);
+        const int column = qBound(loadedFrozenColumns, columnAtPos(fillRect.left()), columnCount - 1);
+        if (!loadFirstCell(row, column))
+            return false;
+        added = true;
+    }
+
+    if (pendingTableEdge) {
+        const Qt::Edge tableEdge = Qt::Edge(int(pendingTableEdge));
+        if (doBuffer || canLoadTableEdge(tableEdge, fillRect)) {
+            // Continue loading the edge. If it has entered the viewport, any
+            // item still being incubated will be completed synchronously.
+            if (!loadTableEdge(tableEdge, doBuffer))
+                return added;
+            added = true;
+        } else {
+            // The viewport needs other edges, and those cannot be loaded
+            // until the pending one is done. So give up on it for now.
+            for (Qt::Edge otherEdge : allTableEdges) {
+                if (otherEdge != tableEdge && canLoadTableEdge(otherEdge, fillRect)) {
+                    cancelPendingTableEdge();
+                    break;
+                }
+            }
+            if (pendingTableEdge)
+                return added;
+        }
+    }
+
+    bool edgeLoaded;
+    do {
+        edgeLoaded = false;
+        for (Qt::Edge tableEdge : allTableEdges) {
+            if (canLoadTableEdge(tableEdge, fillRect)) {
+                if (!loadTableEdge(tableEdge, doBuffer))
+                    return added;
+                edgeLoaded = true;
+                added = true;
+            }
+        }
+    } while (edgeLoaded);
+
+    return added;
+}
+
+bool QQuickTableViewPrivate::loadFirstCell(int row, int column)
+{
+    // Loads the first cell of the table, together with the frozen cells that
+    // go with it. These are always loaded synchronously.
+    measureRow(row);
+    measureColumn(column);
+    if (!loadCell(row, column, false))
+        return false;
+    loadedTable = QRect(column, row, 1, 1);
+    fetchedAheadTop = -1;
+    fetchedAheadBottom = -1;
+
+    bool created = true;
+    for (int r = 0; created && r < loadedFrozenRows; ++r) {
+        for (int c = 0; created && c < loadedFrozenColumns; ++c)
+            created = loadCell(r, c, false);
+        if (created)
+            created = loadCell(r, column, false);
+    }
+    for (int c = 0; created && c < loadedFrozenColumns; ++c)
+        created = loadCell(row, c, false);
+
+    if (!created) {
+        releaseLoadedItems();
+        return false;
+    }
+    return true;
+}
+
+void QQuickTableViewPrivate::fetchRowsAhead()
+{
+    // Ask the model for the rows that we are about to flick into, so that models
+    // that fetch their rows lazily (e.g from a database) can do so while flicking,
+    // rather than once the last row has been loaded. We look one page of loaded
+    // rows ahead, plus as many rows as the current velocity covers in a second.
+    // This runs on every refill, so only do so once the loaded rows moved, and
+    // when the model has something left to fetch.
+    Q_Q(QQuickTableView);
+    QQmlDelegateModel *delegateModel = qobject_cast<QQmlDelegateModel *>(model.data());
+    if (!delegateModel || loadedTable.isEmpty())
+        return;
+    if (loadedTable.top() == fetchedAheadTop && loadedTable.bottom() == fetchedAheadBottom)
+        return;
+    if (!delegateModel->canFetchMore())
+        return;
+    fetchedAheadTop = loadedTable.top();
+    fetchedAheadBottom = loadedTable.bottom();
+
+    const qreal velocity = q->verticalVelocity();
+    const qreal rowStep = rowHeights.estimatedSize() + rowHeights.spacing();
+    int rowsAhead = loadedTable.height();
+    if (rowStep > 0)
+        rowsAhead += qMin(qCeil(qAbs(velocity) / rowStep), rowHeights.count());
+
+    // Velocity is positive when contentY increases
+    if (velocity >= 0) {
+        delegateModel->fetchRows(loadedTable.bottom() + 1, rowsAhead);
+    } else {
+        const int firstRow = qMax(0, loadedTable.top() - rowsAhead);
+        delegateModel->fetchRows(firstRow, loadedTable.top() - firstRow);
+    }
+}
+
+bool QQuickTableViewPrivate::removeNonVisibleItems(const QRectF &fillRect)
+{
+    if (loadedTable.isEmpty())
+        return false;
+
+    bool removed = false;
+    bool edgeUnloaded;
+    do {
+        edgeUnloaded = false;
+        for (Qt::Edge tableEdge : allTableEdges) {
+            if (canUnloadTableEdge(tableEdge, fillRect)) {
+                unloadTableEdge(tableEdge);
+                edgeUnloaded = true;
+                removed = true;
+            }
+        }
+    } while (edgeUnloaded);
+
+    return removed;
+}
+
+QQuickTableView::QQuickTableView(QQuickItem *parent)
+    : QQuickAbstractItemView(*(new QQuickTableViewPrivate), parent)
+{
+    // The estimated size of the rows and columns not measured yet
+    // is held back while flicking, so update it once the view stops.
+    connect(this, &QQuickFlickable::movementEnded, this, [this] {
+        Q_D(QQuickTableView);
+        d->forceLayoutPolish();
+    });
+}
+
+QQuickTableView::~QQuickTableView()
+{
+    Q_D(QQuickTableView);
+    if (d->autoFitGuard) {
+        QMutexLocker locker(&d->autoFitGuard->mutex);
+        d->autoFitGuard->view = nullptr;
+    }
+}
+
+int QQuickTableView::rows() const
+{
+    Q_D(const QQuickTableView);
+    if (QQmlDelegateModel *delegateModel = qobject_cast<QQmlDelegateModel *>(d->model.data()))
+        return delegateModel->rows();
+    // Like QQmlDelegateModel, leave out the rows with cells that are past
+    // the last index an int can hold, so that every cell can be addressed.
+    return qBound(0, d->rows, INT_MAX / columns());
+}
+
+void QQuickTableView::setRows(int rows)
+{
+    Q_D(QQuickTableView);
+    if (d->rows == rows)
+        return;
+
+    d->rows = rows;
+    if (d->componentComplete && d->model && d->ownModel)
+        static_cast<QQmlDelegateModel *>(d->model.data())->setRows(rows);
+    emit rowsChanged();
+}
+
+void QQuickTableView::resetRows()
+{
+    Q_D(QQuickTableView);
     if (d->rows == -1)
         return;
 
@@ -692,16 +2122,16 @@ void QQuickTableView::resetColumns()
 qreal QQuickTableView::rowSpacing() const
 {
     Q_D(const QQuickTableView);
-    return d->rowSpacing;
+    return d->rowHeights.spacing();
 }
 
 void QQuickTableView::setRowSpacing(qreal spacing)
 {
     Q_D(QQuickTableView);
-    if (d->rowSpacing == spacing)
+    if (d->rowHeights.spacing() == spacing)
         return;
 
-    d->rowSpacing = spacing;
+    d->rowHeights.setSpacing(spacing);
     d->forceLayoutPolish();
     emit rowSpacingChanged();
 }
@@ -709,20 +2139,367 @@ void QQuickTableView::setRowSpacing(qreal spacing)
 qreal QQuickTableView::columnSpacing() const
 {
     Q_D(const QQuickTableView);
-    return d->columnSpacing;
+    return d->columnWidths.spacing();
 }
 
 void QQuickTableView::setColumnSpacing(qreal spacing)
 {
     Q_D(QQuickTableView);
-    if (d->columnSpacing == spacing)
+    if (d->columnWidths.spacing() == spacing)
         return;
 
-    d->columnSpacing = spacing;
+    d->columnWidths.setSpacing(spacing);
     d->forceLayoutPolish();
     emit columnSpacingChanged();
 }
 
+qreal QQuickTableView::defaultRowHeight() const
+{
+    Q_D(const QQuickTableView);
+    return d->rowHeights.defaultSize();
+}
+
+void QQuickTableView::setDefaultRowHeight(qreal height)
+{
+    Q_D(QQuickTableView);
+    if (d->rowHeights.defaultSize() == height)
+        return;
+
+    d->rowHeights.setDefaultSize(height);
+    d->forceLayoutPolish();
+    emit defaultRowHeightChanged();
+}
+
+qreal QQuickTableView::defaultColumnWidth() const
+{
+    Q_D(const QQuickTableView);
+    return d->columnWidths.defaultSize();
+}
+
+void QQuickTableView::setDefaultColumnWidth(qreal width)
+{
+    Q_D(QQuickTableView);
+    if (d->columnWidths.defaultSize() == width)
+        return;
+
+    d->columnWidths.setDefaultSize(width);
+    d->forceLayoutPolish();
+    emit defaultColumnWidthChanged();
+}
+
+int QQuickTableView::frozenRows() const
+{
+    Q_D(const QQuickTableView);
+    return d->frozenRows;
+}
+
+void QQuickTableView::setFrozenRows(int rows)
+{
+    Q_D(QQuickTableView);
+    if (rows < 0) {
+        qmlWarning(this) << "frozenRows cannot be negative";
+        return;
+    }
+    if (d->frozenRows == rows)
+        return;
+
+    // The next refill notices the change, and loads the table again
+    d->frozenRows = rows;
+    d->forceLayoutPolish();
+    emit frozenRowsChanged();
+}
+
+int QQuickTableView::frozenColumns() const
+{
+    Q_D(const QQuickTableView);
+    return d->frozenColumns;
+}
+
+void QQuickTableView::setFrozenColumns(int columns)
+{
+    Q_D(QQuickTableView);
+    if (columns < 0) {
+        qmlWarning(this) << "frozenColumns cannot be negative";
+        return;
+    }
+    if (d->frozenColumns == columns)
+        return;
+
+    d->frozenColumns = columns;
+    d->forceLayoutPolish();
+    emit frozenColumnsChanged();
+}
+
+QJSValue QQuickTableView::rowHeightProvider() const
+{
+    Q_D(const QQuickTableView);
+    return d->rowHeightProvider;
+}
+
+void QQuickTableView::setRowHeightProvider(const QJSValue &provider)
+{
+    Q_D(QQuickTableView);
+    if (provider.strictlyEquals(d->rowHeightProvider))
+        return;
+
+    if (!provider.isCallable() && !provider.isUndefined() && !provider.isNull())
+        qmlWarning(this) << "rowHeightProvider must be a function";
+
+    d->rowHeightProvider = provider;
+    d->rowHeights.resetMeasuredSizes();
+    d->forceLayoutPolish();
+    emit rowHeightProviderChanged();
+}
+
+QJSValue QQuickTableView::columnWidthProvider() const
+{
+    Q_D(const QQuickTableView);
+    return d->columnWidthProvider;
+}
+
+void QQuickTableView::setColumnWidthProvider(const QJSValue &provider)
+{
+    Q_D(QQuickTableView);
+    if (provider.strictlyEquals(d->columnWidthProvider))
+        return;
+
+    if (!provider.isCallable() && !provider.isUndefined() && !provider.isNull())
+        qmlWarning(this) << "columnWidthProvider must be a function";
+
+    d->columnWidthProvider = provider;
+    d->columnWidths.resetMeasuredSizes();
+    d->forceLayoutPolish();
+    emit columnWidthProviderChanged();
+}
+
+void QQuickTableView::setRowHeightCallback(const std::function<qreal(int)> &callback)
+{
+    Q_D(QQuickTableView);
+    d->rowHeightCallback = callback;
+    d->rowHeights.resetMeasuredSizes();
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::setColumnWidthCallback(const std::function<qreal(int)> &callback)
+{
+    Q_D(QQuickTableView);
+    d->columnWidthCallback = callback;
+    d->columnWidths.resetMeasuredSizes();
+    d->forceLayoutPolish();
+}
+
+QQuickItem *QQuickTableView::itemAtCell(int row, int column) const
+{
+    Q_D(const QQuickTableView);
+    // Only items that are loaded, and have been added to the table, are returned
+    if (!d->isLoadedCell(row, column))
+        return nullptr;
+    FxTableItemSG *item = d->visibleItemAt(row, column);
+    return item ? item->item : nullptr;
+}
+
+void QQuickTableView::positionViewAtCell(int row, int column, int mode)
+{
+    Q_D(QQuickTableView);
+    if (!d->isValid())
+        return;
+    d->positionViewAtCell(row, column, mode);
+}
+
+void QQuickTableView::setSpan(int row, int column, int rowSpan, int columnSpan)
+{
+    Q_D(QQuickTableView);
+    if (row < 0 || column < 0 || rowSpan < 1 || columnSpan < 1) {
+        qmlWarning(this) << "setSpan: invalid span" << row << column << rowSpan << columnSpan;
+        return;
+    }
+
+    // A span that starts at the same cell is replaced. A span of one cell just removes it.
+    const QRect oldSpan = d->cellSpans.spanAt(row, column);
+    const bool replace = !oldSpan.isNull() && oldSpan.topLeft() == QPoint(column, row);
+    if (replace)
+        d->cellSpans.remove(row, column);
+    if (rowSpan > 1 || columnSpan > 1) {
+        if (!d->cellSpans.insert(QRect(column, row, columnSpan, rowSpan))) {
+            qmlWarning(this) << "setSpan: span overlaps another span" << row << column << rowSpan << columnSpan;
+            if (replace)
+                d->cellSpans.insert(oldSpan);
+            return;
+        }
+    } else if (!replace) {
+        return;
+    }
+
+    d->spansChanged = true;
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::clearSpans()
+{
+    Q_D(QQuickTableView);
+    if (d->cellSpans.isEmpty())
+        return;
+
+    d->cellSpans.clear();
+    d->spansChanged = true;
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::invalidateRow(int row)
+{
+    Q_D(QQuickTableView);
+    if (!d->rowHeights.isMeasured(row))
+        return;
+
+    d->rowHeights.resetSize(row);
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::invalidateColumn(int column)
+{
+    Q_D(QQuickTableView);
+    if (!d->columnWidths.isMeasured(column))
+        return;
+
+    d->columnWidths.resetSize(column);
+    d->forceLayoutPolish();
+}
+
+qreal QQuickTableView::rowHeight(int row) const
+{
+    Q_D(const QQuickTableView);
+    if (row < 0 || row >= rows())
+        return -1;
+    return d->rowHeights.size(row);
+}
+
+void QQuickTableView::setRowHeight(int row, qreal height)
+{
+    Q_D(QQuickTableView);
+    d->syncSectionCounts();
+    if (row < 0 || row >= d->rowHeights.count()) {
+        qmlWarning(this) << "setRowHeight: row out of range:" << row;
+        return;
+    }
+    if (d->rowHeights.hasSize(row) && d->rowHeights.size(row) == height)
+        return;
+
+    d->rowHeights.setSize(row, height);
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::resetRowHeight(int row)
+{
+    Q_D(QQuickTableView);
+    if (!d->rowHeights.hasSize(row))
+        return;
+
+    d->rowHeights.resetSize(row);
+    d->forceLayoutPolish();
+}
+
+qreal QQuickTableView::columnWidth(int column) const
+{
+    Q_D(const QQuickTableView);
+    if (column < 0 || column >= columns())
+        return -1;
+    return d->columnWidths.size(column);
+}
+
+void QQuickTableView::setColumnWidth(int column, qreal width)
+{
+    Q_D(QQuickTableView);
+    d->syncSectionCounts();
+    if (column < 0 || column >= d->columnWidths.count()) {
+        qmlWarning(this) << "setColumnWidth: column out of range:" << column;
+        return;
+    }
+    if (d->columnWidths.hasSize(column) && d->columnWidths.size(column) == width)
+        return;
+
+    d->columnWidths.setSize(column, width);
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::resetColumnWidth(int column)
+{
+    Q_D(QQuickTableView);
+    if (!d->columnWidths.hasSize(column))
+        return;
+
+    d->columnWidths.resetSize(column);
+    d->forceLayoutPolish();
+}
+
+void QQuickTableView::resizeColumnToContents(int column)
+{
+    Q_D(QQuickTableView);
+    if (!d->isValid())
+        return;
+    d->resizeColumnToContents(column);
+}
+
+void QQuickTableView::resizeColumnsToContents()
+{
+    Q_D(QQuickTableView);
+    if (!d->isValid())
+        return;
+    for (int column = 0; column < columns(); ++column)
+        d->resizeColumnToContents(column);
+}
+
+int QQuickTableView::autoFitSampleSize() const
+{
+    Q_D(const QQuickTableView);
+    return d->autoFitSampleSize;
+}
+
+void QQuickTableView::setAutoFitSampleSize(int size)
+{
+    Q_D(QQuickTableView);
+    if (size < 0) {
+        qmlWarning(this) << "autoFitSampleSize cannot be negative";
+        return;
+    }
+    if (d->autoFitSampleSize == size)
+        return;
+
+    d->autoFitSampleSize = size;
+    emit autoFitSampleSizeChanged();
+}
+
+QString QQuickTableView::autoFitTextRole() const
+{
+    Q_D(const QQuickTableView);
+    return d->autoFitTextRole;
+}
+
+void QQuickTableView::setAutoFitTextRole(const QString &role)
+{
+    Q_D(QQuickTableView);
+    if (d->autoFitTextRole == role)
+        return;
+
+    d->autoFitTextRole = role;
+    emit autoFitTextRoleChanged();
+}
+
+QFont QQuickTableView::autoFitFont() const
+{
+    Q_D(const QQuickTableView);
+    return d->autoFitFont;
+}
+
+void QQuickTableView::setAutoFitFont(const QFont &font)
+{
+    Q_D(QQuickTableView);
+    if (d->autoFitFont == font)
+        return;
+
+    d->autoFitFont = font;
+    emit autoFitFontChanged();
+}
+
 QQuickTableView::Orientation QQuickTableView::orientation() const
 {
     Q_D(const QQuickTableView);
@@ -761,6 +2538,22 @@ void QQuickTableView::initItem(int index, QObject *object)
     }
 }
 
+void QQuickTableView::viewportMoved(Qt::Orientations orient)
+{
+    Q_D(QQuickTableView);
+    QQuickAbstractItemView::viewportMoved(orient);
+
+    // Recursion can occur due to refill changing the content size.
+    if (d->inViewportMoved)
+        return;
+    d->inViewportMoved = true;
+
+    // Load and unload the table edges that entered or left the viewport
+    d->refillOrLayout();
+
+    d->inViewportMoved = false;
+}
+
 void QQuickTableView::componentComplete()
 {
     Q_D(QQuickTableView);
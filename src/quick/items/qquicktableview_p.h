@@ -57,11 +57,20 @@ QT_REQUIRE_CONFIG(quick_tableview);
 
 #include "qquickabstractitemview_p.h"
 
+#include <QtGui/qfont.h>
+#include <QtQml/qjsvalue.h>
+
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 class QQuickTableViewAttached;
 class QQuickTableViewPrivate;
 
+// A view that lays out the cells of a DelegateModel in rows and columns, and
+// only creates the cells that are in or near the viewport. The cells are laid
+// out from left to right and top to bottom. layoutDirection and
+// verticalLayoutDirection are not supported, and have no effect.
 class Q_AUTOTEST_EXPORT QQuickTableView : public QQuickAbstractItemView
 {
     Q_OBJECT
@@ -70,12 +79,22 @@ class Q_AUTOTEST_EXPORT QQuickTableView : public QQuickAbstractItemView
     Q_PROPERTY(int columns READ columns WRITE setColumns RESET resetColumns NOTIFY columnsChanged)
     Q_PROPERTY(qreal rowSpacing READ rowSpacing WRITE setRowSpacing NOTIFY rowSpacingChanged)
     Q_PROPERTY(qreal columnSpacing READ columnSpacing WRITE setColumnSpacing NOTIFY columnSpacingChanged)
+    Q_PROPERTY(qreal defaultRowHeight READ defaultRowHeight WRITE setDefaultRowHeight NOTIFY defaultRowHeightChanged)
+    Q_PROPERTY(qreal defaultColumnWidth READ defaultColumnWidth WRITE setDefaultColumnWidth NOTIFY defaultColumnWidthChanged)
+    Q_PROPERTY(QJSValue rowHeightProvider READ rowHeightProvider WRITE setRowHeightProvider NOTIFY rowHeightProviderChanged)
+    Q_PROPERTY(QJSValue columnWidthProvider READ columnWidthProvider WRITE setColumnWidthProvider NOTIFY columnWidthProviderChanged)
+    Q_PROPERTY(int frozenRows READ frozenRows WRITE setFrozenRows NOTIFY frozenRowsChanged)
+    Q_PROPERTY(int frozenColumns READ frozenColumns WRITE setFrozenColumns NOTIFY frozenColumnsChanged)
     Q_PROPERTY(Orientation orientation READ orientation WRITE setOrientation NOTIFY orientationChanged)
+    Q_PROPERTY(int autoFitSampleSize READ autoFitSampleSize WRITE setAutoFitSampleSize NOTIFY autoFitSampleSizeChanged)
+    Q_PROPERTY(QString autoFitTextRole READ autoFitTextRole WRITE setAutoFitTextRole NOTIFY autoFitTextRoleChanged)
+    Q_PROPERTY(QFont autoFitFont READ autoFitFont WRITE setAutoFitFont NOTIFY autoFitFontChanged)
 
     Q_CLASSINFO("DefaultProperty", "data")
 
 public:
     QQuickTableView(QQuickItem *parent = nullptr);
+    ~QQuickTableView();
 
     int rows() const;
     void setRows(int rows);
@@ -91,6 +110,57 @@ public:
     qreal columnSpacing() const;
     void setColumnSpacing(qreal spacing);
 
+    qreal defaultRowHeight() const;
+    void setDefaultRowHeight(qreal height);
+
+    qreal defaultColumnWidth() const;
+    void setDefaultColumnWidth(qreal width);
+
+    QJSValue rowHeightProvider() const;
+    void setRowHeightProvider(const QJSValue &provider);
+
+    QJSValue columnWidthProvider() const;
+    void setColumnWidthProvider(const QJSValue &provider);
+
+    int frozenRows() const;
+    void setFrozenRows(int rows);
+
+    int frozenColumns() const;
+    void setFrozenColumns(int columns);
+
+    // C++ alternatives to the providers above. When set, they take precedence.
+    void setRowHeightCallback(const std::function<qreal(int)> &callback);
+    void setColumnWidthCallback(const std::function<qreal(int)> &callback);
+
+    Q_INVOKABLE QQuickItem *itemAtCell(int row, int column) const;
+    Q_INVOKABLE void positionViewAtCell(int row, int column, int mode);
+
+    Q_INVOKABLE void setSpan(int row, int column, int rowSpan, int columnSpan);
+    Q_INVOKABLE void clearSpans();
+
+    Q_INVOKABLE void invalidateRow(int row);
+    Q_INVOKABLE void invalidateColumn(int column);
+
+    Q_INVOKABLE qreal rowHeight(int row) const;
+    Q_INVOKABLE void setRowHeight(int row, qreal height);
+    Q_INVOKABLE void resetRowHeight(int row);
+
+    Q_INVOKABLE qreal columnWidth(int column) const;
+    Q_INVOKABLE void setColumnWidth(int column, qreal width);
+    Q_INVOKABLE void resetColumnWidth(int column);
+
+    Q_INVOKABLE void resizeColumnToContents(int column);
+    Q_INVOKABLE void resizeColumnsToContents();
+
+    int autoFitSampleSize() const;
+    void setAutoFitSampleSize(int size);
+
+    QString autoFitTextRole() const;
+    void setAutoFitTextRole(const QString &role);
+
+    QFont autoFitFont() const;
+    void setAutoFitFont(const QFont &font);
+
     enum Orientation { Horizontal = Qt::Horizontal, Vertical = Qt::Vertical };
     Q_ENUM(Orientation)
 
@@ -104,12 +174,22 @@ Q_SIGNALS:
     void columnsChanged();
     void rowSpacingChanged();
     void columnSpacingChanged();
+    void defaultRowHeightChanged();
+    void defaultColumnWidthChanged();
+    void rowHeightProviderChanged();
+    void columnWidthProviderChanged();
+    void frozenRowsChanged();
+    void frozenColumnsChanged();
     void orientationChanged();
+    void autoFitSampleSizeChanged();
+    void autoFitTextRoleChanged();
+    void autoFitFontChanged();
 
 protected Q_SLOTS:
     void initItem(int index, QObject *item) override;
 
 protected:
+    void viewportMoved(Qt::Orientations orient) override;
     void componentComplete() override;
 
 private:
@@ -114,8 +114,11 @@ public:
     QQuickWindowIncubationController(QSGRenderLoop *loop)
         : m_renderLoop(loop), m_timer(0)
     {
-        // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
+        // Allow incubation for 1/3 of a frame, unless a fixed budget (in
+        // milliseconds) has been requested through the environment.
+        m_incubation_time = qEnvironmentVariableIntValue("QML_INCUBATION_TIME");
+        if (m_incubation_time <= 0)
+            m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
 
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
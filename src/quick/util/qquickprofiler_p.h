@@ -322,6 +322,18 @@ public:
                 1 << PixmapCacheEvent, 1 << CountType, url, 0, 0, 0, count));
     }
 
+    static void itemViewFrame(int created, int incubated, int released, int destroyed, int reused,
+                              qint64 createTime, qint64 releaseTime)
+    {
+        const qint64 time = s_instance->timestamp();
+        s_instance->processMessage(QQuickProfilerData(time, 1 << ItemViewFrame,
+                1 << ItemViewDelegateCounts, qint64(created), qint64(incubated), qint64(released),
+                qint64(destroyed), qint64(reused)));
+        s_instance->processMessage(QQuickProfilerData(time, 1 << ItemViewFrame,
+                1 << ItemViewDelegateTimes, createTime, releaseTime, qint64(0), qint64(0),
+                qint64(0)));
+    }
+
     static void registerAnimationCallback();
 
     qint64 timestamp() { return m_timer.nsecsElapsed(); }
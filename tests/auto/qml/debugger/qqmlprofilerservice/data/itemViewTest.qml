@@ -0,0 +1,26 @@
+import QtQuick 2.0
+
+ListView {
+    id: list
+    width: 200
+    height: 200
+    model: 1000
+    delegate: Text {
+        width: list.width
+        height: 20
+        text: index
+    }
+
+    Timer {
+        interval: 16
+        repeat: true
+        running: true
+        onTriggered: {
+            list.contentY += 100;
+            if (list.contentY >= 5000) {
+                running = false;
+                console.log("done");
+            }
+        }
+    }
+}
@@ -18,6 +18,7 @@ OTHER_FILES += \
     data/test.qml \
     data/exit.qml \
     data/scenegraphTest.qml \
+    data/itemViewTest.qml \
     data/TestImage_2x2.png \
     data/signalSourceLocation.qml \
     data/javascript.qml \
@@ -72,6 +72,7 @@ public:
     QVector<QQmlProfilerData> jsHeapMessages;
     QVector<QQmlProfilerData> asynchronousMessages;
     QVector<QQmlProfilerData> pixmapMessages;
+    QVector<QQmlProfilerData> itemViewMessages;
 
     qint64 lastTimestamp;
 
@@ -90,6 +91,9 @@ private:
     void sceneGraphEvent(QQmlProfilerDefinitions::SceneGraphFrameType type, qint64 time,
                          qint64 numericData1, qint64 numericData2, qint64 numericData3,
                          qint64 numericData4, qint64 numericData5);
+    void itemViewEvent(QQmlProfilerDefinitions::ItemViewFrameType type, qint64 time,
+                       qint64 numericData1, qint64 numericData2, qint64 numericData3,
+                       qint64 numericData4, qint64 numericData5);
     void pixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type, qint64 time,
                           const QString &url, int numericData1, int numericData2);
     void memoryAllocation(QQmlProfilerDefinitions::MemoryType type, qint64 time, qint64 amount);
@@ -197,6 +201,32 @@ void QQmlProfilerTestClient::sceneGraphEvent(QQmlProfilerDefinitions::SceneGraph
                                                  type));
 }
 
+void QQmlProfilerTestClient::itemViewEvent(QQmlProfilerDefinitions::ItemViewFrameType type,
+                                           qint64 time, qint64 numericData1, qint64 numericData2,
+                                           qint64 numericData3, qint64 numericData4,
+                                           qint64 numericData5)
+{
+    QVERIFY(lastTimestamp <= time);
+    lastTimestamp = time;
+    QQmlProfilerData data(time, QQmlProfilerDefinitions::ItemViewFrame, type);
+    switch (type) {
+    case QQmlProfilerDefinitions::ItemViewDelegateCounts:
+        // created, incubated, released, destroyed, reused
+        data.framerate = numericData1;
+        data.animationcount = numericData3;
+        data.line = numericData5;
+        data.amount = numericData1 + numericData2 + numericData3 + numericData4 + numericData5;
+        break;
+    case QQmlProfilerDefinitions::ItemViewDelegateTimes:
+        // create time, release time
+        data.amount = numericData1 + numericData2;
+        break;
+    default:
+        break;
+    }
+    itemViewMessages.append(data);
+}
+
 void QQmlProfilerTestClient::pixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type,
                                              qint64 time, const QString &url, int numericData1,
                                              int numericData2)
@@ -280,7 +310,8 @@ private:
         MessageListJavaScript,
         MessageListJsHeap,
         MessageListAsynchronous,
-        MessageListPixmap
+        MessageListPixmap,
+        MessageListItemView
     };
 
     enum CheckType {
@@ -306,6 +337,7 @@ private slots:
     void connect();
     void pixmapCacheData();
     void scenegraphData();
+    void itemViewData();
     void profileOnExit();
     void controlFromJS();
     void signalSourceLocation();
@@ -426,6 +458,7 @@ bool tst_QQmlProfilerService::verify(tst_QQmlProfilerService::MessageListType ty
         case MessageListJsHeap:       target = &(m_client->jsHeapMessages); break;
         case MessageListAsynchronous: target = &(m_client->asynchronousMessages); break;
         case MessageListPixmap:       target = &(m_client->pixmapMessages); break;
+        case MessageListItemView:     target = &(m_client->itemViewMessages); break;
     }
 
     if (target->length() <= expectedPosition) {
@@ -508,6 +541,13 @@ void tst_QQmlProfilerService::cleanup()
                      << data.line << data.column;
         }
         qDebug() << " ";
+        qDebug() << "Item View Messages:" << m_client->itemViewMessages.count();
+        i = 0;
+        foreach (const QQmlProfilerData &data, m_client->itemViewMessages) {
+            qDebug() << i++ << data.time << data.messageType << data.detailType << data.framerate
+                     << data.animationcount << data.line << data.amount;
+        }
+        qDebug() << " ";
         qDebug() << "Javascript Heap Messages:" << m_client->jsHeapMessages.count();
         i = 0;
         foreach (const QQmlProfilerData &data, m_client->jsHeapMessages) {
@@ -653,6 +693,51 @@ void tst_QQmlProfilerService::scenegraphData()
     }
 }
 
+void tst_QQmlProfilerService::itemViewData()
+{
+    connect(true, "itemViewTest.qml");
+
+    m_client->sendRecordingStatus(true);
+
+    while (!m_process->output().contains(QLatin1String("done")))
+        QVERIFY(QQmlDebugTest::waitForSignal(m_process, SIGNAL(readyReadStandardOutput())));
+    m_client->sendRecordingStatus(false);
+
+    checkTraceReceived();
+    checkJsHeap();
+
+    // Every frame that touched the delegates reports both a count and a time message, with the
+    // same time stamp.
+    QVERIFY(m_client->itemViewMessages.count() > 0);
+    QCOMPARE(m_client->itemViewMessages.count() % 2, 0);
+
+    int created = 0;
+    int released = 0;
+    qint64 totalTime = 0;
+    for (int i = 0; i < m_client->itemViewMessages.count(); i += 2) {
+        const QQmlProfilerData &counts = m_client->itemViewMessages.at(i);
+        const QQmlProfilerData &times = m_client->itemViewMessages.at(i + 1);
+        QCOMPARE(counts.messageType, int(QQmlProfilerDefinitions::ItemViewFrame));
+        QCOMPARE(counts.detailType, int(QQmlProfilerDefinitions::ItemViewDelegateCounts));
+        QCOMPARE(times.messageType, int(QQmlProfilerDefinitions::ItemViewFrame));
+        QCOMPARE(times.detailType, int(QQmlProfilerDefinitions::ItemViewDelegateTimes));
+        QCOMPARE(times.time, counts.time);
+
+        // Frames without any delegate activity are not reported.
+        QVERIFY(counts.amount > 0);
+        QVERIFY(times.amount >= 0);
+
+        created += counts.framerate;
+        released += counts.animationcount;
+        totalTime += times.amount;
+    }
+
+    // Scrolling through the list creates delegates for the new rows and releases the old ones.
+    QVERIFY(created > 0);
+    QVERIFY(released > 0);
+    QVERIFY(totalTime > 0);
+}
+
 void tst_QQmlProfilerService::profileOnExit()
 {
     connect(true, "exit.qml");
@@ -39,6 +39,8 @@
 #include <qqmlcomponent.h>
 #include <stdlib.h>
 #include <private/qv4alloca_p.h>
+#include <private/qv4lookup_p.h>
+#include <private/qv8engine_p.h>
 
 #ifdef Q_CC_MSVC
 #define NO_INLINE __declspec(noinline)
@@ -200,6 +202,8 @@ private slots:
 
     void malformedExpression();
 
+    void polymorphicLookups();
+
 signals:
     void testSignal();
 };
@@ -4095,6 +4099,61 @@ void tst_QJSEngine::malformedExpression()
     engine.evaluate("5%55555&&5555555\n7-0");
 }
 
+void tst_QJSEngine::polymorphicLookups()
+{
+    QJSEngine engine;
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(&engine);
+
+    QJSValue result = engine.evaluate(
+            "function getX(o) { return o.x; }\n"
+            "function setX(o, v) { o.x = v; }\n"
+            "var shapes = [{ x: 1 }, { a: 0, x: 2 }, { b: 0, x: 3 }, Object.create({ x: 4 })];\n"
+            "var sum = 0;\n"
+            "for (var i = 0; i < 10; ++i) {\n"
+            "    for (var j = 0; j < shapes.length; ++j)\n"
+            "        sum += getX(shapes[j]);\n"
+            "}\n"
+            "for (var j = 0; j < 3; ++j)\n"
+            "    setX(shapes[j], getX(shapes[j]) * 10);\n"
+            "for (var j = 0; j < 3; ++j)\n"
+            "    setX(shapes[j], getX(shapes[j]) + 1);\n"
+            "sum + getX(shapes[0]) + getX(shapes[1]) + getX(shapes[2]);");
+    QCOMPARE(result.toInt(), 100 + 11 + 21 + 31);
+    QV4::LookupStatistics stats = QV4::Lookup::statistics(v4);
+    QVERIFY(stats.polymorphic > 0);
+    QCOMPARE(stats.megamorphic, 0u);
+
+    // More shapes than a site can hold make it use the shared cache
+    result = engine.evaluate(
+            "var many = [];\n"
+            "for (var i = 0; i < 8; ++i) {\n"
+            "    var o = {};\n"
+            "    o['p' + i] = i;\n"
+            "    o.x = i;\n"
+            "    many.push(o);\n"
+            "}\n"
+            "var total = 0;\n"
+            "for (var k = 0; k < 3; ++k) {\n"
+            "    for (var i = 0; i < many.length; ++i) {\n"
+            "        setX(many[i], getX(many[i]) + 1);\n"
+            "        total += getX(many[i]);\n"
+            "    }\n"
+            "}\n"
+            "total + getX(shapes[3]);");
+    QCOMPARE(result.toInt(), 36 + 44 + 52 + 4);
+    stats = QV4::Lookup::statistics(v4);
+    QVERIFY(stats.megamorphic >= 2);
+
+    // The global object changes its shape with every new global
+    engine.evaluate("var g = 42; function readG() { return g; }");
+    for (int i = 0; i < 8; ++i) {
+        result = engine.evaluate(QStringLiteral("this.extra%1 = %1; readG();").arg(i));
+        QCOMPARE(result.toInt(), 42);
+    }
+    engine.evaluate("g = 43");
+    QCOMPARE(engine.evaluate("readG()").toInt(), 43);
+}
+
 QTEST_MAIN(tst_QJSEngine)
 
 #include "tst_qjsengine.moc"
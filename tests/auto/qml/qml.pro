@@ -56,6 +56,7 @@ PRIVATETESTS += \
     qqmlvaluetypeproviders \
     qqmlbinding \
     qqmlchangeset \
+    qqmlsortfilterindex \
     qqmlconnections \
     qqmllistcompositor \
     qqmllistmodel \
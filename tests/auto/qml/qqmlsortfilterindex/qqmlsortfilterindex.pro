@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = tst_qqmlsortfilterindex
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qqmlsortfilterindex.cpp
+
+QT += core-private gui-private qml-private testlib
@@ -0,0 +1,217 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtest.h>
+#include <private/qqmlsortfilterindex_p.h>
+
+class tst_qqmlsortfilterindex : public QObject
+{
+    Q_OBJECT
+private slots:
+    void reset();
+    void filter();
+    void sortOrder();
+    void insert();
+    void remove();
+    void change();
+    void random();
+
+private:
+    struct Row
+    {
+        int key;
+        bool accepted;
+    };
+
+    static QVector<int> expectedRows(const QVector<Row> &rows, Qt::SortOrder order);
+    static void verify(const QQmlSortFilterIndex &index, const QVector<Row> &rows);
+};
+
+QVector<int> tst_qqmlsortfilterindex::expectedRows(const QVector<Row> &rows, Qt::SortOrder order)
+{
+    QVector<int> result;
+    for (int i = 0; i < rows.count(); ++i) {
+        if (rows.at(i).accepted)
+            result.append(i);
+    }
+    std::stable_sort(result.begin(), result.end(), [&](int a, int b) {
+        return order == Qt::AscendingOrder
+                ? rows.at(a).key < rows.at(b).key
+                : rows.at(b).key < rows.at(a).key;
+    });
+    return result;
+}
+
+void tst_qqmlsortfilterindex::verify(const QQmlSortFilterIndex &index, const QVector<Row> &rows)
+{
+    const QVector<int> expected = expectedRows(rows, index.sortOrder());
+    QCOMPARE(index.sourceCount(), rows.count());
+    QCOMPARE(index.count(), expected.count());
+    for (int i = 0; i < expected.count(); ++i) {
+        QCOMPARE(index.sourceRow(i), expected.at(i));
+        QCOMPARE(index.viewRow(expected.at(i)), i);
+    }
+    for (int i = 0; i < rows.count(); ++i) {
+        if (!rows.at(i).accepted)
+            QCOMPARE(index.viewRow(i), -1);
+    }
+}
+
+void tst_qqmlsortfilterindex::reset()
+{
+    QQmlSortFilterIndex index;
+    QCOMPARE(index.count(), 0);
+    QCOMPARE(index.sourceCount(), 0);
+
+    index.reset({ 3, 1, 2, 1 }, { true, true, true, true });
+    QCOMPARE(index.count(), 4);
+    QCOMPARE(index.sourceRow(0), 1);
+    QCOMPARE(index.sourceRow(1), 3);
+    QCOMPARE(index.sourceRow(2), 2);
+    QCOMPARE(index.sourceRow(3), 0);
+    QCOMPARE(index.viewRow(0), 3);
+
+    index.clear();
+    QCOMPARE(index.count(), 0);
+    QCOMPARE(index.sourceCount(), 0);
+}
+
+void tst_qqmlsortfilterindex::filter()
+{
+    QQmlSortFilterIndex index;
+    index.reset({ 0, 0, 0, 0 }, { false, true, false, true });
+    QCOMPARE(index.count(), 2);
+    QCOMPARE(index.sourceCount(), 4);
+    QCOMPARE(index.sourceRow(0), 1);
+    QCOMPARE(index.sourceRow(1), 3);
+    QCOMPARE(index.viewRow(0), -1);
+    QCOMPARE(index.viewRow(3), 1);
+}
+
+void tst_qqmlsortfilterindex::sortOrder()
+{
+    QQmlSortFilterIndex index;
+    index.reset({ 1, 3, 2, 3 }, { true, true, true, true });
+    index.setSortOrder(Qt::DescendingOrder);
+    QCOMPARE(index.sortOrder(), Qt::DescendingOrder);
+
+    verify(index, { { 1, true }, { 3, true }, { 2, true }, { 3, true } });
+}
+
+void tst_qqmlsortfilterindex::insert()
+{
+    QQmlSortFilterIndex index;
+    index.reset({ 10, 20, 30 }, { true, true, true });
+
+    const QVector<int> viewRows = index.insertSourceRows(1, { 25, 5, 40 }, { true, true, false });
+    QCOMPARE(viewRows, QVector<int>({ 0, 3 }));
+
+    verify(index, { { 10, true }, { 25, true }, { 5, true }, { 40, false }, { 20, true }, { 30, true } });
+}
+
+void tst_qqmlsortfilterindex::remove()
+{
+    QQmlSortFilterIndex index;
+    index.reset({ 30, 10, 20, 40, 0 }, { true, true, false, true, true });
+
+    const QVector<int> viewRows = index.removeSourceRows(0, 3);
+    QCOMPARE(viewRows, QVector<int>({ 2, 1 }));
+
+    verify(index, { { 40, true }, { 0, true } });
+}
+
+void tst_qqmlsortfilterindex::change()
+{
+    QQmlSortFilterIndex index;
+    index.reset({ 10, 20, 30 }, { true, true, true });
+
+    int from = 0;
+    int to = 0;
+    index.changeSourceRow(0, 40, true, &from, &to);
+    QCOMPARE(from, 0);
+    QCOMPARE(to, 2);
+    verify(index, { { 40, true }, { 20, true }, { 30, true } });
+
+    index.changeSourceRow(1, 20, false, &from, &to);
+    QCOMPARE(from, 0);
+    QCOMPARE(to, -1);
+    verify(index, { { 40, true }, { 20, false }, { 30, true } });
+
+    index.changeSourceRow(1, 50, true, &from, &to);
+    QCOMPARE(from, -1);
+    QCOMPARE(to, 2);
+    verify(index, { { 40, true }, { 50, true }, { 30, true } });
+}
+
+// Applies random changes to both the index and a plain list of rows, and
+// verifies that the index always matches the sorted and filtered list.
+void tst_qqmlsortfilterindex::random()
+{
+    QVector<Row> rows;
+    QQmlSortFilterIndex index;
+    qsrand(0x5f3759df);
+
+    for (int i = 0; i < 500; ++i) {
+        const int op = qrand() % 10;
+        if (op < 4) {
+            const int row = qrand() % (rows.count() + 1);
+            const int count = 1 + qrand() % 5;
+            QVector<QVariant> keys;
+            QVector<bool> accepted;
+            QVector<Row> inserted;
+            for (int j = 0; j < count; ++j) {
+                inserted.append({ qrand() % 20, qrand() % 4 != 0 });
+                keys.append(inserted.last().key);
+                accepted.append(inserted.last().accepted);
+            }
+            index.insertSourceRows(row, keys, accepted);
+            for (int j = 0; j < count; ++j)
+                rows.insert(row + j, inserted.at(j));
+        } else if (op < 7 && !rows.isEmpty()) {
+            const int row = qrand() % rows.count();
+            const int count = 1 + qrand() % qMin(5, rows.count() - row);
+            index.removeSourceRows(row, count);
+            rows.remove(row, count);
+        } else if (op < 9 && !rows.isEmpty()) {
+            const int row = qrand() % rows.count();
+            const Row changed = { qrand() % 20, qrand() % 4 != 0 };
+            int from = 0;
+            int to = 0;
+            index.changeSourceRow(row, changed.key, changed.accepted, &from, &to);
+            rows[row] = changed;
+            QCOMPARE(to, index.viewRow(row));
+        } else {
+            index.setSortOrder(index.sortOrder() == Qt::AscendingOrder
+                    ? Qt::DescendingOrder : Qt::AscendingOrder);
+        }
+        verify(index, rows);
+    }
+}
+
+QTEST_MAIN(tst_qqmlsortfilterindex)
+
+#include "tst_qqmlsortfilterindex.moc"
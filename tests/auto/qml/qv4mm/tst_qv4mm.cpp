@@ -29,6 +29,76 @@
 #include <qtest.h>
 #include <QQmlEngine>
 #include <private/qv4mm_p.h>
+#include <private/qv8engine_p.h>
+
+// Sets environment variables for one test, and restores them however the test ends
+class EnvironmentGuard
+{
+public:
+    ~EnvironmentGuard()
+    {
+        for (auto it = m_saved.crbegin(); it != m_saved.crend(); ++it) {
+            if (it->wasSet)
+                qputenv(it->name, it->value);
+            else
+                qunsetenv(it->name);
+        }
+    }
+
+    void set(const char *name, const QByteArray &value)
+    {
+        save(name);
+        qputenv(name, value);
+    }
+
+    void unset(const char *name)
+    {
+        save(name);
+        qunsetenv(name);
+    }
+
+private:
+    struct Variable {
+        const char *name;
+        bool wasSet;
+        QByteArray value;
+    };
+
+    void save(const char *name)
+    {
+        m_saved.push_back({ name, qEnvironmentVariableIsSet(name), qgetenv(name) });
+    }
+
+    std::vector<Variable> m_saved;
+};
+
+// Stores some of many new objects into a list that is older than them, so that the writes happen
+// while the garbage in between gets collected, and checks that the listed objects survive.
+static void fillListWhileCollecting(QJSEngine &engine)
+{
+    QJSValue result = engine.evaluate(
+            "var list = [];\n"
+            "for (var i = 0; i < 1000; ++i)\n"
+            "    list.push(null);\n"
+            "for (var i = 0; i < 100000; ++i) {\n"
+            "    var item = { index: i, text: 'item ' + i, data: [i] };\n"
+            "    if (i % 100 == 0)\n"
+            "        list[i / 100] = item;\n"
+            "}\n"
+            "list.length");
+    QCOMPARE(result.toInt(), 1000);
+
+    QCoreApplication::processEvents();
+    result = engine.evaluate(
+            "list.every(function(item, i) {\n"
+            "    return item.index === i * 100 && item.text === 'item ' + i * 100 && item.data[0] === i * 100;\n"
+            "})");
+    QVERIFY(result.toBool());
+
+    engine.collectGarbage();
+    result = engine.evaluate("list[999].text");
+    QCOMPARE(result.toString(), QStringLiteral("item 99900"));
+}
 
 class tst_qv4mm : public QObject
 {
@@ -37,22 +107,107 @@ class tst_qv4mm : public QObject
 private slots:
     void gcStats();
     void tweaks();
+    void incrementalGC();
+    void backgroundSweep();
+    void generationalGC();
+    void objectTypeStatistics();
 };
 
 void tst_qv4mm::gcStats()
 {
-    qputenv(QV4_MM_STATS, "1");
+    EnvironmentGuard environment;
+    environment.set(QV4_MM_STATS, "1");
     QQmlEngine engine;
     engine.collectGarbage();
 }
 
 void tst_qv4mm::tweaks()
 {
-    qputenv(QV4_MM_MAXBLOCK_SHIFT, "5");
-    qputenv(QV4_MM_MAX_CHUNK_SIZE, "65536");
+    EnvironmentGuard environment;
+    environment.set(QV4_MM_MAXBLOCK_SHIFT, "5");
+    environment.set(QV4_MM_MAX_CHUNK_SIZE, "65536");
     QQmlEngine engine;
 }
 
+void tst_qv4mm::incrementalGC()
+{
+    EnvironmentGuard environment;
+    environment.unset(QV4_MM_STATS);
+    environment.set(QV4_MM_INCREMENTAL_GC, "1");
+    environment.set(QV4_MM_GC_SLICE_TIME, "1");
+    environment.set(QV4_MM_VERIFY_GC, "1");
+    QJSEngine engine;
+    QV4::MemoryManager *mm = QV8Engine::getV4(&engine)->memoryManager;
+    if (!mm->incrementalGC)
+        QSKIP("Incremental collection needs Qt QML built with -feature-qml-write-barrier");
+
+    fillListWhileCollecting(engine);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(mm->markingSlices > 0);
+}
+
+void tst_qv4mm::backgroundSweep()
+{
+    EnvironmentGuard environment;
+    environment.unset(QV4_MM_STATS);
+    environment.set(QV4_MM_BACKGROUND_SWEEP, "1");
+    QJSEngine engine;
+    QV4::MemoryManager *mm = QV8Engine::getV4(&engine)->memoryManager;
+    if (!mm->backgroundSweep)
+        QSKIP("Sweeping in the background needs thread support");
+
+    // Strings need to be destroyed on the JS thread, the plain objects can be swept by the worker
+    fillListWhileCollecting(engine);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(mm->blockAllocator.chunksSweptInBackground() > 0);
+}
+
+void tst_qv4mm::generationalGC()
+{
+    EnvironmentGuard environment;
+    environment.unset(QV4_MM_STATS);
+    environment.set(QV4_MM_GENERATIONAL_GC, "1");
+    environment.set(QV4_MM_NURSERY_SIZE, "65536");
+    environment.set(QV4_MM_VERIFY_GC, "1");
+    QJSEngine engine;
+    QV4::MemoryManager *mm = QV8Engine::getV4(&engine)->memoryManager;
+    if (!mm->generationalGC)
+        QSKIP("Generational collection needs Qt QML built with -feature-qml-write-barrier");
+
+    // The list gets old, and then has young items stored into it
+    fillListWhileCollecting(engine);
+    if (QTest::currentTestFailed())
+        return;
+    QVERIFY(mm->minorGCs > 0);
+}
+
+void tst_qv4mm::objectTypeStatistics()
+{
+    QJSEngine engine;
+    engine.evaluate("var list = [];\n"
+                    "for (var i = 0; i < 1000; ++i)\n"
+                    "    list.push({ index: i });");
+
+    QV4::MemoryManager *mm = QV8Engine::getV4(&engine)->memoryManager;
+    mm->runGC();
+
+    qint64 objects = 0;
+    qint64 size = 0;
+    const QV4::MemoryManager::ObjectTypeStatisticsHash statistics = mm->objectTypeStatistics();
+    for (auto it = statistics.constBegin(); it != statistics.constEnd(); ++it) {
+        QVERIFY(it->count > 0);
+        QVERIFY(it->size >= it->count * qint64(QV4::Chunk::SlotSize));
+        if (qstrcmp(it.key(), "Object") == 0) {
+            objects += it->count;
+            size += it->size;
+        }
+    }
+    QVERIFY(objects >= 1000);
+    QVERIFY(size <= qint64(mm->getUsedMem()));
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"
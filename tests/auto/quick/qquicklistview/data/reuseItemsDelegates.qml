@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.10
+import QtQml.Models 2.10
+
+ListView {
+    id: list
+    width: 240
+    height: 200
+
+    property int createdItems: 0
+
+    reuseItems: true
+    cacheBuffer: 0
+
+    model: DelegateModel {
+        model: 100
+
+        // The first delegate depends on the model data, so the delegate model
+        // can only choose between the two with an item bound to the index.
+        delegates: Delegate {
+            when: index % 3 == 0
+            Rectangle {
+                objectName: "third"
+                width: ListView.view.width
+                height: 20
+
+                property int boundIndex: index
+                property int rebinds: 0
+                property int reusedCount: 0
+
+                onBoundIndexChanged: ++rebinds
+                ListView.onReused: ++reusedCount
+                Component.onCompleted: ++list.createdItems
+            }
+        }
+
+        delegate: Rectangle {
+            objectName: "other"
+            width: ListView.view.width
+            height: 20
+
+            property int boundIndex: index
+            property int rebinds: 0
+            property int reusedCount: 0
+
+            onBoundIndexChanged: ++rebinds
+            ListView.onReused: ++reusedCount
+            Component.onCompleted: ++list.createdItems
+        }
+    }
+}
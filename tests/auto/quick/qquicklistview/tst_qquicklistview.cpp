@@ -256,6 +256,9 @@ private slots:
     void itemFiltered();
     void releaseItems();
 
+    void reuseItems();
+    void reuseItems_delegates();
+
 private:
     template <class T> void items(const QUrl &source);
     template <class T> void changed(const QUrl &source);
@@ -8521,6 +8524,90 @@ void tst_QQuickListView::releaseItems()
     listview->setModel(123);
 }
 
+static void scrollRowByRow(QQuickListView *listview, int rows, qreal rowHeight)
+{
+    for (int i = 0; i < rows; ++i) {
+        listview->setContentY(listview->contentY() + rowHeight);
+        QTRY_COMPARE(QQuickItemPrivate::get(listview)->polishScheduled, false);
+    }
+}
+
+void tst_QQuickListView::reuseItems()
+{
+    QScopedPointer<QQuickView> window(createView());
+    window->setSource(testFileUrl("reuseItems.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickListView *listview = qobject_cast<QQuickListView *>(window->rootObject());
+    QVERIFY(listview);
+    QVERIFY(listview->reuseItems());
+    QTRY_COMPARE(QQuickItemPrivate::get(listview)->polishScheduled, false);
+
+    const int createdItems = listview->property("createdItems").toInt();
+    QCOMPARE(createdItems, 10);
+
+    // Each row that scrolls into view takes the item of the row that
+    // scrolled out, so no more than the first one or two need to be created.
+    scrollRowByRow(listview, 50, 20);
+    QVERIFY(listview->property("createdItems").toInt() <= createdItems + 2);
+    QCOMPARE(listview->property("destroyedItems").toInt(), 0);
+
+    QList<QQuickItem *> items = findItems<QQuickItem>(listview->contentItem(), "delegate");
+    QVERIFY(!items.isEmpty());
+    int reusedItems = 0;
+    for (QQuickItem *item : qAsConst(items)) {
+        // Pooled items stay in the view, culled.
+        const bool pooled = QQuickItemPrivate::get(item)->culled;
+        if (!pooled)
+            QVERIFY(item->property("boundIndex").toInt() >= 50);
+        const int reusedCount = item->property("reusedCount").toInt();
+        QCOMPARE(item->property("pooledCount").toInt() - reusedCount, pooled ? 1 : 0);
+        QCOMPARE(item->property("rebinds").toInt(), reusedCount);
+        reusedItems += reusedCount > 0;
+    }
+    QVERIFY(reusedItems > 0);
+
+    // Without reuse, the items that scroll out are destroyed.
+    listview->setReuseItems(false);
+    const int destroyedItems = listview->property("destroyedItems").toInt();
+    scrollRowByRow(listview, 10, 20);
+    QVERIFY(listview->property("destroyedItems").toInt() >= destroyedItems + 10);
+}
+
+void tst_QQuickListView::reuseItems_delegates()
+{
+    QScopedPointer<QQuickView> window(createView());
+    window->setSource(testFileUrl("reuseItemsDelegates.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickListView *listview = qobject_cast<QQuickListView *>(window->rootObject());
+    QVERIFY(listview);
+    QTRY_COMPARE(QQuickItemPrivate::get(listview)->polishScheduled, false);
+
+    const int createdItems = listview->property("createdItems").toInt();
+    scrollRowByRow(listview, 60, 20);
+    QVERIFY(listview->property("createdItems").toInt() <= createdItems + 4);
+
+    // A pooled item is only rebound when it is reused for an index that
+    // resolves to its own delegate, so every rebind is a reuse.
+    const QStringList names = { QStringLiteral("third"), QStringLiteral("other") };
+    int reusedItems = 0;
+    for (const QString &name : names) {
+        const QList<QQuickItem *> items = findItems<QQuickItem>(listview->contentItem(), name);
+        for (QQuickItem *item : items) {
+            const int index = item->property("boundIndex").toInt();
+            if (!QQuickItemPrivate::get(item)->culled)
+                QCOMPARE(item->objectName(), index % 3 == 0 ? names.at(0) : names.at(1));
+            const int reusedCount = item->property("reusedCount").toInt();
+            QCOMPARE(item->property("rebinds").toInt(), reusedCount);
+            reusedItems += reusedCount > 0;
+        }
+    }
+    QVERIFY(reusedItems > 0);
+}
+
 QTEST_MAIN(tst_QQuickListView)
 
 #include "tst_qquicklistview.moc"
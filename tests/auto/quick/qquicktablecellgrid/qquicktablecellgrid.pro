@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = tst_qquicktablecellgrid
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qquicktablecellgrid.cpp
+
+QT += core-private gui-private qml-private quick-private testlib
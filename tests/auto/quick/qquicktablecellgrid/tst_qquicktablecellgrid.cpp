@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <qtest.h>
+#include <QtCore/qhash.h>
+#include <private/qquicktablecellgrid_p.h>
+
+class tst_qquicktablecellgrid : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndTake();
+    void replace();
+    void grow();
+    void slide();
+    void clear();
+    void random();
+
+private:
+    // The grid never dereferences its items, so any distinct pointers will do
+    static FxViewItem *item(int n) { return reinterpret_cast<FxViewItem *>(quintptr(n + 1) * sizeof(void *)); }
+};
+
+void tst_qquicktablecellgrid::insertAndTake()
+{
+    QQuickTableCellGrid grid;
+    QVERIFY(grid.isEmpty());
+    QVERIFY(!grid.at(0, 0));
+    QVERIFY(!grid.take(0, 0));
+    QVERIFY(!grid.at(-1, 0));
+
+    grid.insert(0, 0, item(0));
+    grid.insert(2, 5, item(1));
+    QCOMPARE(grid.count(), 2);
+    QCOMPARE(grid.at(0, 0), item(0));
+    QCOMPARE(grid.at(2, 5), item(1));
+    QVERIFY(!grid.at(5, 2));
+    QVERIFY(!grid.at(0, 1));
+
+    QCOMPARE(grid.take(2, 5), item(1));
+    QVERIFY(!grid.take(2, 5));
+    QVERIFY(!grid.at(2, 5));
+    QCOMPARE(grid.count(), 1);
+
+    QCOMPARE(grid.take(0, 0), item(0));
+    QVERIFY(grid.isEmpty());
+}
+
+void tst_qquicktablecellgrid::replace()
+{
+    QQuickTableCellGrid grid;
+    grid.insert(3, 4, item(0));
+    grid.insert(3, 4, item(1));
+    QCOMPARE(grid.count(), 1);
+    QCOMPARE(grid.at(3, 4), item(1));
+}
+
+// A block larger than the initial capacity, and cells far apart in the
+// table, force the grid to grow without losing any of its cells.
+void tst_qquicktablecellgrid::grow()
+{
+    QQuickTableCellGrid grid;
+    const int rows = 50;
+    const int columns = 20;
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column)
+            grid.insert(row, column, item(row * columns + column));
+    }
+    QCOMPARE(grid.count(), rows * columns);
+
+    grid.insert(100000, 3, item(-2));
+    grid.insert(7, 100000, item(-3));
+    QCOMPARE(grid.count(), rows * columns + 2);
+
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column)
+            QCOMPARE(grid.at(row, column), item(row * columns + column));
+    }
+    QCOMPARE(grid.at(100000, 3), item(-2));
+    QCOMPARE(grid.at(7, 100000), item(-3));
+    QVERIFY(!grid.at(100000 - 64, 3));
+}
+
+// Slides a loaded block over the table the way a flicked TableView does,
+// unloading one edge while loading the opposite one.
+void tst_qquicktablecellgrid::slide()
+{
+    QQuickTableCellGrid grid;
+    const int rows = 10;
+    const int columns = 6;
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column)
+            grid.insert(row, column, item(row * 1000 + column));
+    }
+
+    for (int top = 1; top < 500; ++top) {
+        for (int column = 0; column < columns; ++column) {
+            QCOMPARE(grid.take(top - 1, column), item((top - 1) * 1000 + column));
+            grid.insert(top + rows - 1, column, item((top + rows - 1) * 1000 + column));
+        }
+        QCOMPARE(grid.count(), rows * columns);
+        QVERIFY(!grid.at(top - 1, 0));
+        QCOMPARE(grid.at(top, columns - 1), item(top * 1000 + columns - 1));
+        QCOMPARE(grid.at(top + rows - 1, 0), item((top + rows - 1) * 1000));
+    }
+
+    for (int left = 1; left < 100; ++left) {
+        for (int row = 499; row < 499 + rows; ++row) {
+            QVERIFY(grid.take(row, left - 1));
+            grid.insert(row, left + columns - 1, item(row * 1000 + left + columns - 1));
+        }
+        QCOMPARE(grid.count(), rows * columns);
+        QVERIFY(!grid.at(499, left - 1));
+        QCOMPARE(grid.at(508, left + columns - 1), item(508 * 1000 + left + columns - 1));
+    }
+}
+
+void tst_qquicktablecellgrid::clear()
+{
+    QQuickTableCellGrid grid;
+    grid.clear();
+    QVERIFY(grid.isEmpty());
+
+    grid.insert(1, 1, item(0));
+    grid.insert(20, 30, item(1));
+    grid.clear();
+    QVERIFY(grid.isEmpty());
+    QVERIFY(!grid.at(1, 1));
+    QVERIFY(!grid.at(20, 30));
+
+    grid.insert(20, 30, item(2));
+    QCOMPARE(grid.count(), 1);
+    QCOMPARE(grid.at(20, 30), item(2));
+}
+
+// Applies random inserts and takes to both the grid and a QHash, and
+// verifies that they always agree.
+void tst_qquicktablecellgrid::random()
+{
+    QQuickTableCellGrid grid;
+    QHash<QPair<int, int>, FxViewItem *> cells;
+    qsrand(0x5f3759df);
+
+    for (int i = 0; i < 20000; ++i) {
+        const int row = qrand() % 200;
+        const int column = qrand() % 40;
+        if (qrand() % 3) {
+            grid.insert(row, column, item(i));
+            cells.insert(qMakePair(row, column), item(i));
+        } else {
+            QCOMPARE(grid.take(row, column), cells.take(qMakePair(row, column)));
+        }
+        QCOMPARE(grid.count(), cells.count());
+        QCOMPARE(grid.at(row, column), cells.value(qMakePair(row, column)));
+    }
+
+    for (auto it = cells.cbegin(); it != cells.cend(); ++it)
+        QCOMPARE(grid.at(it.key().first, it.key().second), it.value());
+}
+
+QTEST_MAIN(tst_qquicktablecellgrid)
+
+#include "tst_qquicktablecellgrid.moc"
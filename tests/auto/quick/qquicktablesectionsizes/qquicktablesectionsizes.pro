@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = tst_qquicktablesectionsizes
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qquicktablesectionsizes.cpp
+
+QT += core-private gui-private qml-private quick-private testlib
@@ -0,0 +1,336 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <private/qquicktablesectionsizes_p.h>
+
+class tst_qquicktablesectionsizes : public QObject
+{
+    Q_OBJECT
+private slots:
+    void estimated();
+    void explicitSizes();
+    void spacing();
+    void insertSections();
+    void removeSections();
+    void setCount();
+    void measuredSizes();
+    void largeCount();
+    void random();
+
+private:
+    struct Section
+    {
+        qreal size;
+        bool hasSize;
+        bool measured;
+    };
+
+    static void verify(const QQuickTableSectionSizes &sizes, const QVector<Section> &sections);
+};
+
+void tst_qquicktablesectionsizes::verify(const QQuickTableSectionSizes &sizes, const QVector<Section> &sections)
+{
+    QCOMPARE(sizes.count(), sections.count());
+
+    int explicitSizes = 0;
+    qreal pos = 0;
+    for (int i = 0; i < sections.count(); ++i) {
+        const Section &section = sections.at(i);
+        const qreal size = section.hasSize ? section.size : sizes.estimatedSize();
+        QCOMPARE(sizes.hasSize(i), section.hasSize);
+        QCOMPARE(sizes.isMeasured(i), section.hasSize && section.measured);
+        QCOMPARE(sizes.size(i), size);
+        QCOMPARE(sizes.position(i), pos);
+
+        // Sections of size zero (and no spacing) share their position with
+        // the ones that follow, so only check sections that have an extent.
+        if (size + sizes.spacing() > 0) {
+            QCOMPARE(sizes.sectionAt(pos), i);
+            QCOMPARE(sizes.sectionAt(pos + (size + sizes.spacing()) / 2), i);
+        }
+
+        pos += size + sizes.spacing();
+        explicitSizes += section.hasSize;
+    }
+
+    QCOMPARE(sizes.explicitSizeCount(), explicitSizes);
+    QCOMPARE(sizes.position(sections.count()), pos);
+    QCOMPARE(sizes.totalSize(), sections.isEmpty() ? 0 : pos - sizes.spacing());
+    QCOMPARE(sizes.sectionAt(pos + 100), sections.count() - 1);
+    QCOMPARE(sizes.sectionAt(-100), sections.isEmpty() ? -1 : 0);
+}
+
+void tst_qquicktablesectionsizes::estimated()
+{
+    QQuickTableSectionSizes sizes(20);
+    QCOMPARE(sizes.count(), 0);
+    QCOMPARE(sizes.totalSize(), qreal(0));
+    QCOMPARE(sizes.sectionAt(0), -1);
+
+    sizes.setCount(100);
+    QCOMPARE(sizes.explicitSizeCount(), 0);
+    QCOMPARE(sizes.position(10), qreal(200));
+    QCOMPARE(sizes.totalSize(), qreal(2000));
+    QCOMPARE(sizes.sectionAt(199), 9);
+    QCOMPARE(sizes.sectionAt(200), 10);
+    QCOMPARE(sizes.sectionAt(5000), 99);
+
+    sizes.setDefaultSize(10);
+    QCOMPARE(sizes.estimatedSize(), qreal(10));
+    QCOMPARE(sizes.totalSize(), qreal(1000));
+}
+
+void tst_qquicktablesectionsizes::explicitSizes()
+{
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(10);
+
+    sizes.setSize(2, 50);
+    sizes.setSize(5, 0);
+    QVector<Section> sections(10, { 0, false, false });
+    sections[2] = { 50, true, false };
+    sections[5] = { 0, true, false };
+    verify(sizes, sections);
+
+    sizes.setSize(2, 30);
+    sections[2].size = 30;
+    verify(sizes, sections);
+
+    sizes.resetSize(2);
+    sections[2].hasSize = false;
+    verify(sizes, sections);
+
+    // Negative sizes are stored as zero
+    sizes.setSize(7, -10);
+    sections[7] = { 0, true, false };
+    verify(sizes, sections);
+
+    sizes.resetAllSizes();
+    verify(sizes, QVector<Section>(10, { 0, false, false }));
+}
+
+void tst_qquicktablesectionsizes::spacing()
+{
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(10);
+    sizes.setSpacing(5);
+    QCOMPARE(sizes.position(3), qreal(75));
+    QCOMPARE(sizes.totalSize(), qreal(245));
+
+    // The spacing after a section belongs to that section
+    QCOMPARE(sizes.sectionAt(74), 2);
+    QCOMPARE(sizes.sectionAt(75), 3);
+
+    sizes.setSize(1, 10);
+    QVector<Section> sections(10, { 0, false, false });
+    sections[1] = { 10, true, false };
+    verify(sizes, sections);
+}
+
+void tst_qquicktablesectionsizes::insertSections()
+{
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(10);
+    sizes.setSize(0, 10);
+    sizes.setSize(4, 40);
+    sizes.setMeasuredSize(9, 90);
+
+    // The sizes move along with their sections
+    sizes.insertSections(4, 3);
+    QVector<Section> sections(13, { 0, false, false });
+    sections[0] = { 10, true, false };
+    sections[7] = { 40, true, false };
+    sections[12] = { 90, true, true };
+    verify(sizes, sections);
+
+    sizes.insertSections(0, 1);
+    sections.prepend({ 0, false, false });
+    verify(sizes, sections);
+
+    sizes.insertSections(sizes.count(), 2);
+    sections.append({ 0, false, false });
+    sections.append({ 0, false, false });
+    verify(sizes, sections);
+}
+
+void tst_qquicktablesectionsizes::removeSections()
+{
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(10);
+    sizes.setSize(1, 10);
+    sizes.setMeasuredSize(3, 30);
+    sizes.setSize(8, 80);
+
+    // The sizes of the removed sections go with them
+    sizes.removeSections(2, 3);
+    QVector<Section> sections(7, { 0, false, false });
+    sections[1] = { 10, true, false };
+    sections[5] = { 80, true, false };
+    verify(sizes, sections);
+    QVERIFY(!sizes.updateEstimatedSize(0));
+
+    sizes.removeSections(0, 100);
+    sections.remove(0, 7);
+    verify(sizes, sections);
+}
+
+void tst_qquicktablesectionsizes::setCount()
+{
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(10);
+    sizes.setSize(2, 10);
+    sizes.setSize(8, 10);
+
+    sizes.setCount(5);
+    QVector<Section> sections(5, { 0, false, false });
+    sections[2] = { 10, true, false };
+    verify(sizes, sections);
+
+    // Growing the table does not bring back the sizes that were dropped
+    sizes.setCount(10);
+    sections.resize(10);
+    verify(sizes, sections);
+}
+
+void tst_qquicktablesectionsizes::measuredSizes()
+{
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(10);
+    sizes.setSize(0, 100);
+    sizes.setMeasuredSize(1, 30);
+    sizes.setMeasuredSize(2, 50);
+
+    // The estimated size moves to the average measured size only
+    QVERIFY(sizes.updateEstimatedSize(0.1));
+    QCOMPARE(sizes.estimatedSize(), qreal(40));
+    QVERIFY(!sizes.updateEstimatedSize(0.1));
+    sizes.setMeasuredSize(3, 44);
+    QVERIFY(!sizes.updateEstimatedSize(0.1));
+
+    // A fixed size replaces a measured one
+    sizes.setSize(3, 10);
+    QVERIFY(sizes.hasSize(3));
+    QVERIFY(!sizes.isMeasured(3));
+
+    sizes.resetMeasuredSizes();
+    QCOMPARE(sizes.estimatedSize(), qreal(20));
+    QVector<Section> sections(10, { 0, false, false });
+    sections[0] = { 100, true, false };
+    sections[3] = { 10, true, false };
+    verify(sizes, sections);
+
+    sizes.setMeasuredSize(5, 10);
+    sizes.resetSize(0);
+    sizes.resetSize(3);
+    sizes.resetMeasuredSizes();
+    QCOMPARE(sizes.explicitSizeCount(), 0);
+}
+
+// The memory used, and the time taken by inserts and removes, only depend on
+// the number of explicit sizes, not on the number of sections.
+void tst_qquicktablesectionsizes::largeCount()
+{
+    const int count = 10000000;
+    QQuickTableSectionSizes sizes(20);
+    sizes.setCount(count);
+    QCOMPARE(sizes.totalSize(), qreal(20) * count);
+
+    for (int i = 0; i < 1000; ++i)
+        sizes.setSize(i * 9973, 30);
+    QCOMPARE(sizes.explicitSizeCount(), 1000);
+    QCOMPARE(sizes.totalSize(), qreal(20) * count + 1000 * 10);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 10000; ++i) {
+        sizes.insertSections(0, 1);
+        sizes.removeSections(1, 1);
+    }
+    QVERIFY(timer.elapsed() < 5000);
+
+    // Each pair of calls moves the sizes of sections 1 and up back to where
+    // they were, while section 0 takes the estimated size.
+    QCOMPARE(sizes.count(), count);
+    QCOMPARE(sizes.explicitSizeCount(), 999);
+    QVERIFY(!sizes.hasSize(0));
+    QCOMPARE(sizes.size(9973), qreal(30));
+    QCOMPARE(sizes.position(9973), qreal(20) * 9973);
+    QCOMPARE(sizes.sectionAt(qreal(20) * 9973 + 25), 9973);
+    QCOMPARE(sizes.sectionAt(qreal(20) * 9973 + 35), 9974);
+
+    sizes.insertSections(count / 2, count);
+    QCOMPARE(sizes.count(), 2 * count);
+    QCOMPARE(sizes.explicitSizeCount(), 999);
+}
+
+// Applies random changes to both the sizes and a plain list of sections, and
+// verifies that positions and lookups always match the list.
+void tst_qquicktablesectionsizes::random()
+{
+    QVector<Section> sections;
+    QQuickTableSectionSizes sizes(10);
+    sizes.setSpacing(2);
+    qsrand(0x5f3759df);
+
+    for (int i = 0; i < 1000; ++i) {
+        const int op = qrand() % 10;
+        if (op < 2) {
+            const int section = qrand() % (sections.count() + 1);
+            const int count = 1 + qrand() % 5;
+            sizes.insertSections(section, count);
+            sections.insert(section, count, { 0, false, false });
+        } else if (op < 4 && !sections.isEmpty()) {
+            const int section = qrand() % sections.count();
+            const int count = 1 + qrand() % qMin(5, sections.count() - section);
+            sizes.removeSections(section, count);
+            sections.remove(section, count);
+        } else if (op < 8 && !sections.isEmpty()) {
+            const int section = qrand() % sections.count();
+            const Section changed = { qreal(qrand() % 30), true, op == 7 };
+            if (changed.measured)
+                sizes.setMeasuredSize(section, changed.size);
+            else
+                sizes.setSize(section, changed.size);
+            sections[section] = changed;
+        } else if (op < 9 && !sections.isEmpty()) {
+            const int section = qrand() % sections.count();
+            sizes.resetSize(section);
+            sections[section].hasSize = false;
+        } else {
+            const int count = qrand() % 60;
+            sizes.setCount(count);
+            sections.resize(count);
+        }
+        verify(sizes, sections);
+    }
+}
+
+QTEST_MAIN(tst_qquicktablesectionsizes)
+
+#include "tst_qquicktablesectionsizes.moc"
@@ -0,0 +1,7 @@
+CONFIG += testcase
+TARGET = tst_qquicktablespans
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qquicktablespans.cpp
+
+QT += core-private gui-private qml-private quick-private testlib
@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <private/qquicktablespans_p.h>
+
+#include <algorithm>
+
+class tst_qquicktablespans : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insert();
+    void remove();
+    void spanAt();
+    void insertRows();
+    void removeRows();
+    void manySpans();
+    void random();
+
+private:
+    static QRect findSpan(const QVector<QRect> &spans, int row, int column);
+    static void verify(const QQuickTableSpans &tableSpans, const QVector<QRect> &spans, int rows, int columns);
+};
+
+QRect tst_qquicktablespans::findSpan(const QVector<QRect> &spans, int row, int column)
+{
+    for (const QRect &span : spans) {
+        if (span.contains(column, row))
+            return span;
+    }
+    return QRect();
+}
+
+void tst_qquicktablespans::verify(const QQuickTableSpans &tableSpans, const QVector<QRect> &spans, int rows, int columns)
+{
+    QCOMPARE(tableSpans.count(), spans.count());
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column)
+            QCOMPARE(tableSpans.spanAt(row, column), findSpan(spans, row, column));
+    }
+}
+
+void tst_qquicktablespans::insert()
+{
+    QQuickTableSpans spans;
+    QVERIFY(spans.isEmpty());
+
+    QVERIFY(spans.insert(QRect(1, 1, 2, 3)));
+    QVERIFY(spans.insert(QRect(3, 1, 1, 2)));
+    QCOMPARE(spans.count(), 2);
+
+    // Spans that overlap others, or are empty or out of the table, are rejected
+    QVERIFY(!spans.insert(QRect(0, 0, 2, 2)));
+    QVERIFY(!spans.insert(QRect(2, 3, 3, 1)));
+    QVERIFY(!spans.insert(QRect(5, 5, 0, 2)));
+    QVERIFY(!spans.insert(QRect(-1, 5, 2, 2)));
+    QCOMPARE(spans.count(), 2);
+
+    QVERIFY(spans.intersects(QRect(0, 3, 2, 1)));
+    QVERIFY(!spans.intersects(QRect(0, 4, 10, 1)));
+    QVERIFY(!spans.intersects(QRect(0, 0, 1, 10)));
+
+    spans.clear();
+    QVERIFY(spans.isEmpty());
+    QVERIFY(spans.spanAt(1, 1).isNull());
+}
+
+void tst_qquicktablespans::remove()
+{
+    QQuickTableSpans spans;
+    QVERIFY(spans.insert(QRect(0, 0, 2, 2)));
+    QVERIFY(spans.insert(QRect(0, 2, 2, 2)));
+    QCOMPARE(spans.spanAt(3, 1), QRect(0, 2, 2, 2));
+
+    // Only a span with its top-left cell at the given cell is removed
+    QVERIFY(!spans.remove(3, 1));
+    QVERIFY(spans.remove(2, 0));
+    QCOMPARE(spans.count(), 1);
+    QVERIFY(spans.spanAt(3, 1).isNull());
+    QCOMPARE(spans.spanAt(1, 1), QRect(0, 0, 2, 2));
+
+    // The cells of a removed span can be spanned again
+    QVERIFY(spans.insert(QRect(1, 2, 1, 3)));
+    QCOMPARE(spans.spanAt(4, 1), QRect(1, 2, 1, 3));
+}
+
+void tst_qquicktablespans::spanAt()
+{
+    QVector<QRect> spans;
+    spans << QRect(0, 0, 3, 1) << QRect(3, 0, 1, 5) << QRect(0, 2, 2, 2)
+          << QRect(1, 5, 3, 3) << QRect(0, 9, 4, 1);
+
+    QQuickTableSpans tableSpans;
+    for (const QRect &span : qAsConst(spans))
+        QVERIFY(tableSpans.insert(span));
+    verify(tableSpans, spans, 12, 6);
+}
+
+void tst_qquicktablespans::insertRows()
+{
+    QQuickTableSpans spans;
+    QVERIFY(spans.insert(QRect(0, 0, 2, 2)));
+    QVERIFY(spans.insert(QRect(0, 3, 2, 2)));
+    QVERIFY(spans.insert(QRect(2, 1, 1, 3)));
+
+    // Spans below the rows move down, spans the rows are inserted into grow
+    spans.insertRows(2, 2);
+    QVector<QRect> expected;
+    expected << QRect(0, 0, 2, 2) << QRect(0, 5, 2, 2) << QRect(2, 1, 1, 5);
+    verify(spans, expected, 10, 4);
+
+    // Rows inserted at the top row of a span move it
+    spans.insertRows(0, 1);
+    expected.clear();
+    expected << QRect(0, 1, 2, 2) << QRect(0, 6, 2, 2) << QRect(2, 2, 1, 5);
+    verify(spans, expected, 10, 4);
+}
+
+void tst_qquicktablespans::removeRows()
+{
+    QQuickTableSpans spans;
+    QVERIFY(spans.insert(QRect(0, 0, 2, 2)));
+    QVERIFY(spans.insert(QRect(0, 4, 2, 3)));
+    QVERIFY(spans.insert(QRect(2, 1, 1, 3)));
+    QVERIFY(spans.insert(QRect(3, 2, 1, 2)));
+    QVERIFY(spans.insert(QRect(0, 8, 3, 1)));
+
+    // Spans below the rows move up, and spans that lose rows shrink. Spans
+    // that are left with a single cell are removed.
+    spans.removeRows(1, 2);
+    QVector<QRect> expected;
+    expected << QRect(0, 0, 2, 1) << QRect(0, 2, 2, 3) << QRect(0, 6, 3, 1);
+    verify(spans, expected, 10, 4);
+
+    spans.removeRows(2, 3);
+    expected.clear();
+    expected << QRect(0, 0, 2, 1) << QRect(0, 3, 3, 1);
+    verify(spans, expected, 10, 4);
+}
+
+void tst_qquicktablespans::manySpans()
+{
+    // Each span is checked against the others when it's added,
+    // which must not take time in proportion to the spans so far
+    const int count = 100000;
+    QQuickTableSpans spans;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i)
+        QVERIFY(spans.insert(QRect(i % 10 * 3, i / 10 * 2, 2, 2)));
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(spans.spanAt(i / 10 * 2 + 1, i % 10 * 3 + 1), QRect(i % 10 * 3, i / 10 * 2, 2, 2));
+    QVERIFY(timer.elapsed() < 5000);
+
+    QCOMPARE(spans.count(), count);
+    QVERIFY(spans.spanAt(1, 2).isNull());
+    QVERIFY(!spans.insert(QRect(1, count / 10, 2, 2)));
+}
+
+// Applies random changes to both the spans and a plain list of them, and
+// verifies that lookups always match the list.
+void tst_qquicktablespans::random()
+{
+    const int rows = 40;
+    const int columns = 8;
+    QQuickTableSpans tableSpans;
+    QVector<QRect> spans;
+    qsrand(0x5f3759df);
+
+    for (int i = 0; i < 1000; ++i) {
+        const int op = qrand() % 10;
+        if (op < 5) {
+            const QRect span(qrand() % columns, qrand() % rows, 1 + qrand() % 3, 1 + qrand() % 4);
+            const bool overlaps = std::any_of(spans.cbegin(), spans.cend(), [&](const QRect &other) {
+                return other.intersects(span);
+            });
+            QCOMPARE(tableSpans.insert(span), !overlaps);
+            if (!overlaps)
+                spans.append(span);
+        } else if (op < 6 && !spans.isEmpty()) {
+            const QRect span = spans.takeAt(qrand() % spans.count());
+            QVERIFY(tableSpans.remove(span.top(), span.left()));
+        } else if (op < 8) {
+            const int row = qrand() % rows;
+            const int count = 1 + qrand() % 3;
+            tableSpans.insertRows(row, count);
+            for (QRect &span : spans) {
+                if (span.top() >= row)
+                    span.translate(0, count);
+                else if (span.bottom() >= row)
+                    span.setBottom(span.bottom() + count);
+            }
+        } else {
+            const int row = qrand() % rows;
+            const int count = 1 + qrand() % 3;
+            tableSpans.removeRows(row, count);
+            QVector<QRect> shrunk;
+            for (QRect span : qAsConst(spans)) {
+                if (span.top() >= row + count) {
+                    span.translate(0, -count);
+                } else if (span.bottom() >= row) {
+                    const int kept = qMax(0, row - span.top()) + qMax(0, span.bottom() + 1 - row - count);
+                    span = QRect(span.left(), qMin(span.top(), row), span.width(), kept);
+                    if (kept == 0 || (kept == 1 && span.width() == 1))
+                        continue;
+                }
+                shrunk.append(span);
+            }
+            spans = shrunk;
+        }
+        verify(tableSpans, spans, rows + 10, columns + 3);
+    }
+}
+
+QTEST_MAIN(tst_qquicktablespans)
+
+#include "tst_qquicktablespans.moc"
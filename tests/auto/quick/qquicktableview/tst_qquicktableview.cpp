@@ -0,0 +1,772 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qabstractitemmodel.h>
+#include <QtCore/qmath.h>
+#include <QtGui/qfontmetrics.h>
+#include <QtQml/qqmlcontext.h>
+#include <QtQuick/qquickview.h>
+#include <QtQuick/private/qquicktableview_p.h>
+#include <QtQuick/private/qquickitem_p.h>
+#include "../../shared/util.h"
+#include "../shared/viewtestutil.h"
+
+using namespace QQuickViewTestUtil;
+
+class TableModel : public QAbstractTableModel
+{
+public:
+    TableModel(int rows, int columns)
+        : m_rows(rows)
+    {
+        for (int column = 0; column < columns; ++column)
+            m_columns.append(column);
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_rows;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_columns.count();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (role != Qt::DisplayRole)
+            return QVariant();
+        const auto text = m_texts.constFind(qMakePair(index.row(), index.column()));
+        if (text != m_texts.cend())
+            return *text;
+        return QString::number(index.row()) + QLatin1Char(',') + QString::number(m_columns.at(index.column()));
+    }
+
+    void setText(int row, int column, const QString &text)
+    {
+        m_texts.insert(qMakePair(row, column), text);
+        emit dataChanged(index(row, column), index(row, column));
+    }
+
+    void insertRows(int row, int count)
+    {
+        beginInsertRows(QModelIndex(), row, row + count - 1);
+        m_rows += count;
+        endInsertRows();
+    }
+
+    void removeRows(int row, int count)
+    {
+        beginRemoveRows(QModelIndex(), row, row + count - 1);
+        m_rows -= count;
+        endRemoveRows();
+    }
+
+    void insertColumn(int column, int id)
+    {
+        beginInsertColumns(QModelIndex(), column, column);
+        m_columns.insert(column, id);
+        endInsertColumns();
+    }
+
+    void moveColumn(int from, int to)
+    {
+        beginMoveColumns(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+        m_columns.move(from, to);
+        endMoveColumns();
+    }
+
+private:
+    int m_rows;
+    QVector<int> m_columns;
+    QHash<QPair<int, int>, QString> m_texts;
+};
+
+class FetchMoreModel : public TableModel
+{
+public:
+    FetchMoreModel(int rows, int columns, int totalRows, int pageSize)
+        : TableModel(rows, columns)
+        , canFetchMoreCalls(0)
+        , fetchMoreCalls(0)
+        , m_totalRows(totalRows)
+        , m_pageSize(pageSize)
+    {
+    }
+
+    bool canFetchMore(const QModelIndex &parent) const override
+    {
+        ++canFetchMoreCalls;
+        return !parent.isValid() && rowCount() < m_totalRows;
+    }
+
+    void fetchMore(const QModelIndex &parent) override
+    {
+        if (parent.isValid())
+            return;
+        ++fetchMoreCalls;
+        insertRows(rowCount(), qMin(m_pageSize, m_totalRows - rowCount()));
+    }
+
+    mutable int canFetchMoreCalls;
+    int fetchMoreCalls;
+
+private:
+    int m_totalRows;
+    int m_pageSize;
+};
+
+class tst_QQuickTableView : public QQmlDataTest
+{
+    Q_OBJECT
+private slots:
+    void failedCells();
+    void scrollByCell();
+    void largeModel();
+    void modelRows();
+    void modelColumns();
+    void fetchRowsAhead();
+    void providers();
+    void estimatedSizes();
+    void frozen();
+    void positionViewAtCell_data();
+    void positionViewAtCell();
+    void positionViewAtIndex();
+    void sizeCallbacks();
+    void spans();
+    void resizeColumnToContents();
+    void resizeColumnToText();
+
+private:
+    static QQuickTableView *loadTableView(QQuickView *window, const QString &fileName);
+};
+
+QQuickTableView *tst_QQuickTableView::loadTableView(QQuickView *window, const QString &fileName)
+{
+    window->setSource(testFileUrl(fileName));
+    window->show();
+    if (!QTest::qWaitForWindowExposed(window))
+        return nullptr;
+
+    QQuickTableView *tableView = qobject_cast<QQuickTableView *>(window->rootObject());
+    if (tableView && !QTest::qWaitFor([&]() { return !QQuickItemPrivate::get(tableView)->polishScheduled; }))
+        return nullptr;
+    return tableView;
+}
+
+void tst_QQuickTableView::failedCells()
+{
+    // Cells whose delegate cannot be created are left empty, and do not keep
+    // the table from loading the rest of the row or column they are in.
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*Delegate must be of Item type"));
+    QScopedPointer<QQuickView> window(createView());
+    QQuickTableView *tableView = loadTableView(window.data(), "failedCells.qml");
+    QVERIFY(tableView);
+
+    QVERIFY(!tableView->itemAtCell(1, 2));
+    QVERIFY(tableView->itemAtCell(1, 1));
+    QVERIFY(tableView->itemAtCell(1, 3));
+    QVERIFY(tableView->itemAtCell(2, 2));
+
+    // The column with the other failing cell is first loaded into the cache
+    // buffer, with incubated items, and then flicked into view.
+    tableView->setContentX(260);
+    QTRY_VERIFY(tableView->itemAtCell(0, 9));
+    QVERIFY(!tableView->itemAtCell(4, 5));
+    QVERIFY(tableView->itemAtCell(3, 5));
+    QVERIFY(tableView->itemAtCell(5, 5));
+
+    tableView->setContentY(400);
+    QTRY_VERIFY(tableView->itemAtCell(29, 9));
+}
+
+void tst_QQuickTableView::scrollByCell()
+{
+    // Scrolling loads and unloads cells at the edges of the table, so that
+    // only the cells in the viewport and the cache buffer are loaded
+    TableModel model(100, 20);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+
+    const qreal buffer = tableView->cacheBuffer();
+    const int maxRows = qCeil((tableView->height() + 2 * buffer) / 20) + 2;
+    const int maxColumns = qCeil((tableView->width() + 2 * buffer) / 50) + 2;
+
+    const auto verifyLoadedCells = [&]() {
+        QRect loaded;
+        int count = 0;
+        for (int row = 0; row < 100; ++row) {
+            for (int column = 0; column < 20; ++column) {
+                if (tableView->itemAtCell(row, column)) {
+                    loaded |= QRect(column, row, 1, 1);
+                    ++count;
+                }
+            }
+        }
+        // The loaded cells form one block around the viewport
+        QCOMPARE(count, loaded.width() * loaded.height());
+        QVERIFY(loaded.height() <= maxRows);
+        QVERIFY(loaded.width() <= maxColumns);
+        QVERIFY(loaded.top() * 20 <= tableView->contentY());
+        QVERIFY((loaded.bottom() + 1) * 20 >= qMin(tableView->contentY() + tableView->height(), qreal(2000)));
+        QVERIFY(loaded.left() * 50 <= tableView->contentX());
+        QVERIFY((loaded.right() + 1) * 50 >= qMin(tableView->contentX() + tableView->width(), qreal(1000)));
+
+        // Released items are pooled rather than piling up
+        QVERIFY(tableView->contentItem()->childItems().count() <= 2 * maxRows * maxColumns);
+    };
+
+    // Down one row at a time, then right one column at a time, and back
+    for (int row = 1; row <= 90; ++row) {
+        tableView->setContentY(row * 20);
+        QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+        verifyLoadedCells();
+        if (QTest::currentTestFailed())
+            return;
+    }
+    for (int column = 1; column <= 15; ++column) {
+        tableView->setContentX(column * 50);
+        QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+        verifyLoadedCells();
+        if (QTest::currentTestFailed())
+            return;
+    }
+    for (int row = 89; row >= 0; --row) {
+        tableView->setContentY(row * 20);
+        QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+        verifyLoadedCells();
+        if (QTest::currentTestFailed())
+            return;
+    }
+}
+
+void tst_QQuickTableView::largeModel()
+{
+    // Only the rows whose cells can all be addressed by an int are shown
+    TableModel model(INT_MAX - 10, 10);
+    const int rows = (INT_MAX - 10) / 10;
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+    QCOMPARE(tableView->rows(), rows);
+    QCOMPARE(tableView->count(), rows * 10);
+
+    tableView->setContentY(tableView->contentHeight() - tableView->height());
+    QTRY_VERIFY(tableView->itemAtCell(rows - 1, 0));
+    QCOMPARE(tableView->itemAtCell(rows - 1, 0)->property("text").toString(),
+             QString::number(rows - 1) + QLatin1String(",0"));
+
+    // Inserting rows pushes the last ones out of the table, and removing
+    // rows brings them back.
+    model.insertRows(0, 2);
+    QCOMPARE(tableView->rows(), rows);
+    QCOMPARE(tableView->count(), rows * 10);
+    QTRY_COMPARE(tableView->itemAtCell(rows - 1, 0)->property("text").toString(),
+                 QString::number(rows - 1) + QLatin1String(",0"));
+
+    model.removeRows(0, 5);
+    QCOMPARE(tableView->rows(), rows);
+    QCOMPARE(tableView->count(), rows * 10);
+
+    // Changes to rows past the table are left out
+    model.insertRows(rows + 5, 1);
+    model.removeRows(rows + 5, 1);
+    QCOMPARE(tableView->count(), rows * 10);
+}
+
+void tst_QQuickTableView::modelRows()
+{
+    // Rows inserted into or removed from the model only move the loaded
+    // items below them, and load or release the items of those rows.
+    TableModel model(100, 5);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+
+    QPointer<QQuickItem> above = tableView->itemAtCell(2, 1);
+    QPointer<QQuickItem> below = tableView->itemAtCell(3, 1);
+    QVERIFY(above && below);
+
+    model.insertRows(3, 2);
+    QCOMPARE(tableView->count(), 102 * 5);
+    QTRY_COMPARE(tableView->itemAtCell(5, 1), below.data());
+    QCOMPARE(below->y(), qreal(100));
+    QCOMPARE(tableView->itemAtCell(2, 1), above.data());
+    QVERIFY(tableView->itemAtCell(3, 1) && tableView->itemAtCell(3, 1) != below);
+    QCOMPARE(tableView->itemAtCell(4, 1)->property("text").toString(), QLatin1String("4,1"));
+    QCOMPARE(tableView->itemAtCell(4, 1)->y(), qreal(80));
+
+    model.removeRows(1, 3);
+    QCOMPARE(tableView->count(), 99 * 5);
+    QTRY_COMPARE(tableView->itemAtCell(2, 1), below.data());
+    QCOMPARE(below->y(), qreal(40));
+    QVERIFY(tableView->itemAtCell(1, 1) != above);
+
+    // Rows inserted or removed above the loaded rows keep the loaded rows
+    // where they are on screen
+    tableView->setContentY(1000);
+    QTRY_VERIFY(tableView->itemAtCell(52, 0));
+    QPointer<QQuickItem> item = tableView->itemAtCell(52, 0);
+    const qreal screenY = item->y() - tableView->contentY();
+
+    model.insertRows(0, 3);
+    QTRY_COMPARE(tableView->itemAtCell(55, 0), item.data());
+    QCOMPARE(tableView->contentY(), qreal(1060));
+    QCOMPARE(item->y() - tableView->contentY(), screenY);
+
+    model.removeRows(10, 5);
+    QTRY_COMPARE(tableView->itemAtCell(50, 0), item.data());
+    QCOMPARE(tableView->contentY(), qreal(960));
+    QCOMPARE(item->y() - tableView->contentY(), screenY);
+
+    // Changed data is shown by the loaded items
+    model.setText(50, 0, QLatin1String("changed"));
+    QTRY_COMPARE(item->property("text").toString(), QLatin1String("changed"));
+    QCOMPARE(tableView->itemAtCell(50, 0), item.data());
+
+    // Rows removed across the top of the loaded rows only move the loaded
+    // rows below them, the rows above are taken out of the content above
+    QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+    int top = 0;
+    while (!tableView->itemAtCell(top, 0))
+        ++top;
+    QVERIFY(top > 2 && top + 2 < 50);
+    QPointer<QQuickItem> topItem = tableView->itemAtCell(top + 2, 0);
+    QVERIFY(topItem);
+    const qreal topScreenY = topItem->y() - tableView->contentY();
+
+    model.removeRows(top - 2, 4);
+    QCOMPARE(tableView->count(), 93 * 5);
+    QTRY_COMPARE(tableView->itemAtCell(46, 0), item.data());
+    QCOMPARE(tableView->contentY(), qreal(960 - 2 * 20));
+    QCOMPARE(item->y() - tableView->contentY(), screenY - 2 * 20);
+    QCOMPARE(tableView->itemAtCell(top - 2, 0), topItem.data());
+    QCOMPARE(topItem->y() - tableView->contentY(), topScreenY - 2 * 20);
+}
+
+void tst_QQuickTableView::modelColumns()
+{
+    TableModel model(100, 5);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+    QCOMPARE(tableView->columns(), 5);
+
+    // Moving a column keeps the cells, and only changes what they show
+    QPointer<QQuickItem> item = tableView->itemAtCell(1, 0);
+    QVERIFY(item);
+    model.moveColumn(4, 0);
+    QTRY_COMPARE(item->property("text").toString(), QLatin1String("1,4"));
+    QCOMPARE(tableView->itemAtCell(1, 0), item.data());
+    QCOMPARE(tableView->itemAtCell(1, 1)->property("text").toString(), QLatin1String("1,0"));
+
+    // Inserting a column lays out the table again
+    model.insertColumn(2, 5);
+    QCOMPARE(tableView->columns(), 6);
+    QCOMPARE(tableView->count(), 600);
+    QTRY_VERIFY(tableView->itemAtCell(1, 2));
+    QCOMPARE(tableView->itemAtCell(1, 2)->property("text").toString(), QLatin1String("1,5"));
+    QCOMPARE(tableView->itemAtCell(1, 3)->property("text").toString(), QLatin1String("1,1"));
+}
+
+void tst_QQuickTableView::fetchRowsAhead()
+{
+    // Rows are fetched before the view reaches the last row of the model,
+    // and only when the loaded rows move
+    FetchMoreModel model(100, 10, 1000, 50);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+    QCOMPARE(model.rowCount(), 100);
+
+    tableView->setContentY(1000);
+    QTRY_COMPARE(model.rowCount(), 150);
+    QVERIFY(!tableView->itemAtCell(99, 0));
+    QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+
+    // Scrolling sideways refills the view without moving the loaded rows
+    const int canFetchMoreCalls = model.canFetchMoreCalls;
+    const int fetchMoreCalls = model.fetchMoreCalls;
+    for (int x = 10; x <= 50; x += 10) {
+        tableView->setContentX(x);
+        QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+    }
+    QCOMPARE(model.canFetchMoreCalls, canFetchMoreCalls);
+    QCOMPARE(model.fetchMoreCalls, fetchMoreCalls);
+    QCOMPARE(model.rowCount(), 150);
+
+    tableView->setContentY(2000);
+    QTRY_COMPARE(model.rowCount(), 200);
+    QVERIFY(!tableView->itemAtCell(149, 0));
+}
+
+void tst_QQuickTableView::providers()
+{
+    QScopedPointer<QQuickView> window(createView());
+    QQuickTableView *tableView = loadTableView(window.data(), "providers.qml");
+    QVERIFY(tableView);
+
+    QCOMPARE(tableView->rowHeight(0), qreal(20));
+    QCOMPARE(tableView->rowHeight(1), qreal(40));
+    QCOMPARE(tableView->columnWidth(0), qreal(50));
+    QCOMPARE(tableView->columnWidth(1), qreal(80));
+    QCOMPARE(tableView->itemAtCell(2, 0)->y(), qreal(60));
+    QCOMPARE(tableView->itemAtCell(3, 2)->position(), QPointF(130, 80));
+
+    // An explicit size takes precedence over the provider until it is reset
+    tableView->setRowHeight(1, 30);
+    QTRY_COMPARE(tableView->itemAtCell(2, 0)->y(), qreal(50));
+    tableView->resetRowHeight(1);
+    QTRY_COMPARE(tableView->itemAtCell(2, 0)->y(), qreal(60));
+
+    // A new provider is asked again about the loaded rows
+    tableView->setRowHeightProvider(QJSValue());
+    QTRY_COMPARE(tableView->itemAtCell(2, 0)->y(), qreal(40));
+    QCOMPARE(tableView->rowHeight(1), qreal(20));
+}
+
+void tst_QQuickTableView::estimatedSizes()
+{
+    // Rows and columns that have not been measured are as large as the
+    // average of the ones that have
+    QScopedPointer<QQuickView> window(createView());
+    QQuickTableView *tableView = loadTableView(window.data(), "estimatedSizes.qml");
+    QVERIFY(tableView);
+    QCOMPARE(tableView->rows(), 1000);
+    QCOMPARE(tableView->columns(), 40);
+
+    qreal sum = 0;
+    int count = 0;
+    for (; tableView->itemAtCell(count, 0); ++count)
+        sum += tableView->rowHeight(count);
+    QVERIFY(count > 1 && count < 1000);
+    const qreal averageHeight = sum / count;
+    QVERIFY(!tableView->itemAtCell(999, 0));
+    QVERIFY(qAbs(tableView->rowHeight(999) - averageHeight) <= 0.1 * averageHeight);
+
+    sum = 0;
+    count = 0;
+    for (; tableView->itemAtCell(0, count); ++count)
+        sum += tableView->columnWidth(count);
+    QVERIFY(count > 1 && count < 40);
+    const qreal averageWidth = sum / count;
+    QVERIFY(!tableView->itemAtCell(0, 39));
+    QVERIFY(qAbs(tableView->columnWidth(39) - averageWidth) <= 0.1 * averageWidth);
+
+    // Half the rows are 20 and half are 40 high, so the estimated content
+    // height is close to the actual one, rather than to 1000 default rows
+    const qreal height = 500 * 20 + 500 * 40;
+    QVERIFY(qAbs(tableView->contentHeight() - height) <= 0.1 * height);
+
+    // Scrolling to the end measures the last rows. Since their position is
+    // estimated, it can take a few refills to get there.
+    for (int i = 0; i < 10 && !tableView->itemAtCell(999, 0); ++i) {
+        tableView->setContentY(tableView->contentHeight() - tableView->height());
+        QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+    }
+    QQuickItem *last = tableView->itemAtCell(999, 0);
+    QVERIFY(last);
+    QCOMPARE(tableView->rowHeight(999), qreal(40));
+
+    // Once there, the content ends with the last row, and stays that way
+    const qreal contentHeight = tableView->contentHeight();
+    QCOMPARE(last->y() + tableView->rowHeight(999), contentHeight);
+    QVERIFY(qAbs(contentHeight - height) <= 0.1 * height);
+    for (int x = 10; x <= 50; x += 10) {
+        tableView->setContentX(x);
+        QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+    }
+    QCOMPARE(tableView->contentHeight(), contentHeight);
+    QCOMPARE(tableView->itemAtCell(999, 0), last);
+    QCOMPARE(last->y() + tableView->rowHeight(999), contentHeight);
+}
+
+void tst_QQuickTableView::frozen()
+{
+    TableModel model(100, 20);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+
+    tableView->setFrozenRows(1);
+    tableView->setFrozenColumns(1);
+    tableView->setContentX(500);
+    tableView->setContentY(1000);
+    QTRY_VERIFY(tableView->itemAtCell(55, 12));
+    const auto viewPos = [&](int row, int column) {
+        return tableView->itemAtCell(row, column)->mapToItem(tableView, QPointF());
+    };
+
+    // The frozen cells stay at the top and left of the view, above the
+    // cells scrolled underneath them
+    QCOMPARE(viewPos(0, 0), QPointF(0, 0));
+    QCOMPARE(viewPos(0, 12), QPointF(100, 0));
+    QCOMPARE(viewPos(55, 0), QPointF(0, 100));
+    QCOMPARE(viewPos(55, 12), QPointF(100, 100));
+    QCOMPARE(tableView->itemAt(510, 1010), tableView->itemAtCell(0, 0));
+    QCOMPARE(tableView->itemAt(610, 1010), tableView->itemAtCell(0, 12));
+    QCOMPARE(tableView->itemAt(510, 1110), tableView->itemAtCell(55, 0));
+
+    // Flicking keeps the frozen items, and only moves them along
+    QPointer<QQuickItem> frozenItem = tableView->itemAtCell(0, 12);
+    tableView->setContentY(1400);
+    QTRY_VERIFY(tableView->itemAtCell(75, 12));
+    QCOMPARE(tableView->itemAtCell(0, 12), frozenItem.data());
+    QCOMPARE(viewPos(0, 12), QPointF(100, 0));
+    QCOMPARE(viewPos(75, 0), QPointF(0, 100));
+
+    // Rows that are no longer frozen scroll away with the rest
+    tableView->setFrozenRows(0);
+    QTRY_VERIFY(!tableView->itemAtCell(0, 12) && tableView->itemAtCell(75, 0));
+    QCOMPARE(viewPos(75, 0), QPointF(0, 100));
+}
+
+void tst_QQuickTableView::positionViewAtCell_data()
+{
+    QTest::addColumn<int>("row");
+    QTest::addColumn<int>("column");
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<int>("frozenRows");
+    QTest::addColumn<qreal>("margins");
+    QTest::addColumn<QPointF>("contentPos");
+
+    // The table is 1000 x 2000, and the view 240 x 200
+    QTest::newRow("beginning") << 50 << 10 << int(QQuickTableView::Beginning) << 0 << qreal(0) << QPointF(500, 1000);
+    QTest::newRow("center") << 50 << 10 << int(QQuickTableView::Center) << 0 << qreal(0) << QPointF(405, 910);
+    QTest::newRow("end") << 50 << 10 << int(QQuickTableView::End) << 0 << qreal(0) << QPointF(310, 820);
+    QTest::newRow("visible") << 50 << 10 << int(QQuickTableView::Visible) << 0 << qreal(0) << QPointF(310, 820);
+    QTest::newRow("visible, in view") << 2 << 1 << int(QQuickTableView::Visible) << 0 << qreal(0) << QPointF(0, 0);
+    QTest::newRow("contain") << 50 << 10 << int(QQuickTableView::Contain) << 0 << qreal(0) << QPointF(310, 820);
+    QTest::newRow("contain, in view") << 2 << 1 << int(QQuickTableView::Contain) << 0 << qreal(0) << QPointF(0, 0);
+    QTest::newRow("last cell") << 99 << 19 << int(QQuickTableView::Beginning) << 0 << qreal(0) << QPointF(760, 1800);
+    QTest::newRow("below frozen rows") << 50 << 10 << int(QQuickTableView::Beginning) << 2 << qreal(0) << QPointF(500, 960);
+    QTest::newRow("frozen row") << 1 << 10 << int(QQuickTableView::Beginning) << 2 << qreal(0) << QPointF(500, 0);
+
+    // Margins let the view go past the first and last cells, but don't
+    // change where the other cells are positioned
+    QTest::newRow("beginning, margins") << 50 << 10 << int(QQuickTableView::Beginning) << 0 << qreal(10) << QPointF(500, 1000);
+    QTest::newRow("last cell, margins") << 99 << 19 << int(QQuickTableView::Beginning) << 0 << qreal(10) << QPointF(770, 1810);
+    QTest::newRow("first cell, margins") << 0 << 0 << int(QQuickTableView::End) << 0 << qreal(10) << QPointF(-10, -10);
+}
+
+void tst_QQuickTableView::positionViewAtCell()
+{
+    QFETCH(int, row);
+    QFETCH(int, column);
+    QFETCH(int, mode);
+    QFETCH(int, frozenRows);
+    QFETCH(qreal, margins);
+    QFETCH(QPointF, contentPos);
+
+    TableModel model(100, 20);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+    tableView->setFrozenRows(frozenRows);
+    tableView->setLeftMargin(margins);
+    tableView->setTopMargin(margins);
+    tableView->setRightMargin(margins);
+    tableView->setBottomMargin(margins);
+    QTRY_VERIFY(!QQuickItemPrivate::get(tableView)->polishScheduled);
+
+    tableView->positionViewAtCell(row, column, mode);
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), contentPos);
+    QTRY_VERIFY(tableView->itemAtCell(row, column));
+
+    // The rows left far behind are unloaded
+    if (contentPos.y() > 800)
+        QTRY_VERIFY(!tableView->itemAtCell(frozenRows + 5, column));
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), contentPos);
+}
+
+void tst_QQuickTableView::positionViewAtIndex()
+{
+    TableModel model(100, 20);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+
+    // Indexes count the cells row by row
+    tableView->positionViewAtIndex(5 * 20 + 3, QQuickTableView::Beginning);
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), QPointF(150, 100));
+    QTRY_VERIFY(tableView->itemAtCell(5, 3));
+
+    tableView->positionViewAtEnd();
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), QPointF(760, 1800));
+    QTRY_VERIFY(tableView->itemAtCell(99, 19));
+
+    tableView->positionViewAtBeginning();
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), QPointF(0, 0));
+    QTRY_VERIFY(tableView->itemAtCell(0, 0));
+
+    // Invalid cells and modes leave the view where it is
+    tableView->positionViewAtCell(100, 0, QQuickTableView::Beginning);
+    tableView->positionViewAtCell(5, -1, QQuickTableView::Beginning);
+    tableView->positionViewAtCell(50, 5, QQuickTableView::SnapPosition + 1);
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), QPointF(0, 0));
+
+    // The beginning and the end include the margins
+    tableView->setLeftMargin(10);
+    tableView->setTopMargin(20);
+    tableView->setRightMargin(30);
+    tableView->setBottomMargin(40);
+    tableView->positionViewAtEnd();
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), QPointF(790, 1840));
+    QTRY_VERIFY(tableView->itemAtCell(99, 19));
+
+    tableView->positionViewAtBeginning();
+    QCOMPARE(QPointF(tableView->contentX(), tableView->contentY()), QPointF(-10, -20));
+    QTRY_VERIFY(tableView->itemAtCell(0, 0));
+}
+
+void tst_QQuickTableView::sizeCallbacks()
+{
+    QScopedPointer<QQuickView> window(createView());
+    QQuickTableView *tableView = loadTableView(window.data(), "providers.qml");
+    QVERIFY(tableView);
+
+    // The C++ callbacks take precedence over the providers, and are asked
+    // about each row once, until it is invalidated
+    qreal height = 25;
+    QHash<int, int> calls;
+    tableView->setRowHeightCallback([&](int row) {
+        ++calls[row];
+        return height;
+    });
+    QTRY_COMPARE(tableView->itemAtCell(2, 0)->y(), qreal(50));
+    QCOMPARE(calls.value(2), 1);
+
+    tableView->setColumnWidth(0, 60);
+    QTRY_COMPARE(tableView->itemAtCell(0, 1)->x(), qreal(60));
+    QCOMPARE(calls.value(2), 1);
+
+    height = 30;
+    tableView->invalidateRow(0);
+    QTRY_COMPARE(tableView->itemAtCell(2, 0)->y(), qreal(55));
+    QCOMPARE(tableView->rowHeight(0), qreal(30));
+    QCOMPARE(tableView->rowHeight(1), qreal(25));
+    QCOMPARE(calls.value(0), 2);
+    QCOMPARE(calls.value(2), 1);
+
+    tableView->setColumnWidthCallback([](int column) { return column < 2 ? qreal(-1) : qreal(70); });
+    QTRY_COMPARE(tableView->itemAtCell(0, 3)->x(), qreal(60 + 50 + 70));
+    QCOMPARE(tableView->columnWidth(1), qreal(50));
+}
+
+void tst_QQuickTableView::spans()
+{
+    TableModel model(100, 5);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+
+    // Spans set one after the other are applied together
+    tableView->setSpan(0, 0, 2, 2);
+    tableView->setSpan(4, 1, 1, 3);
+    QTRY_VERIFY(tableView->itemAtCell(0, 0) && tableView->itemAtCell(0, 0) == tableView->itemAtCell(1, 1));
+    QVERIFY(tableView->itemAtCell(4, 1) && tableView->itemAtCell(4, 1) == tableView->itemAtCell(4, 3));
+    QVERIFY(tableView->itemAtCell(4, 0) != tableView->itemAtCell(4, 1));
+
+    // The spans move and grow along with the rows of the model
+    model.insertRows(1, 1);
+    QTRY_VERIFY(tableView->itemAtCell(0, 0) && tableView->itemAtCell(0, 0) == tableView->itemAtCell(2, 1));
+    QVERIFY(tableView->itemAtCell(5, 1) && tableView->itemAtCell(5, 1) == tableView->itemAtCell(5, 3));
+    QVERIFY(tableView->itemAtCell(4, 1) != tableView->itemAtCell(5, 1));
+
+    // Rows inserted below the loaded ones leave the loaded items alone
+    QPointer<QQuickItem> spanItem = tableView->itemAtCell(0, 0);
+    model.insertRows(90, 1);
+    QTRY_COMPARE(tableView->count(), 102 * 5);
+    QCOMPARE(tableView->itemAtCell(0, 0), spanItem.data());
+
+    model.removeRows(0, 1);
+    QTRY_VERIFY(tableView->itemAtCell(0, 0) && tableView->itemAtCell(0, 0) == tableView->itemAtCell(1, 1));
+    QVERIFY(tableView->itemAtCell(2, 0) != tableView->itemAtCell(1, 0));
+    QVERIFY(tableView->itemAtCell(4, 1) && tableView->itemAtCell(4, 1) == tableView->itemAtCell(4, 3));
+}
+
+void tst_QQuickTableView::resizeColumnToContents()
+{
+    QScopedPointer<QQuickView> window(createView());
+    QQuickTableView *tableView = loadTableView(window.data(), "autoFit.qml");
+    QVERIFY(tableView);
+    QCOMPARE(tableView->columnWidth(1), qreal(50));
+
+    // Rows that are not loaded are measured by creating their delegates
+    tableView->resizeColumnToContents(1);
+    QTRY_COMPARE(tableView->columnWidth(1), qreal(120));
+    QCOMPARE(tableView->columnWidth(0), qreal(50));
+
+    // With fewer sampled rows, the widest one is missed
+    tableView->setAutoFitSampleSize(10);
+    tableView->resizeColumnToContents(1);
+    QTRY_COMPARE(tableView->columnWidth(1), qreal(24));
+
+    tableView->setAutoFitSampleSize(100);
+    tableView->resizeColumnsToContents();
+    QTRY_COMPARE(tableView->columnWidth(1), qreal(120));
+    QCOMPARE(tableView->columnWidth(0), qreal(24));
+    QCOMPARE(tableView->columnWidth(2), qreal(24));
+}
+
+void tst_QQuickTableView::resizeColumnToText()
+{
+    // With autoFitTextRole, the text of the rows is measured rather than
+    // their delegates, and the delegates of the loaded rows add their padding
+    TableModel model(100, 3);
+    QScopedPointer<QQuickView> window(createView());
+    window->rootContext()->setContextProperty("tableModel", &model);
+    QQuickTableView *tableView = loadTableView(window.data(), "tableModel.qml");
+    QVERIFY(tableView);
+
+    const QFontMetricsF metrics(tableView->autoFitFont());
+    qreal textWidth = 0;
+    for (int row = 0; row < 100; ++row)
+        textWidth = qMax(textWidth, metrics.width(QString::number(row) + QLatin1String(",2")));
+
+    tableView->setAutoFitTextRole("display");
+    tableView->resizeColumnToContents(2);
+    QTRY_VERIFY(qAbs(tableView->columnWidth(2) - textWidth) < 1.5);
+    QCOMPARE(tableView->columnWidth(1), qreal(50));
+}
+
+QTEST_MAIN(tst_QQuickTableView)
+
+#include "tst_qquicktableview.moc"
@@ -36,14 +36,17 @@
 #include <QtQml/qqmlcontext.h>
 #include <QtQml/qqmlexpression.h>
 #include <QtQml/qqmlincubator.h>
+#include <QtQml/qqmllist.h>
 #include <QtQuick/qquickview.h>
 #include <private/qquicklistview_p.h>
 #include <QtQuick/private/qquicktext_p.h>
 #include <QtQml/private/qqmldelegatemodel_p.h>
+#include <QtQml/private/qqmldelegatemodel_p_p.h>
 #include <private/qqmlvaluetype_p.h>
 #include <private/qqmlchangeset_p.h>
 #include <private/qqmlengine_p.h>
 #include <math.h>
+#include <algorithm>
 #include <QtGui/qstandarditemmodel.h>
 
 using namespace QQuickVisualTestUtil;
@@ -376,6 +379,69 @@ QML_DECLARE_TYPE(DataObject)
 QML_DECLARE_TYPE(StandardItem)
 QML_DECLARE_TYPE(StandardItemModel)
 
+// Counts the reads of each role, to tell which values delegates get from a cache
+class RoleCountModel : public QAbstractListModel
+{
+public:
+    enum Roles { Name = Qt::UserRole, Number, Other };
+
+    RoleCountModel(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            m_names.append(QLatin1String("item") + QString::number(i));
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_names.count();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        ++reads[role];
+        switch (role) {
+        case Name: return m_names.at(index.row());
+        case Number: return index.row();
+        case Other: return QString();
+        default: return QVariant();
+        }
+    }
+
+    QHash<int, QByteArray> roleNames() const override
+    {
+        QHash<int, QByteArray> roles;
+        roles.insert(Name, "name");
+        roles.insert(Number, "number");
+        roles.insert(Other, "other");
+        return roles;
+    }
+
+    void setName(int row, const QString &name)
+    {
+        m_names[row] = name;
+        emit dataChanged(index(row), index(row), QVector<int>() << Name);
+    }
+
+    void insert(int row, const QString &name)
+    {
+        beginInsertRows(QModelIndex(), row, row);
+        m_names.insert(row, name);
+        endInsertRows();
+    }
+
+    void move(int from, int to)
+    {
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+        m_names.move(from, to);
+        endMoveRows();
+    }
+
+    mutable QHash<int, int> reads;
+
+private:
+    QStringList m_names;
+};
+
 class tst_qquickvisualdatamodel : public QQmlDataTest
 {
     Q_OBJECT
@@ -433,6 +499,11 @@ private slots:
     void invalidContext();
     void dimensions_data();
     void dimensions();
+    void resolvedDelegates();
+    void columnDelegates();
+    void roleValueCache();
+    void sortFilter();
+    void sortFilterMoves();
 
 private:
     template <int N> void groups_verify(
@@ -457,6 +528,13 @@ private:
             const bool (&vMember)[N],
             const bool (&sMember)[N]);
 
+    struct SortFilterState {
+        QStringList shadow;
+        QList<QPointer<QObject> > items;
+    };
+    static void sortFilter_track(QQmlDelegateModel *delegateModel, SortFilterState *state);
+    void sortFilter_verify(QQmlDelegateModel *delegateModel, const QStringList &expected, SortFilterState *state);
+
     bool failed;
     QQmlIncubationController controller;
     QQmlEngine engine;
@@ -4321,6 +4399,417 @@ void tst_qquickvisualdatamodel::dimensions()
     QCOMPARE(delegateModel->columns(), 1);
 }
 
+void tst_qquickvisualdatamodel::resolvedDelegates()
+{
+    QQmlEngine engine;
+    QaimModel model;
+    for (int i = 0; i < 2000; ++i)
+        model.addItem("small", QString::number(i));
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent component(&engine);
+    component.setData("import QtQml.Models 2.10; import QtQuick 2.0\n"
+                      "DelegateModel {\n"
+                      "    model: myModel\n"
+                      "    delegates: Delegate { when: name === 'big'; cacheable: true; Item { objectName: 'big' } }\n"
+                      "    delegate: Item { objectName: 'small' }\n"
+                      "}", testFileUrl(""));
+    QScopedPointer<QQmlDelegateModel> delegateModel(qobject_cast<QQmlDelegateModel *>(component.create()));
+    QVERIFY(delegateModel.data());
+    QQmlDelegateModelPrivate *d = QQmlDelegateModelPrivate::get(delegateModel.data());
+
+    const auto objectName = [&](int index) {
+        QObject *object = delegateModel->object(index, false);
+        const QString name = object ? object->objectName() : QString();
+        delegateModel->release(object);
+        return name;
+    };
+
+    QCOMPARE(objectName(0), QLatin1String("small"));
+    QCOMPARE(objectName(1), QLatin1String("small"));
+    QVERIFY(d->m_resolvedDelegates.contains(0));
+    QVERIFY(d->m_resolvedDelegates.contains(1));
+
+    // Only the choice for the changed item is forgotten
+    model.modifyItem(0, "big", "0");
+    QVERIFY(!d->m_resolvedDelegates.contains(0));
+    QVERIFY(d->m_resolvedDelegates.contains(1));
+    QCOMPARE(objectName(0), QLatin1String("big"));
+
+    // Going through all the items doesn't remember the choice for each of them
+    for (int i = 1; i < model.count(); ++i)
+        QCOMPARE(objectName(i), QLatin1String("small"));
+    QVERIFY(d->m_resolvedDelegates.count() <= 1024);
+}
+
+void tst_qquickvisualdatamodel::columnDelegates()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQml.Models 2.10; import QtQuick 2.0\n"
+                      "DelegateModel {\n"
+                      "    model: 12\n"
+                      "    columns: 3\n"
+                      "    delegates: [\n"
+                      "        Delegate { column: 0; Item { objectName: 'first' } },\n"
+                      "        Delegate { row: 2; column: 1; Item { objectName: 'cell' } },\n"
+                      "        Delegate { column: 2; Item { objectName: 'last' } },\n"
+                      "        Delegate { Item { objectName: 'any' } }\n"
+                      "    ]\n"
+                      "    delegate: Item { objectName: 'default' }\n"
+                      "}", testFileUrl(""));
+    QScopedPointer<QQmlDelegateModel> delegateModel(qobject_cast<QQmlDelegateModel *>(component.create()));
+    QVERIFY(delegateModel.data());
+    QQmlDelegateModelPrivate *d = QQmlDelegateModelPrivate::get(delegateModel.data());
+    QQmlListReference delegates(delegateModel.data(), "delegates");
+    QCOMPARE(delegates.count(), 4);
+
+    const auto objectName = [&](int index) {
+        QObject *object = delegateModel->object(index, false);
+        const QString name = object ? object->objectName() : QString();
+        delegateModel->release(object);
+        return name;
+    };
+    const auto firstDelegate = [&](int column) {
+        return static_cast<QObject *>(d->delegatesForColumn(column).first());
+    };
+
+    // The delegate without a column is a catch-all, and is used for the cells
+    // no other delegate matches, instead of the default delegate
+    QCOMPARE(objectName(0), QLatin1String("first"));
+    QCOMPARE(objectName(1), QLatin1String("any"));
+    QCOMPARE(objectName(2), QLatin1String("last"));
+    QCOMPARE(objectName(4), QLatin1String("any"));
+    QCOMPARE(objectName(7), QLatin1String("cell"));
+    QCOMPARE(objectName(10), QLatin1String("any"));
+
+    // Each column only looks at its own delegates, and the catch-all
+    QCOMPARE(d->delegatesForColumn(0).count(), 2);
+    QCOMPARE(d->delegatesForColumn(1).count(), 3);
+    QCOMPARE(d->delegatesForColumn(2).count(), 2);
+    QCOMPARE(d->delegatesForColumn(5).count(), 1);
+    QCOMPARE(firstDelegate(1), delegates.at(1));
+    QCOMPARE(firstDelegate(5), delegates.at(3));
+
+    // Pooled items are only reused for cells of the same delegate
+    QObject *first = delegateModel->object(0, false);
+    QObject *any = delegateModel->object(1, false);
+    QVERIFY(first && any);
+    QVERIFY(delegateModel->release(first, QQmlInstanceModel::Reusable) & QQmlInstanceModel::Pooled);
+    QVERIFY(delegateModel->release(any, QQmlInstanceModel::Reusable) & QQmlInstanceModel::Pooled);
+    QCOMPARE(d->m_reusableItemsPools.count(), 2);
+
+    QObject *reused = delegateModel->object(4, false);
+    QCOMPARE(reused, any);
+    QCOMPARE(d->m_reusableItemsPools.count(), 1);
+    delegateModel->release(reused);
+
+    reused = delegateModel->object(3, false);
+    QCOMPARE(reused, first);
+    QVERIFY(d->m_reusableItemsPools.isEmpty());
+    delegateModel->release(reused);
+
+    // Changing the column of a delegate rebuilds the delegates of each column
+    // for the items created from then on
+    delegates.at(0)->setProperty("column", 1);
+    QCOMPARE(d->delegatesForColumn(0).count(), 1);
+    QCOMPARE(d->delegatesForColumn(1).count(), 3);
+    QCOMPARE(firstDelegate(1), delegates.at(0));
+    QCOMPARE(objectName(0), QLatin1String("any"));
+    QCOMPARE(objectName(1), QLatin1String("first"));
+    QCOMPARE(objectName(7), QLatin1String("first"));
+    QCOMPARE(objectName(2), QLatin1String("last"));
+}
+
+void tst_qquickvisualdatamodel::roleValueCache()
+{
+    QQmlEngine engine;
+    RoleCountModel model(10);
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent component(&engine);
+    component.setData("import QtQml.Models 2.2; import QtQuick 2.0\n"
+                      "DelegateModel {\n"
+                      "    model: myModel\n"
+                      "    delegate: Item { property string n: name; property int m: number }\n"
+                      "}", testFileUrl(""));
+    QScopedPointer<QQmlDelegateModel> delegateModel(qobject_cast<QQmlDelegateModel *>(component.create()));
+    QVERIFY(delegateModel.data());
+
+    QObject *item = delegateModel->object(2, false);
+    QVERIFY(item);
+    QCOMPARE(item->property("n").toString(), QLatin1String("item2"));
+    QCOMPARE(item->property("m").toInt(), 2);
+
+    // A role read again is not read from the model again
+    model.reads.clear();
+    QCOMPARE(evaluate<QString>(item, "name"), QLatin1String("item2"));
+    QCOMPARE(evaluate<QString>(item, "name"), QLatin1String("item2"));
+    QCOMPARE(model.reads.value(RoleCountModel::Name), 0);
+
+    // Only the changed role is read again
+    model.setName(2, QLatin1String("changed"));
+    QCOMPARE(item->property("n").toString(), QLatin1String("changed"));
+    QCOMPARE(model.reads.value(RoleCountModel::Name), 1);
+    QCOMPARE(evaluate<int>(item, "number"), 2);
+    QCOMPARE(model.reads.value(RoleCountModel::Number), 0);
+
+    // Changes to roles that the delegates have no property for keep the values
+    emit model.dataChanged(model.index(2), model.index(2), QVector<int>() << Qt::ToolTipRole);
+    QCOMPARE(evaluate<QString>(item, "name"), QLatin1String("changed"));
+    QCOMPARE(model.reads.value(RoleCountModel::Name), 1);
+
+    // Changes without roles drop everything
+    emit model.dataChanged(model.index(2), model.index(2));
+    QCOMPARE(evaluate<int>(item, "number"), 2);
+    QCOMPARE(model.reads.value(RoleCountModel::Number), 1);
+
+    // The values are read again for the new row of an item whose row moves
+    model.reads.clear();
+    model.insert(0, QLatin1String("inserted"));
+    QCOMPARE(evaluate<int>(item, "number"), 3);
+    QCOMPARE(evaluate<QString>(item, "name"), QLatin1String("changed"));
+    QCOMPARE(model.reads.value(RoleCountModel::Number), 1);
+
+    model.move(3, 7);
+    QCOMPARE(evaluate<int>(item, "number"), 7);
+    QCOMPARE(evaluate<QString>(item, "name"), QLatin1String("changed"));
+    QCOMPARE(model.reads.value(RoleCountModel::Number), 2);
+
+    delegateModel->release(item);
+}
+
+// Applies the change sets of the model to a copy of what it shows, so that
+// they can be checked against what it shows after the changes.
+void tst_qquickvisualdatamodel::sortFilter_track(QQmlDelegateModel *delegateModel, SortFilterState *state)
+{
+    for (int i = 0; i < delegateModel->count(); ++i)
+        state->shadow.append(delegateModel->stringValue(i, QLatin1String("display")));
+
+    QObject::connect(delegateModel, &QQmlDelegateModel::modelUpdated, delegateModel,
+                     [delegateModel, state](const QQmlChangeSet &changes, bool) {
+        QHash<QPair<int, int>, QString> moved;
+        for (const QQmlChangeSet::Change &remove : changes.removes()) {
+            for (int i = 0; i < remove.count; ++i) {
+                const QString name = state->shadow.takeAt(remove.index);
+                if (remove.isMove())
+                    moved.insert(qMakePair(remove.moveId, remove.offset + i), name);
+            }
+        }
+        for (const QQmlChangeSet::Change &insert : changes.inserts()) {
+            for (int i = 0; i < insert.count; ++i) {
+                state->shadow.insert(insert.index + i, insert.isMove()
+                        ? moved.take(qMakePair(insert.moveId, insert.offset + i))
+                        : delegateModel->stringValue(insert.index + i, QLatin1String("display")));
+            }
+        }
+    });
+}
+
+void tst_qquickvisualdatamodel::sortFilter_verify(
+        QQmlDelegateModel *delegateModel, const QStringList &expected, SortFilterState *state)
+{
+    failed = true;
+    QCOMPARE(delegateModel->count(), expected.count());
+    QCOMPARE(state->shadow, expected);
+    for (int i = 0; i < expected.count(); ++i)
+        QCOMPARE(delegateModel->stringValue(i, QLatin1String("display")), expected.at(i));
+
+    // The items created before the changes show the rows at their new index
+    for (QObject *item : qAsConst(state->items)) {
+        const int index = item ? delegateModel->indexOf(item, nullptr) : -1;
+        if (index == -1)
+            continue;
+        QCOMPARE(evaluate<int>(item, "index"), index);
+        QCOMPARE(evaluate<QString>(item, "display"), expected.at(index));
+    }
+
+    QList<QPointer<QObject> > items;
+    for (int i = 0; i < expected.count(); ++i) {
+        QObject *item = delegateModel->object(i, false);
+        QVERIFY(item);
+        items.append(item);
+    }
+    for (QObject *item : qAsConst(state->items)) {
+        if (item)
+            delegateModel->release(item);
+    }
+    state->items = items;
+    failed = false;
+}
+
+#define VERIFY_SORT_FILTER(expected) \
+    sortFilter_verify(delegateModel.data(), expected, &state); \
+    QVERIFY(!failed)
+
+void tst_qquickvisualdatamodel::sortFilter()
+{
+    enum { Key = Qt::UserRole, Kind };
+    QStandardItemModel model;
+    QHash<int, QByteArray> roleNames;
+    roleNames.insert(Qt::DisplayRole, "display");
+    roleNames.insert(Key, "key");
+    roleNames.insert(Kind, "kind");
+    model.setItemRoleNames(roleNames);
+
+    const auto newItem = [&](const QString &name, int key, const QString &kind) {
+        QStandardItem *item = new QStandardItem(name);
+        item->setData(key, Key);
+        item->setData(kind, Kind);
+        return item;
+    };
+    for (int i = 0; i < 20; ++i)
+        model.appendRow(newItem(QLatin1String("item") + QString::number(i), i * 7 % 10, i % 3 ? QLatin1String("a") : QLatin1String("b")));
+
+    // What the model should show: the rows of the kind filtered on, sorted
+    // on their keys, with rows of the same key in the order of the model
+    Qt::SortOrder order = Qt::AscendingOrder;
+    QString kind = QLatin1String("a");
+    int rows = INT_MAX;
+    const auto expected = [&]() {
+        QVector<QStandardItem *> items;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            if (model.item(row)->data(Kind).toString() == kind)
+                items.append(model.item(row));
+        }
+        std::stable_sort(items.begin(), items.end(), [&](QStandardItem *a, QStandardItem *b) {
+            const int keyA = a->data(Key).toInt();
+            const int keyB = b->data(Key).toInt();
+            return order == Qt::AscendingOrder ? keyA < keyB : keyB < keyA;
+        });
+        QStringList names;
+        for (int i = 0; i < qMin(rows, items.count()); ++i)
+            names.append(items.at(i)->text());
+        return names;
+    };
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("myModel", &model);
+    QQmlComponent component(&engine);
+    component.setData("import QtQml.Models 2.10; import QtQuick 2.0\n"
+                      "DelegateModel {\n"
+                      "    model: myModel\n"
+                      "    sortRole: 'key'\n"
+                      "    filterRole: 'kind'\n"
+                      "    filterValue: 'a'\n"
+                      "    delegate: Item {}\n"
+                      "}", testFileUrl(""));
+    QScopedPointer<QQmlDelegateModel> delegateModel(qobject_cast<QQmlDelegateModel *>(component.create()));
+    QVERIFY(delegateModel.data());
+    SortFilterState state;
+    sortFilter_track(delegateModel.data(), &state);
+    VERIFY_SORT_FILTER(expected());
+
+    // Inserted rows end up where their keys put them
+    model.insertRow(5, newItem(QLatin1String("new1"), 3, QLatin1String("a")));
+    model.appendRow(newItem(QLatin1String("new2"), 0, QLatin1String("b")));
+    model.insertRow(0, newItem(QLatin1String("new3"), 9, QLatin1String("a")));
+    model.insertRows(2, 2);
+    model.setItem(2, newItem(QLatin1String("new4"), 0, QLatin1String("a")));
+    model.setItem(3, newItem(QLatin1String("new5"), 5, QLatin1String("a")));
+    VERIFY_SORT_FILTER(expected());
+
+    model.removeRows(3, 4);
+    model.removeRow(model.rowCount() - 1);
+    VERIFY_SORT_FILTER(expected());
+
+    // Changing a key moves the row, changing what is filtered on filters it in or out
+    model.item(4)->setData(8, Key);
+    VERIFY_SORT_FILTER(expected());
+    model.item(6)->setData(-1, Key);
+    VERIFY_SORT_FILTER(expected());
+    model.item(7)->setData(QLatin1String("b"), Kind);
+    VERIFY_SORT_FILTER(expected());
+    model.item(9)->setData(QLatin1String("a"), Kind);
+    VERIFY_SORT_FILTER(expected());
+    model.item(7)->setData(QLatin1String("a"), Kind);
+    VERIFY_SORT_FILTER(expected());
+
+    // Other changes leave the rows where they are
+    model.item(10)->setText(QLatin1String("renamed"));
+    VERIFY_SORT_FILTER(expected());
+
+    // Sorting the model only reorders rows with equal keys
+    model.sort(0, Qt::DescendingOrder);
+    VERIFY_SORT_FILTER(expected());
+
+    order = Qt::DescendingOrder;
+    delegateModel->setSortOrder(order);
+    VERIFY_SORT_FILTER(expected());
+
+    kind = QLatin1String("b");
+    delegateModel->setFilterValue(kind);
+    VERIFY_SORT_FILTER(expected());
+
+    // Rows set on the model can leave out rows, but not bring back filtered ones
+    delegateModel->setRows(100);
+    VERIFY_SORT_FILTER(expected());
+    rows = 3;
+    delegateModel->setRows(rows);
+    VERIFY_SORT_FILTER(expected());
+    model.insertRow(1, newItem(QLatin1String("new6"), 20, QLatin1String("b")));
+    VERIFY_SORT_FILTER(expected());
+    model.insertRow(1, newItem(QLatin1String("new7"), -5, QLatin1String("b")));
+    VERIFY_SORT_FILTER(expected());
+    model.removeRow(model.indexFromItem(model.findItems(QLatin1String("new6")).first()).row());
+    VERIFY_SORT_FILTER(expected());
+    model.item(0)->setData(30, Key);
+    VERIFY_SORT_FILTER(expected());
+
+    for (QObject *item : qAsConst(state.items)) {
+        if (item)
+            delegateModel->release(item);
+    }
+}
+
+void tst_qquickvisualdatamodel::sortFilterMoves()
+{
+    // Rows moved in the model only move in the view if they have equal keys
+    SingleRoleModel model(QStringList()
+            << "n" << "c" << "x" << "a" << "c" << "m" << "b" << "z" << "c" << "e" << "a" << "q",
+            "display");
+    const auto expected = [&]() {
+        QStringList names;
+        for (const QString &name : model.getList()) {
+            if (name < QLatin1String("n"))
+                names.append(name);
+        }
+        std::stable_sort(names.begin(), names.end());
+        return names;
+    };
+
+    QQmlEngine engine;
+    engine.rootContext()->setContextProperty("myModel", &model);
+    QQmlComponent component(&engine);
+    component.setData("import QtQml.Models 2.10; import QtQuick 2.0\n"
+                      "DelegateModel {\n"
+                      "    model: myModel\n"
+                      "    sortRole: 'display'\n"
+                      "    filterRole: 'display'\n"
+                      "    filterValue: /^[a-m]/\n"
+                      "    delegate: Item {}\n"
+                      "}", testFileUrl(""));
+    QScopedPointer<QQmlDelegateModel> delegateModel(qobject_cast<QQmlDelegateModel *>(component.create()));
+    QVERIFY(delegateModel.data());
+    SortFilterState state;
+    sortFilter_track(delegateModel.data(), &state);
+    VERIFY_SORT_FILTER(expected());
+
+    model.move(QModelIndex(), 8, QModelIndex(), 1, 3);
+    VERIFY_SORT_FILTER(expected());
+    model.move(QModelIndex(), 5, QModelIndex(), 0, 1);
+    VERIFY_SORT_FILTER(expected());
+
+    // A layout change of the model re-sorts the rows in the view
+    emit model.layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    VERIFY_SORT_FILTER(expected());
+
+    for (QObject *item : qAsConst(state.items)) {
+        if (item)
+            delegateModel->release(item);
+    }
+}
+
 QTEST_MAIN(tst_qquickvisualdatamodel)
 
 #include "tst_qquickvisualdatamodel.moc"
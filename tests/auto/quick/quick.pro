@@ -36,6 +36,9 @@ PRIVATETESTS += \
 #    qquickpath \
 #    qquicksmoothedanimation \
     qquickspringanimation \
+    qquicktablecellgrid \
+    qquicktablesectionsizes \
+    qquicktablespans \
 #    qquickanimationcontroller \
 #    qquickstyledtext \
 #    qquickstates \
@@ -75,6 +78,7 @@ QUICKTESTS =  \
 #    qquickpositioners \
 #    qquickrectangle \
     qquickrepeater \
+    qquicktableview \
 #    qquickshortcut \
 #    qquicktext \
 #    qquicktextdocument \
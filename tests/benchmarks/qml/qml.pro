@@ -13,4 +13,4 @@ SUBDIRS += \
            js \
            creation
 
-qtHaveModule(opengl): SUBDIRS += painting qquickwindow
+qtHaveModule(opengl): SUBDIRS += painting qquickwindow qquicktableview
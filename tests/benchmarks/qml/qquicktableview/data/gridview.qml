@@ -0,0 +1,18 @@
+import QtQuick 2.10
+import Benchmark 1.0
+
+// Lays out the cells of the table model row by row, wrapping at the view width
+GridView {
+    width: 640
+    height: 480
+    model: tableModel
+    cacheBuffer: 0
+    cellWidth: 80
+    cellHeight: 24
+
+    delegate: CountingItem {
+        width: 80
+        height: 24
+        Text { text: display }
+    }
+}
@@ -0,0 +1,15 @@
+import QtQuick 2.10
+import Benchmark 1.0
+
+TableView {
+    width: 640
+    height: 480
+    model: tableModel
+    cacheBuffer: 0
+
+    delegate: CountingItem {
+        width: 80
+        height: 24
+        Text { text: display }
+    }
+}
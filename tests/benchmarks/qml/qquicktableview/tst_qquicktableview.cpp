@@ -0,0 +1,430 @@
+/****************************************************************************
+**
+** Copyright (C) 2018 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtTest/QSignalSpy>
+#include <QAbstractTableModel>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <private/qquickflickable_p.h>
+#include <private/qquickwindow_p.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Counts the delegate items created and destroyed by the views. Items that
+// are pooled and reused are not counted again.
+class CountingItem : public QQuickItem
+{
+    Q_OBJECT
+public:
+    CountingItem(QQuickItem *parent = nullptr) : QQuickItem(parent) { ++created; }
+    ~CountingItem() { ++destroyed; }
+
+    static void reset() { created = 0; destroyed = 0; }
+    static int alive() { return created - destroyed; }
+
+    static int created;
+    static int destroyed;
+};
+
+int CountingItem::created = 0;
+int CountingItem::destroyed = 0;
+
+class TableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    TableModel(QObject *parent = nullptr) : QAbstractTableModel(parent) { }
+
+    void setSize(int rows, int columns)
+    {
+        beginResetModel();
+        m_rows = rows;
+        m_columns = columns;
+        endResetModel();
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_rows;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_columns;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (!index.isValid() || role != Qt::DisplayRole)
+            return QVariant();
+        // The data is computed, so that the model itself doesn't take any memory
+        return index.row() + index.column() + m_generation;
+    }
+
+    QHash<int, QByteArray> roleNames() const override
+    {
+        return { {Qt::DisplayRole, "display"} };
+    }
+
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override
+    {
+        beginInsertRows(parent, row, row + count - 1);
+        m_rows += count;
+        endInsertRows();
+        return true;
+    }
+
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override
+    {
+        beginRemoveRows(parent, row, row + count - 1);
+        m_rows -= count;
+        endRemoveRows();
+        return true;
+    }
+
+    void changeRows(int row, int count)
+    {
+        ++m_generation;
+        emit dataChanged(index(row, 0), index(row + count - 1, m_columns - 1), { Qt::DisplayRole });
+    }
+
+private:
+    int m_rows = 0;
+    int m_columns = 0;
+    int m_generation = 0;
+};
+
+class tst_qquicktableview : public QObject
+{
+    Q_OBJECT
+public:
+    tst_qquicktableview();
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void initialLoad_data();
+    void initialLoad();
+    void scroll_data();
+    void scroll();
+    void delegateChurn_data();
+    void delegateChurn();
+    void flickFrames_data();
+    void flickFrames();
+    void memoryPerCell_data();
+    void memoryPerCell();
+    void modelChange_data();
+    void modelChange();
+
+private:
+    void addViews();
+    void addViewsAndSizes();
+    QQuickFlickable *createView(const QString &viewName, bool reuseItems = false);
+    void scrollBy(QQuickFlickable *view, qreal dy);
+    void polish();
+
+    QQmlEngine engine;
+    QQuickWindow window;
+    TableModel model;
+};
+
+tst_qquicktableview::tst_qquicktableview()
+{
+    qmlRegisterType<CountingItem>("Benchmark", 1, 0, "CountingItem");
+    engine.rootContext()->setContextProperty(QStringLiteral("tableModel"), &model);
+}
+
+inline QUrl TEST_FILE(const QString &filename)
+{
+    return QUrl::fromLocalFile(QLatin1String(SRCDIR) + QLatin1String("/data/") + filename);
+}
+
+void tst_qquicktableview::initTestCase()
+{
+    window.resize(640, 480);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+}
+
+void tst_qquicktableview::cleanup()
+{
+    CountingItem::reset();
+}
+
+void tst_qquicktableview::addViews()
+{
+    QTest::addColumn<QString>("viewName");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("columns");
+}
+
+void tst_qquicktableview::addViewsAndSizes()
+{
+    // ListView and GridView show the same cells as TableView, flattened row by row,
+    // so that the numbers can be compared. The flat cell count saturates at INT_MAX.
+    addViews();
+    const QStringList viewNames = { "tableview", "listview", "gridview" };
+    const int rowCounts[] = { 1000, 100000, 10000000 };
+    const int columnCounts[] = { 10, 100, 500 };
+    for (const QString &viewName : viewNames) {
+        for (int rows : rowCounts) {
+            for (int columns : columnCounts) {
+                const QByteArray tag = viewName.toLatin1() + ' ' + QByteArray::number(rows)
+                        + 'x' + QByteArray::number(columns);
+                QTest::newRow(tag.constData()) << viewName << rows << columns;
+            }
+        }
+    }
+}
+
+QQuickFlickable *tst_qquicktableview::createView(const QString &viewName, bool reuseItems)
+{
+    QQmlComponent component(&engine, TEST_FILE(viewName + QLatin1String(".qml")));
+    QObject *object = component.beginCreate(engine.rootContext());
+    if (!object) {
+        qWarning() << component.errors();
+        return nullptr;
+    }
+    object->setProperty("reuseItems", reuseItems);
+    component.completeCreate();
+
+    QQuickFlickable *view = qobject_cast<QQuickFlickable *>(object);
+    view->setParentItem(window.contentItem());
+    polish();
+    return view;
+}
+
+void tst_qquicktableview::polish()
+{
+    // Lays out the views like the render loop does before each frame,
+    // without waiting for the frame to be rendered.
+    QQuickWindowPrivate::get(&window)->polishItems();
+}
+
+void tst_qquicktableview::scrollBy(QQuickFlickable *view, qreal dy)
+{
+    view->setContentY(view->contentY() + dy);
+    polish();
+}
+
+void tst_qquicktableview::initialLoad_data()
+{
+    addViewsAndSizes();
+}
+
+void tst_qquicktableview::initialLoad()
+{
+    // Creating the view and loading the first screen of delegates,
+    // including destroying it again afterwards
+    QFETCH(QString, viewName);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+    model.setSize(rows, columns);
+
+    QBENCHMARK {
+        QScopedPointer<QQuickFlickable> view(createView(viewName));
+        QVERIFY(view);
+    }
+}
+
+void tst_qquicktableview::scroll_data()
+{
+    addViewsAndSizes();
+}
+
+void tst_qquicktableview::scroll()
+{
+    // Scrolling one row at a time, laying out the view after each step
+    QFETCH(QString, viewName);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+    model.setSize(rows, columns);
+
+    QScopedPointer<QQuickFlickable> view(createView(viewName, true));
+    QVERIFY(view);
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            scrollBy(view.data(), 24);
+        for (int i = 0; i < 100; ++i)
+            scrollBy(view.data(), -24);
+    }
+}
+
+void tst_qquicktableview::delegateChurn_data()
+{
+    QTest::addColumn<QString>("viewName");
+    QTest::addColumn<bool>("reuseItems");
+
+    QTest::newRow("tableview") << "tableview" << false;
+    QTest::newRow("tableview reuse") << "tableview" << true;
+    QTest::newRow("listview") << "listview" << false;
+    QTest::newRow("listview reuse") << "listview" << true;
+    QTest::newRow("gridview") << "gridview" << false;
+    QTest::newRow("gridview reuse") << "gridview" << true;
+}
+
+void tst_qquicktableview::delegateChurn()
+{
+    // The number of delegate items created and destroyed per scrolled pixel
+    QFETCH(QString, viewName);
+    QFETCH(bool, reuseItems);
+    model.setSize(100000, 100);
+
+    QScopedPointer<QQuickFlickable> view(createView(viewName, reuseItems));
+    QVERIFY(view);
+
+    const int pixels = 4800;
+    CountingItem::reset();
+    for (int scrolled = 0; scrolled < pixels; scrolled += 4)
+        scrollBy(view.data(), 4);
+
+    qInfo("created %d, destroyed %d, alive %d", CountingItem::created,
+          CountingItem::destroyed, CountingItem::alive());
+    QTest::setBenchmarkResult(qreal(CountingItem::created + CountingItem::destroyed) / pixels, QTest::Events);
+}
+
+void tst_qquicktableview::flickFrames_data()
+{
+    addViews();
+    QTest::newRow("tableview") << "tableview" << 100000 << 100;
+    QTest::newRow("listview") << "listview" << 100000 << 100;
+    QTest::newRow("gridview") << "gridview" << 100000 << 100;
+}
+
+void tst_qquicktableview::flickFrames()
+{
+    // Rendering 60 frames while moving the view programmatically, like a flick
+    // does. Run with vsync disabled to measure more than the display refresh rate.
+    QFETCH(QString, viewName);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+    model.setSize(rows, columns);
+
+    QScopedPointer<QQuickFlickable> view(createView(viewName, true));
+    QVERIFY(view);
+
+    QSignalSpy frameSwappedSpy(&window, &QQuickWindow::frameSwapped);
+    qreal velocity = 40;
+    QBENCHMARK {
+        for (int frame = 0; frame < 60; ++frame) {
+            view->setContentY(view->contentY() + velocity);
+            QVERIFY(frameSwappedSpy.wait(1000));
+        }
+        velocity = -velocity;
+    }
+}
+
+void tst_qquicktableview::memoryPerCell_data()
+{
+    addViews();
+    QTest::newRow("tableview") << "tableview" << 100000 << 100;
+    QTest::newRow("listview") << "listview" << 100000 << 100;
+    QTest::newRow("gridview") << "gridview" << 100000 << 100;
+}
+
+void tst_qquicktableview::memoryPerCell()
+{
+    // The heap memory used by the view after loading, divided by the number
+    // of delegate items it loaded. This includes the view's own bookkeeping.
+#if defined(__GLIBC__)
+    QFETCH(QString, viewName);
+    QFETCH(int, rows);
+    QFETCH(int, columns);
+    model.setSize(rows, columns);
+
+    // Make sure the component is compiled before measuring
+    delete createView(viewName);
+    CountingItem::reset();
+
+    const int before = mallinfo().uordblks;
+    QScopedPointer<QQuickFlickable> view(createView(viewName));
+    QVERIFY(view);
+    const int after = mallinfo().uordblks;
+
+    QVERIFY(CountingItem::alive() > 0);
+    QTest::setBenchmarkResult(qreal(after - before) / CountingItem::alive(), QTest::BytesAllocated);
+#else
+    QSKIP("Measuring heap usage is only supported with glibc");
+#endif
+}
+
+void tst_qquicktableview::modelChange_data()
+{
+    QTest::addColumn<QString>("viewName");
+    QTest::addColumn<QString>("change");
+
+    const QStringList viewNames = { "tableview", "listview", "gridview" };
+    const QStringList changes = { "insertRow", "removeRow", "dataChanged" };
+    for (const QString &viewName : viewNames) {
+        for (const QString &change : changes) {
+            const QByteArray tag = viewName.toLatin1() + ' ' + change.toLatin1();
+            QTest::newRow(tag.constData()) << viewName << change;
+        }
+    }
+}
+
+void tst_qquicktableview::modelChange()
+{
+    // Changing a row inside the visible area, and laying out the view again
+    QFETCH(QString, viewName);
+    QFETCH(QString, change);
+    model.setSize(100000, 100);
+
+    QScopedPointer<QQuickFlickable> view(createView(viewName, true));
+    QVERIFY(view);
+    scrollBy(view.data(), 240);
+
+    if (change == QLatin1String("insertRow")) {
+        QBENCHMARK {
+            model.insertRows(12, 1);
+            polish();
+        }
+    } else if (change == QLatin1String("removeRow")) {
+        QBENCHMARK {
+            model.removeRows(12, 1);
+            polish();
+        }
+    } else {
+        QBENCHMARK {
+            model.changeRows(12, 1);
+            polish();
+        }
+    }
+}
+
+QTEST_MAIN(tst_qquicktableview)
+
+#include "tst_qquicktableview.moc"
@@ -61,6 +61,7 @@ Window {
             rowSpacing: 10
 
             cacheBuffer: 0
+            reuseItems: true
             model: listModel
 
             // Setting columns and rows is not really needed, since the ListModel contains the info.
@@ -43,6 +43,9 @@ const char CMD_FLUSH2[] = "f";
 const char CMD_CLEAR[] = "clear";
 const char CMD_CLEAR2[] = "c";
 
+const char CMD_SNAPSHOT[] = "snapshot";
+const char CMD_SNAPSHOT2[] = "s";
+
 const char CMD_QUIT[] ="quit";
 const char CMD_QUIT2[] = "q";
 
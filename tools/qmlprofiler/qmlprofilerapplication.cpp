@@ -48,6 +48,10 @@ static const char commandTextC[] =
         "    with --output, or standard output.\n"
         "'c', 'clear'\n"
         "    Clear profiling data recorded so far from memory.\n"
+        "'s', 'snapshot'\n"
+        "    Record the objects left on the JavaScript heap after\n"
+        "    collecting the garbage. Needs the garbagecollection\n"
+        "    feature.\n"
         "'f [file]', 'flush [file]'\n"
         "    Stop recording if it is running, then output the\n"
         "    data, and finally clear it from memory.\n"
@@ -67,7 +71,9 @@ static const char *features[] = {
     "binding",
     "handlingsignal",
     "inputevents",
-    "debugmessages"
+    "debugmessages",
+    "itemviews",
+    "garbagecollection"
 };
 
 Q_STATIC_ASSERT(sizeof(features) ==
@@ -414,6 +420,13 @@ void QmlProfilerApplication::userCommand(const QString &command)
             m_profilerData.clear();
             prompt(tr("Trace data cleared."));
         }
+    } else if (cmd == Constants::CMD_SNAPSHOT || cmd == Constants::CMD_SNAPSHOT2) {
+        if (!m_recording) {
+            prompt(tr("Heap snapshots can only be taken while recording."));
+        } else {
+            m_qmlProfilerClient.sendHeapSnapshotRequest();
+            prompt(tr("Heap snapshot requested."));
+        }
     } else if (cmd == Constants::CMD_FLUSH || cmd == Constants::CMD_FLUSH2) {
         if (!m_recording && m_profilerData.isEmpty()) {
             prompt(tr("No data was recorded so far."));
@@ -172,6 +172,26 @@ void QmlProfilerClient::sceneGraphEvent(QQmlProfilerDefinitions::SceneGraphFrame
                                      numericData4, numericData5);
 }
 
+void QmlProfilerClient::itemViewEvent(QQmlProfilerDefinitions::ItemViewFrameType type,
+                                      qint64 time, qint64 numericData1, qint64 numericData2,
+                                      qint64 numericData3, qint64 numericData4,
+                                      qint64 numericData5)
+{
+    Q_D(QmlProfilerClient);
+    d->data->addItemViewFrameEvent(type, time, numericData1, numericData2, numericData3,
+                                   numericData4, numericData5);
+}
+
+void QmlProfilerClient::garbageCollectionEvent(
+        QQmlProfilerDefinitions::GarbageCollectionType type, qint64 time,
+        const QString &objectType, qint64 numericData1, qint64 numericData2,
+        qint64 numericData3, qint64 numericData4, qint64 numericData5)
+{
+    Q_D(QmlProfilerClient);
+    d->data->addGarbageCollectionEvent(type, time, objectType, numericData1, numericData2,
+                                       numericData3, numericData4, numericData5);
+}
+
 void QmlProfilerClient::pixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type, qint64 time,
                                          const QString &url, int numericData1, int numericData2)
 {
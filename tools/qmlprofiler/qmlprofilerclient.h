@@ -63,6 +63,13 @@ private:
     void sceneGraphEvent(QQmlProfilerDefinitions::SceneGraphFrameType type, qint64 time,
                          qint64 numericData1, qint64 numericData2, qint64 numericData3,
                          qint64 numericData4, qint64 numericData5) override;
+    void itemViewEvent(QQmlProfilerDefinitions::ItemViewFrameType type, qint64 time,
+                       qint64 numericData1, qint64 numericData2, qint64 numericData3,
+                       qint64 numericData4, qint64 numericData5) override;
+    void garbageCollectionEvent(QQmlProfilerDefinitions::GarbageCollectionType type, qint64 time,
+                                const QString &objectType, qint64 numericData1,
+                                qint64 numericData2, qint64 numericData3, qint64 numericData4,
+                                qint64 numericData5) override;
     void pixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type, qint64 time,
                           const QString &url, int numericData1, int numericData2) override;
     void memoryAllocation(QQmlProfilerDefinitions::MemoryType type, qint64 time, qint64 amount) override;
@@ -60,7 +60,9 @@ static const char *MESSAGE_STRINGS[] = {
     "Complete",
     "PixmapCache",
     "SceneGraph",
-    "MemoryAllocation"
+    "MemoryAllocation",
+    "ItemView",
+    "GarbageCollection"
 };
 
 Q_STATIC_ASSERT(sizeof(MESSAGE_STRINGS) ==
@@ -80,7 +82,8 @@ struct QmlRangeEventData {
     QString details;
     QQmlProfilerDefinitions::Message message;
     QQmlProfilerDefinitions::RangeType rangeType;
-    int detailType; // can be BindingType, PixmapCacheEventType or SceneGraphFrameType
+    int detailType; // can be BindingType, PixmapCacheEventType, SceneGraphFrameType,
+                    // ItemViewFrameType or GarbageCollectionType
 };
 
 struct QmlRangeEventStartInstance {
@@ -320,6 +323,57 @@ void QmlProfilerData::addSceneGraphFrameEvent(QQmlProfilerDefinitions::SceneGrap
     d->startInstanceList.append(rangeEventStartInstance);
 }
 
+void QmlProfilerData::addItemViewFrameEvent(QQmlProfilerDefinitions::ItemViewFrameType type,
+                                            qint64 time, qint64 numericData1, qint64 numericData2,
+                                            qint64 numericData3, qint64 numericData4,
+                                            qint64 numericData5)
+{
+    setState(AcquiringData);
+
+    QString eventHashStr = QString::fromLatin1("ItemView:%1").arg(type);
+    QmlRangeEventData *newEvent;
+    if (d->eventDescriptions.contains(eventHashStr)) {
+        newEvent = d->eventDescriptions[eventHashStr];
+    } else {
+        newEvent = new QmlRangeEventData(QStringLiteral("<ItemView>"), type, eventHashStr,
+                                         QQmlEventLocation(), QString(),
+                                         QQmlProfilerDefinitions::ItemViewFrame,
+                                         QQmlProfilerDefinitions::MaximumRangeType);
+        d->eventDescriptions.insert(eventHashStr, newEvent);
+    }
+
+    QmlRangeEventStartInstance rangeEventStartInstance(time, numericData1, numericData2,
+                                                       numericData3, numericData4, numericData5,
+                                                       newEvent);
+    d->startInstanceList.append(rangeEventStartInstance);
+}
+
+void QmlProfilerData::addGarbageCollectionEvent(
+        QQmlProfilerDefinitions::GarbageCollectionType type, qint64 time,
+        const QString &objectType, qint64 numericData1, qint64 numericData2,
+        qint64 numericData3, qint64 numericData4, qint64 numericData5)
+{
+    setState(AcquiringData);
+
+    // The objects of each type get their own event, with the type as details
+    QString eventHashStr = QString::fromLatin1("GarbageCollection:%1:%2").arg(type).arg(objectType);
+    QmlRangeEventData *newEvent;
+    if (d->eventDescriptions.contains(eventHashStr)) {
+        newEvent = d->eventDescriptions[eventHashStr];
+    } else {
+        newEvent = new QmlRangeEventData(QStringLiteral("<GarbageCollection>"), type,
+                                         eventHashStr, QQmlEventLocation(), objectType,
+                                         QQmlProfilerDefinitions::GarbageCollection,
+                                         QQmlProfilerDefinitions::MaximumRangeType);
+        d->eventDescriptions.insert(eventHashStr, newEvent);
+    }
+
+    QmlRangeEventStartInstance rangeEventStartInstance(time, numericData1, numericData2,
+                                                       numericData3, numericData4, numericData5,
+                                                       newEvent);
+    d->startInstanceList.append(rangeEventStartInstance);
+}
+
 void QmlProfilerData::addPixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type,
                                           qint64 time, const QString &location,
                                           int numericData1, int numericData2)
@@ -568,6 +622,12 @@ bool QmlProfilerData::save(const QString &filename)
         else if (eventData->message == QQmlProfilerDefinitions::MemoryAllocation)
             stream.writeTextElement(QStringLiteral("memoryEventType"),
                                     QString::number((int)eventData->detailType));
+        else if (eventData->message == QQmlProfilerDefinitions::ItemViewFrame)
+            stream.writeTextElement(QStringLiteral("itemViewEventType"),
+                                    QString::number((int)eventData->detailType));
+        else if (eventData->message == QQmlProfilerDefinitions::GarbageCollection)
+            stream.writeTextElement(QStringLiteral("gcEventType"),
+                                    QString::number((int)eventData->detailType));
         stream.writeEndElement();
     }
     stream.writeEndElement(); // eventData
@@ -631,6 +691,57 @@ bool QmlProfilerData::save(const QString &filename)
                                       QString::number(event.numericData5));
         } else if (event.data->message == QQmlProfilerDefinitions::MemoryAllocation) {
             stream.writeAttribute(QStringLiteral("amount"), QString::number(event.numericData1));
+        } else if (event.data->message == QQmlProfilerDefinitions::ItemViewFrame) {
+            // special: item view delegate counters for one frame
+            if (event.data->detailType == QQmlProfilerDefinitions::ItemViewDelegateCounts) {
+                stream.writeAttribute(QStringLiteral("created"),
+                                      QString::number(event.numericData1));
+                stream.writeAttribute(QStringLiteral("incubated"),
+                                      QString::number(event.numericData2));
+                stream.writeAttribute(QStringLiteral("released"),
+                                      QString::number(event.numericData3));
+                stream.writeAttribute(QStringLiteral("destroyed"),
+                                      QString::number(event.numericData4));
+                stream.writeAttribute(QStringLiteral("reused"),
+                                      QString::number(event.numericData5));
+            } else if (event.data->detailType == QQmlProfilerDefinitions::ItemViewDelegateTimes) {
+                stream.writeAttribute(QStringLiteral("createTime"),
+                                      QString::number(event.numericData1));
+                stream.writeAttribute(QStringLiteral("releaseTime"),
+                                      QString::number(event.numericData2));
+            }
+        } else if (event.data->message == QQmlProfilerDefinitions::GarbageCollection) {
+            // special: garbage collections and the objects left on the heap
+            switch (event.data->detailType) {
+            case QV4::Profiling::GarbageCollectionTimes:
+                stream.writeAttribute(QStringLiteral("kind"),
+                                      QString::number(event.numericData1));
+                stream.writeAttribute(QStringLiteral("reason"),
+                                      QString::number(event.numericData2));
+                stream.writeAttribute(QStringLiteral("markTime"),
+                                      QString::number(event.numericData3));
+                stream.writeAttribute(QStringLiteral("sweepTime"),
+                                      QString::number(event.numericData4));
+                break;
+            case QV4::Profiling::GarbageCollectionMemory:
+                stream.writeAttribute(QStringLiteral("freedSmallItems"),
+                                      QString::number(event.numericData1));
+                stream.writeAttribute(QStringLiteral("freedLargeItems"),
+                                      QString::number(event.numericData2));
+                stream.writeAttribute(QStringLiteral("usedSmallItems"),
+                                      QString::number(event.numericData3));
+                stream.writeAttribute(QStringLiteral("usedLargeItems"),
+                                      QString::number(event.numericData4));
+                stream.writeAttribute(QStringLiteral("allocated"),
+                                      QString::number(event.numericData5));
+                break;
+            default:
+                stream.writeAttribute(QStringLiteral("count"),
+                                      QString::number(event.numericData1));
+                stream.writeAttribute(QStringLiteral("size"),
+                                      QString::number(event.numericData2));
+                break;
+            }
         }
         stream.writeEndElement();
     }
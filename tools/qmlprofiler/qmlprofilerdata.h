@@ -69,6 +69,13 @@ public:
     void addSceneGraphFrameEvent(QQmlProfilerDefinitions::SceneGraphFrameType type, qint64 time,
                                  qint64 numericData1, qint64 numericData2, qint64 numericData3,
                                  qint64 numericData4, qint64 numericData5);
+    void addItemViewFrameEvent(QQmlProfilerDefinitions::ItemViewFrameType type, qint64 time,
+                               qint64 numericData1, qint64 numericData2, qint64 numericData3,
+                               qint64 numericData4, qint64 numericData5);
+    void addGarbageCollectionEvent(QQmlProfilerDefinitions::GarbageCollectionType type,
+                                   qint64 time, const QString &objectType,
+                                   qint64 numericData1, qint64 numericData2, qint64 numericData3,
+                                   qint64 numericData4, qint64 numericData5);
     void addPixmapCacheEvent(QQmlProfilerDefinitions::PixmapEventType type, qint64 time,
                              const QString &location, int numericData1, int numericData2);
     void addMemoryEvent(QQmlProfilerDefinitions::MemoryType type, qint64 time, qint64 size);